@@ -18,7 +18,7 @@
  *  @version    1.0
  *
  *  @brief      A simple interface is provided for handling all the accesses to
- *              the arrays of classes needed in GLOVE using the map container.
+ *              the arrays of classes needed in GLOVE using a slot table.
  *
  */
 
@@ -26,6 +26,7 @@
 #define __ARRAYS_HPP__
 
 #include <stdlib.h>
+#include <vector>
 
 template <class T, uint32_t N = 1>
 class PointArray {
@@ -73,36 +74,78 @@ public:
  * @brief A templated class for handling the memory allocation, indexing and
  * searching of all the different arrays of classes.
  *
- * A separate map container is created for every class that the GLOVE supports.
- * This map is used later for the creation of the various new objects,
- * their indexing and searching. The key value of the map is used as the GL
- * handle, therefore the 0 value is not permitted. The mapped value is the
- * generated object.
+ * A separate slot table is created for every class that the GLOVE supports.
+ * The GL handle encodes the slot of the object in its low bits and the
+ * generation of the slot in its high bits, therefore the 0 value is never
+ * handed out. A handle is resolved with a single array access and a
+ * generation check, so that handles of deleted objects are rejected even
+ * after their slot has been recycled. Freed slots are kept in a FIFO free
+ * list and reused before the table grows, so that a slot goes through its
+ * generations as slowly as possible. A slot whose generation is exhausted
+ * is retired instead of wrapping around, so a handle is never handed out
+ * twice.
  */
 template <class ELEMENT>
 class ObjectArray {
 private:
-    uint32_t mCounter;                 /**< The id (key-value of the map)
-                                          reserved during the creation of a new
-                                          object. */
-    PointArray<ELEMENT> mObjects;      /**< The templated map container (one
-                                          for each different class that maps
-                                          id to a specific object). */
+    const static uint32_t SlotBits       = 20;
+    const static uint32_t SlotMask       = (1u << SlotBits) - 1;
+    const static uint32_t GenerationMask = (1u << (32 - SlotBits)) - 1;
+    const static uint32_t NoSlot         = ~0u;
+
+    struct Slot {
+        uint32_t generation;           /**< Bumped each time the slot is
+                                          freed, invalidating its handles.
+                                          The slot is retired at the last one. */
+        uint32_t nextFree;             /**< The next slot of the free list. */
+        bool     reserved;             /**< The handle of the slot has been
+                                          handed out and not deleted yet. */
+    };
+
+    std::vector<Slot> mSlots;          /**< The slot table, indexed by the
+                                          low bits of the GL handle. */
+    uint32_t mFreeHead;                /**< The oldest slot of the free list,
+                                          reused first. */
+    uint32_t mFreeTail;                /**< The most recently freed slot. */
+    PointArray<ELEMENT> mObjects;      /**< The objects, in the order of their
+                                          slots. Free slots and slots whose
+                                          object is not created yet hold a
+                                          nullptr. */
+
+    inline uint32_t Handle(uint32_t slot) const
+    {
+        return (mSlots[slot].generation << SlotBits) | (slot + 1);
+    }
+
+    /**
+     * @brief Returns the slot of a GL handle, or NoSlot in case the handle
+     * has not been handed out or has been deleted since.
+     */
+    inline uint32_t FindSlot(uint32_t index) const
+    {
+        const uint32_t slot = (index & SlotMask) - 1;
+        if ((index & SlotMask) == 0 || slot >= mSlots.size() ||
+            !mSlots[slot].reserved || mSlots[slot].generation != (index >> SlotBits)) {
+            return NoSlot;
+        }
+        return slot;
+    }
+
 public:
 
     /**
-    * @brief The constructor initializes the key value to a non-usable value in
-    * order to be assigned later to a correct one, through the allocate method.
+    * @brief The constructor initializes an empty slot table with no free
+    * slots, which grows through the allocate method.
     */
     ObjectArray() :
-    mCounter(0)
+    mFreeHead(NoSlot), mFreeTail(NoSlot)
     {
 
     }
 
     /**
-    * @brief The destructor removes all elements from the map container (which
-    * are destroyed), leaving the container with a size of 0.
+    * @brief The destructor destroys all the remaining objects, leaving the
+    * container with a size of 0.
     */
     ~ObjectArray()
     {
@@ -113,61 +156,98 @@ public:
     }
 
     /**
-    * @brief Returns the GL handle and reserves this as the new key value.
-    * @return The GL handle.
+    * @brief Reserves a GL handle, recycling the least recently freed slot if
+    * any. The object itself is created on its first access.
+    * @return The GL handle, or 0 when the slot table is full.
     */
     inline uint32_t Allocate()
     {
-        ELEMENT *element = new ELEMENT();
-        mObjects.PushBack(element);
-        return ++mCounter;
+        uint32_t slot = mFreeHead;
+        if (slot != NoSlot) {
+            mFreeHead = mSlots[slot].nextFree;
+            if (mFreeHead == NoSlot) {
+                mFreeTail = NoSlot;
+            }
+        } else {
+            slot = static_cast<uint32_t>(mSlots.size());
+            if (slot >= SlotMask) {
+                return 0;
+            }
+            Slot newSlot = { 0, NoSlot, false };
+            mSlots.push_back(newSlot);
+            mObjects.PushBack(nullptr);
+        }
+
+        mSlots[slot].reserved = true;
+        mSlots[slot].nextFree = NoSlot;
+
+        return Handle(slot);
     }
 
     /**
-    * @brief Removes from the map container a single element with the given
-    * key value (element is  destroyed).
+    * @brief Destroys the element with the given GL handle, if created, and
+    * returns its slot to the free list, unless the slot is retired.
     * @param index: The GL handle of the element to be destroyed.
+    * @return The decision whether the handle was valid or not.
     */
     inline bool Deallocate(uint32_t index)
     {
-        if (index <= mObjects.Size()) {
-            delete mObjects[index-1];
-            mObjects[index-1] = nullptr;
+        const uint32_t slot = FindSlot(index);
+        if (slot == NoSlot) {
+            return false;
+        }
+
+        delete mObjects[slot];
+        mObjects[slot] = nullptr;
+
+        mSlots[slot].reserved = false;
+        if (mSlots[slot].generation == GenerationMask) {
             return true;
         }
-        return false;
+
+        ++mSlots[slot].generation;
+        mSlots[slot].nextFree = NoSlot;
+        if (mFreeTail != NoSlot) {
+            mSlots[mFreeTail].nextFree = slot;
+        } else {
+            mFreeHead = slot;
+        }
+        mFreeTail = slot;
+
+        return true;
     }
 
     /**
-     * @brief Searches the container for an element with a key equivalent to
-     * index and returns it.
+     * @brief Returns the element with the given GL handle.
      * @param index: The GL handle of the element to be found or to be created.
-     * @return A pointer to the element in the map.
+     * @return A pointer to the element, or nullptr for an invalid handle.
      *
-     * In case the key value is not found (thus, the element does not exist)
-     * a new object is created. Consequently this method is the only way to
-     * insert a new element in the map.
+     * In case the element of a valid handle does not exist yet, a new object
+     * is created. Consequently this method is the only way to insert a new
+     * element in the container.
      */
     inline ELEMENT *Object(uint32_t index)
     {
-        if (index <= mObjects.Size()) {
-            return mObjects[index-1];
+        const uint32_t slot = FindSlot(index);
+        if (slot == NoSlot) {
+            return nullptr;
+        }
+
+        if (mObjects[slot] == nullptr) {
+            mObjects[slot] = new ELEMENT();
         }
-        return nullptr;
+        return mObjects[slot];
     }
 
     /**
-     * @brief Searches the container for an element with a key equivalent to
-     * index.
+     * @brief Checks whether an element with the given GL handle exists.
      * @param index: The GL handle of the element to be found.
      * @return The decision whether the element exists or not.
      */
     inline bool ObjectExists(uint32_t index) const
     {
-        if (index <= mObjects.Size()) {
-            return (mObjects[index-1] != nullptr);
-        }
-        return false;
+        const uint32_t slot = FindSlot(index);
+        return slot != NoSlot && mObjects[slot] != nullptr;
     }
 
     /**
@@ -175,15 +255,19 @@ public:
      * @param *element: The element to be searched in the container.
      * @return The GL handle of the element.
      *
-     * The container is traversed using the mapped value as the search value.
+     * The container is traversed using the element as the search value.
      * The GL handle is returned in case the wanted element exists, else the
-     * returned value is 0.
+     * returned value is ~0.
      */
     inline uint32_t GetObjectId(const ELEMENT * element) const
     {
+        if (element == nullptr) {
+            return ~0;
+        }
+
         for (uint32_t i = 0; i < mObjects.Size(); ++i) {
             if (mObjects[i] == element) {
-                return i+1;
+                return Handle(i);
             }
         }
 
@@ -191,8 +275,8 @@ public:
     }
 
     /**
-     * @brief Returns the map container for a specific class.
-     * @return The map container.
+     * @brief Returns the objects of the container, indexed by slot.
+     * @return The objects, where nullptr marks a free or not yet created one.
      */
     inline PointArray<ELEMENT>& GetObjects(void)
     {
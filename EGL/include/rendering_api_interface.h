@@ -57,6 +57,8 @@ typedef GLPROC (*get_proc_addr_cb_t)(const char* procname);
 typedef void (*flush_cb_t)(api_context_t api_context);
 typedef void (*finish_cb_t)(api_context_t api_context);
 typedef void (*bind_to_texture_cb_t)(api_context_t api_context, uint32_t bind);
+typedef uint64_t (*insert_fence_cb_t)(api_context_t api_context);
+typedef bool (*wait_fence_cb_t)(api_context_t api_context, uint64_t fence, uint64_t timeout);
 
 typedef struct rendering_api_interface {
     api_state_t state;
@@ -71,6 +73,8 @@ typedef struct rendering_api_interface {
     flush_cb_t flush_cb;
     finish_cb_t finish_cb;
     bind_to_texture_cb_t bind_to_texture_cb;
+    insert_fence_cb_t insert_fence_cb;
+    wait_fence_cb_t wait_fence_cb;
 } rendering_api_interface_t;
 
 extern rendering_api_interface_t GLES2Interface;
@@ -21,6 +21,8 @@
  *
  */
 
+#define EGL_EGLEXT_PROTOTYPES
+
 #include "display/displayDriversContainer.h"
 #include "api/eglDisplay.h"
 #include "display/displayDriver.h"
@@ -466,7 +468,6 @@ eglDestroyImageKHR(EGLDisplay dpy, EGLImageKHR image)
     return eglDriver->DestroyImageKHR(eglDisplay, image);
 }
 
-//TODO: Implement the KHR_fence_sync extension
 EGLAPI EGLSyncKHR EGLAPIENTRY
 eglCreateSyncKHR(EGLDisplay dpy, EGLenum type, const EGLint *attrib_list)
 {
@@ -496,3 +497,13 @@ eglClientWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR t
     CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_FALSE)
     return eglDriver->ClientWaitSyncKHR(eglDisplay, sync, flags, timeout);
 }
+
+EGLAPI EGLBoolean EGLAPIENTRY
+eglGetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, EGLint *value)
+{
+    FUN_ENTRY(DEBUG_DEPTH);
+
+    CHECK_BAD_DISPLAY(eglDisplay, dpy, EGL_FALSE)
+    CHECK_UNINITIALIZED_DISPLAY(eglDriver, eglDisplay, EGL_FALSE)
+    return eglDriver->GetSyncAttribKHR(eglDisplay, sync, attribute, value);
+}
@@ -25,6 +25,7 @@
 #include "eglContext.h"
 #include "api/eglDisplay.h"
 #include "eglSurface.h"
+#include "eglSync.h"
 #include "thread/renderingThread.h"
 #include <algorithm>
 
@@ -185,6 +186,12 @@ EGLContext_t::Destroy()
     //TODO: Include Error Handling in Final implementation
     mAPIInterface->delete_context_cb(mAPIContext);
 
+    // the context has completed all of its commands, so are its fences
+    for(auto sync : mSyncList) {
+        sync->Signal();
+    }
+    mSyncList.clear();
+
     return EGL_TRUE;
 }
 
@@ -252,6 +259,41 @@ EGLContext_t::BindToTexture(EGLint bind)
     mAPIInterface->bind_to_texture_cb(mAPIContext, bind);
 }
 
+uint64_t
+EGLContext_t::InsertFence()
+{
+    FUN_ENTRY(EGL_LOG_DEBUG);
+
+    return mAPIInterface->insert_fence_cb(mAPIContext);
+}
+
+EGLBoolean
+EGLContext_t::WaitFence(uint64_t fence, EGLTimeKHR timeout)
+{
+    FUN_ENTRY(EGL_LOG_DEBUG);
+
+    return mAPIInterface->wait_fence_cb(mAPIContext, fence, timeout) ? EGL_TRUE : EGL_FALSE;
+}
+
+void
+EGLContext_t::AttachSync(EGLSync_t *sync)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    mSyncList.push_back(sync);
+}
+
+void
+EGLContext_t::DetachSync(EGLSync_t *sync)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    auto iter = std::find(mSyncList.begin(), mSyncList.end(), sync);
+    if(iter != mSyncList.end()) {
+        mSyncList.erase(iter);
+    }
+}
+
 EGLBoolean
 EGLContext_t::ParseAttributeList(const EGLint* attrib_list)
 {
@@ -25,6 +25,7 @@
 #define __EGL_CONTEXT_H__
 
 #include "EGL/egl.h"
+#include "EGL/eglext.h"
 #include "rendering_api/rendering_api.h"
 #include "utils/eglLogger.h"
 #include "eglConfig.h"
@@ -42,6 +43,7 @@ private:
     struct EGLConfig_t          *mConfig;
     const EGLint                *mAttribList;
     EGLenum                      mClientVersion;
+    std::vector<class EGLSync_t*> mSyncList;
 
     static std::vector<class EGLContext_t*> globalEGLContextList;
 
@@ -65,6 +67,10 @@ public:
     void                         Flush();
     void                         Finish();
     void                         BindToTexture(EGLint bind);
+    uint64_t                     InsertFence();
+    EGLBoolean                   WaitFence(uint64_t fence, EGLTimeKHR timeout);
+    void                         AttachSync(class EGLSync_t *sync);
+    void                         DetachSync(class EGLSync_t *sync);
     void                         Release();
 
     inline EGLenum               GetRenderingAPI()                        const { FUN_ENTRY(EGL_LOG_TRACE); return mRenderingAPI; }
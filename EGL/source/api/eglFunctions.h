@@ -71,8 +71,14 @@ EGL_FUNC_PTR(eglWaitClient),
 #ifdef EGL_VERSION_1_3
 #endif /* EGL_VERSION_1_3 */
 #ifdef EGL_VERSION_1_4
-EGL_FUNC_PTR(eglGetCurrentContext)
+EGL_FUNC_PTR(eglGetCurrentContext),
 #endif /* EGL_VERSION_1_4 */
+#ifdef EGL_KHR_fence_sync
+EGL_FUNC_PTR(eglCreateSyncKHR),
+EGL_FUNC_PTR(eglDestroySyncKHR),
+EGL_FUNC_PTR(eglClientWaitSyncKHR),
+EGL_FUNC_PTR(eglGetSyncAttribKHR)
+#endif /* EGL_KHR_fence_sync */
 };
 #undef EGL_FUNC_PTR
 
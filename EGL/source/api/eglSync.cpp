@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       eglSync.cpp
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      EGL Fence Sync object (EGL_KHR_fence_sync). It tracks the client API commands issued before its creation
+ *
+ *  @section
+ *
+ *  A fence sync is tied to the submission of the client API context that
+ *  will carry the commands issued before the sync was created. Waiting on it
+ *  waits for that submission only, so that the client does not have to stall
+ *  for all the work of the GPU with a glFinish().
+ *
+ */
+
+#include "eglSync.h"
+#include "thread/renderingThread.h"
+
+EGLSync_t::EGLSync_t(EGLContext_t *context, EGLenum type)
+: mContext(context), mType(type), mStatus(EGL_UNSIGNALED_KHR), mFence(0)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    mFence = mContext->InsertFence();
+    mContext->AttachSync(this);
+}
+
+EGLSync_t::~EGLSync_t()
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    if(mContext != nullptr) {
+        mContext->DetachSync(this);
+    }
+}
+
+void
+EGLSync_t::Signal()
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    // called by the context of the fence when it is destroyed
+    mStatus  = EGL_SIGNALED_KHR;
+    mContext = nullptr;
+}
+
+EGLint
+EGLSync_t::ClientWait(EGLint flags, EGLTimeKHR timeout)
+{
+    FUN_ENTRY(EGL_LOG_DEBUG);
+
+    if(mStatus == EGL_SIGNALED_KHR) {
+        return EGL_CONDITION_SATISFIED_KHR;
+    }
+
+    // the flush applies to the current context, as the fence may belong to another one.
+    // Waiting forever on commands that are not submitted yet would never return, so
+    // the context of the fence is also flushed for such a wait when current here
+    EGLContext_t *currentContext = static_cast<EGLContext_t *>(currentThread.GetCurrentContext());
+    if(currentContext != nullptr &&
+       ((flags & EGL_SYNC_FLUSH_COMMANDS_BIT_KHR) || (timeout == EGL_FOREVER_KHR && currentContext == mContext))) {
+        currentContext->Flush();
+    }
+
+    if(mContext->WaitFence(mFence, timeout) == EGL_FALSE) {
+        // only a fence that was never submitted fails to complete in a wait
+        // forever. Its context is current to another thread, which must flush
+        // it first. This is reported with the only error the extension defines
+        if(timeout == EGL_FOREVER_KHR) {
+            currentThread.RecordError(EGL_BAD_PARAMETER);
+            return EGL_FALSE;
+        }
+        return EGL_TIMEOUT_EXPIRED_KHR;
+    }
+
+    mStatus = EGL_SIGNALED_KHR;
+
+    return EGL_CONDITION_SATISFIED_KHR;
+}
+
+EGLBoolean
+EGLSync_t::GetAttrib(EGLint attribute, EGLint *value)
+{
+    FUN_ENTRY(EGL_LOG_DEBUG);
+
+    switch(attribute) {
+    case EGL_SYNC_TYPE_KHR:
+        *value = mType;
+        break;
+    case EGL_SYNC_STATUS_KHR:
+        ClientWait(0, 0);
+        *value = mStatus;
+        break;
+    case EGL_SYNC_CONDITION_KHR:
+        *value = EGL_SYNC_PRIOR_COMMANDS_COMPLETE_KHR;
+        break;
+    default:
+        return EGL_FALSE;
+    }
+
+    return EGL_TRUE;
+}
@@ -0,0 +1,48 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       eglSync.h
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      EGL Fence Sync object (EGL_KHR_fence_sync). It tracks the client API commands issued before its creation
+ *
+ */
+
+#ifndef __EGL_SYNC_H__
+#define __EGL_SYNC_H__
+
+#include "EGL/egl.h"
+#include "EGL/eglext.h"
+#include "eglContext.h"
+#include "utils/eglLogger.h"
+
+class EGLSync_t {
+private:
+    EGLContext_t                *mContext;
+    EGLenum                      mType;
+    EGLint                       mStatus;
+    uint64_t                     mFence;
+
+public:
+    EGLSync_t(EGLContext_t *context, EGLenum type);
+    ~EGLSync_t();
+
+    EGLint                       ClientWait(EGLint flags, EGLTimeKHR timeout);
+    EGLBoolean                   GetAttrib(EGLint attribute, EGLint *value);
+    void                         Signal();
+};
+
+#endif // __EGL_SYNC_H__
@@ -76,6 +76,21 @@ EGLBoolean DisplayDriver::CheckBadSurface(const EGLSurface_t *surface) const
     return EGL_TRUE;
 }
 
+EGLBoolean DisplayDriver::CheckBadSync(const EGLSync_t *sync) const
+{
+    if(sync == nullptr) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+
+    auto iter = std::find(mSyncList.begin(), mSyncList.end(), sync);
+    if(iter == mSyncList.end()) {
+        currentThread.RecordError(EGL_BAD_PARAMETER);
+        return EGL_FALSE;
+    }
+    return EGL_TRUE;
+}
+
 EGLBoolean
 DisplayDriver::Initialize(EGLDisplay_t* dpy, EGLint *major, EGLint *minor)
 {
@@ -113,6 +128,11 @@ DisplayDriver::Terminate(EGLDisplay_t* dpy)
 
     PlatformFactory::DestroyInstance();
 
+    for(auto sync : mSyncList) {
+        delete sync;
+    }
+    mSyncList.clear();
+
     mInitialized = false;
 
     return EGL_TRUE;
@@ -621,7 +641,22 @@ DisplayDriver::CreateSyncKHR(EGLDisplay_t* dpy, EGLenum type, const EGLint *attr
 {
     FUN_ENTRY(EGL_LOG_TRACE);
 
-    return ((EGLSyncKHR)0xFE4CE000);
+    if(type != EGL_SYNC_FENCE_KHR || (attrib_list != nullptr && attrib_list[0] != EGL_NONE)) {
+        currentThread.RecordError(EGL_BAD_ATTRIBUTE);
+        return EGL_NO_SYNC_KHR;
+    }
+
+    // the fence is inserted into the command stream of the current context
+    EGLContext_t *currentContext = static_cast<EGLContext_t *>(currentThread.GetCurrentContext());
+    if(currentContext == nullptr || currentContext->GetDisplay() != dpy) {
+        currentThread.RecordError(EGL_BAD_MATCH);
+        return EGL_NO_SYNC_KHR;
+    }
+
+    EGLSync_t *eglSync = new EGLSync_t(currentContext, type);
+    mSyncList.push_back(eglSync);
+
+    return static_cast<EGLSyncKHR>(eglSync);
 }
 
 EGLBoolean
@@ -629,6 +664,14 @@ DisplayDriver::DestroySyncKHR(EGLDisplay_t* dpy, EGLSyncKHR sync)
 {
     FUN_ENTRY(EGL_LOG_TRACE);
 
+    EGLSync_t *eglSync = static_cast<EGLSync_t *>(sync);
+    if(CheckBadSync(eglSync) == EGL_FALSE) {
+        return EGL_FALSE;
+    }
+
+    mSyncList.erase(std::find(mSyncList.begin(), mSyncList.end(), eglSync));
+    delete eglSync;
+
     return EGL_TRUE;
 }
 
@@ -637,12 +680,35 @@ DisplayDriver::ClientWaitSyncKHR(EGLDisplay_t* dpy, EGLSyncKHR sync, EGLint flag
 {
     FUN_ENTRY(EGL_LOG_TRACE);
 
-    return EGL_CONDITION_SATISFIED_KHR;
+    EGLSync_t *eglSync = static_cast<EGLSync_t *>(sync);
+    if(CheckBadSync(eglSync) == EGL_FALSE) {
+        return EGL_FALSE;
+    }
+
+    return eglSync->ClientWait(flags, timeout);
+}
+
+EGLBoolean
+DisplayDriver::GetSyncAttribKHR(EGLDisplay_t* dpy, EGLSyncKHR sync, EGLint attribute, EGLint *value)
+{
+    FUN_ENTRY(EGL_LOG_TRACE);
+
+    EGLSync_t *eglSync = static_cast<EGLSync_t *>(sync);
+    if(CheckBadSync(eglSync) == EGL_FALSE) {
+        return EGL_FALSE;
+    }
+
+    if(eglSync->GetAttrib(attribute, value) == EGL_FALSE) {
+        currentThread.RecordError(EGL_BAD_ATTRIBUTE);
+        return EGL_FALSE;
+    }
+
+    return EGL_TRUE;
 }
 
 const char *DisplayDriver::GetExtensions()
 {
-    return "";
+    return "EGL_KHR_fence_sync";
 }
 
 EGLBoolean
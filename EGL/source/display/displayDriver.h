@@ -33,6 +33,7 @@
 #include "EGL/eglext.h"
 #include "platform/platformWindowInterface.h"
 #include "api/eglDisplay.h"
+#include "api/eglSync.h"
 #include <vector>
 
 #ifdef DEBUG_DEPTH
@@ -48,6 +49,7 @@ private:
     PlatformWindowInterface     *mWindowInterface;
     std::vector<EGLSurface_t*>   mSurfaceList;
     std::vector<EGLConfig_t*>    mConfigList;
+    std::vector<EGLSync_t*>      mSyncList;
     bool                         mInitialized;
 
     void                         UpdateConfigMap(EGLConfig_t* config);
@@ -66,6 +68,7 @@ public:
     // Error functions
     EGLBoolean                   CheckBadConfig(const EGLConfig_t *eglConfig) const;
     EGLBoolean                   CheckBadSurface(const EGLSurface_t *eglSurface) const;
+    EGLBoolean                   CheckBadSync(const EGLSync_t *eglSync) const;
     static EGLBoolean            CheckNonInitializedDisplay(const DisplayDriver* displayDriver);
 
     /// EGL API core functions
@@ -94,6 +97,7 @@ public:
     EGLSyncKHR                   CreateSyncKHR(EGLDisplay_t* dpy, EGLenum type, const EGLint *attrib_list);
     EGLBoolean                   DestroySyncKHR(EGLDisplay_t* dpy, EGLSyncKHR sync);
     EGLint                       ClientWaitSyncKHR(EGLDisplay_t* dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout);
+    EGLBoolean                   GetSyncAttribKHR(EGLDisplay_t* dpy, EGLSyncKHR sync, EGLint attribute, EGLint *value);
 };
 
 #endif // __DISPLAY_DRIVER_H__
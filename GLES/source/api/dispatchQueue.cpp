@@ -0,0 +1,227 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       dispatchQueue.cpp
+ *  @author     Think Silicon
+ *  @date       26/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Threaded dispatch of OpenGL ES API calls
+ *
+ *  @section
+ *
+ *  When threaded dispatch is enabled, the API calls that do not return any
+ *  data are encoded into a single-producer/single-consumer ring buffer and a
+ *  worker thread replays them into the Context, off the application thread.
+ *  Every other call first waits for the worker to drain the ring and then
+ *  runs on the application thread, as in the synchronous mode. Commands are
+ *  closures placed in the ring, so the producer and the consumer only share
+ *  the head and tail positions of the ring.
+ *
+ */
+
+#include "dispatchQueue.h"
+#include "context/context.h"
+
+DispatchQueue *GetCurrentDispatchQueue()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the queue belongs to the context, so it always follows the current context
+    Context *context = GetCurrentContext();
+    return context ? context->GetDispatchQueue() : nullptr;
+}
+
+DispatchQueue::DispatchQueue(Context *context)
+: mContext(context), mHead(0), mTail(0), mWorkerSleeping(false), mWaitingThreads(0), mExit(false)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mRing = new uint8_t[RING_SIZE];
+
+    memset(static_cast<void *>(&mClientArrayState), 0, sizeof(mClientArrayState));
+
+    mWorker = std::thread(&DispatchQueue::Run, this);
+}
+
+DispatchQueue::~DispatchQueue()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Synchronize();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mExit = true;
+    }
+    mWorkCondition.notify_one();
+    mWorker.join();
+
+    delete[] mRing;
+}
+
+uint8_t *
+DispatchQueue::Reserve(size_t size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(size <= RING_SIZE / 4);
+
+    const size_t head  = mHead.load(std::memory_order_relaxed);
+    const size_t index = head % RING_SIZE;
+
+    // a command never wraps around the end of the ring. The remainder is
+    // filled with an empty command that the worker simply skips
+    const size_t padding = (RING_SIZE - index < size) ? RING_SIZE - index : 0;
+
+    while(RING_SIZE - (head - mTail.load(std::memory_order_acquire)) < padding + size) {
+        std::this_thread::yield();
+    }
+
+    if(padding) {
+        new (mRing + index) Command(padding);
+        Publish(padding);
+        return mRing;
+    }
+
+    return mRing + index;
+}
+
+void
+DispatchQueue::Publish(size_t size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mHead.store(mHead.load(std::memory_order_relaxed) + size);
+
+    if(mWorkerSleeping.load()) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWorkCondition.notify_one();
+    }
+}
+
+void
+DispatchQueue::Synchronize(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // only the commands published so far are waited for, as the producer
+    // may keep enqueueing while another thread synchronizes
+    const size_t head = mHead.load();
+    if(mTail.load() >= head) {
+        return;
+    }
+
+    mWaitingThreads.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdleCondition.wait(lock, [this, head] { return mTail.load() >= head; });
+    }
+    mWaitingThreads.fetch_sub(1);
+}
+
+void
+DispatchQueue::Run(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    size_t tail = mTail.load(std::memory_order_relaxed);
+
+    while(true) {
+        if(mHead.load(std::memory_order_acquire) == tail) {
+            mWorkerSleeping.store(true);
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkCondition.wait(lock, [this, tail] { return mHead.load() != tail || mExit; });
+            mWorkerSleeping.store(false);
+
+            if(mHead.load() == tail && mExit) {
+                break;
+            }
+            continue;
+        }
+
+        Command *command = reinterpret_cast<Command *>(mRing + tail % RING_SIZE);
+        const size_t size = command->mSize;
+        command->Execute(mContext);
+        command->~Command();
+
+        tail += size;
+        mTail.store(tail);
+
+        if(mWaitingThreads.load()) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIdleCondition.notify_all();
+        }
+    }
+}
+
+void
+DispatchQueue::BindBuffer(GLenum target, GLuint buffer)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(target == GL_ARRAY_BUFFER) {
+        mClientArrayState.arrayBuffer = buffer;
+    } else if(target == GL_ELEMENT_ARRAY_BUFFER) {
+        mClientArrayState.elementArrayBuffer = buffer;
+    }
+}
+
+void
+DispatchQueue::DeleteBuffers(GLsizei n, const GLuint *buffers)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(GLsizei i = 0; buffers && i < n; ++i) {
+        if(buffers[i] && buffers[i] == mClientArrayState.arrayBuffer) {
+            mClientArrayState.arrayBuffer = 0;
+        }
+        if(buffers[i] && buffers[i] == mClientArrayState.elementArrayBuffer) {
+            mClientArrayState.elementArrayBuffer = 0;
+        }
+    }
+}
+
+void
+DispatchQueue::VertexAttribPointer(GLuint index)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index >= GLOVE_MAX_VERTEX_ATTRIBS) {
+        return;
+    }
+
+    if(mClientArrayState.arrayBuffer) {
+        mClientArrayState.clientArrays &= ~(1u << index);
+    } else {
+        mClientArrayState.clientArrays |=  (1u << index);
+    }
+}
+
+void
+DispatchQueue::EnableVertexAttribArray(GLuint index, bool enable)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(index >= GLOVE_MAX_VERTEX_ATTRIBS) {
+        return;
+    }
+
+    if(enable) {
+        mClientArrayState.enabledArrays |=  (1u << index);
+    } else {
+        mClientArrayState.enabledArrays &= ~(1u << index);
+    }
+}
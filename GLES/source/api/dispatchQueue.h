@@ -0,0 +1,126 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       dispatchQueue.h
+ *  @author     Think Silicon
+ *  @date       26/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Threaded dispatch of OpenGL ES API calls
+ *
+ */
+
+#ifndef __DISPATCHQUEUE_H__
+#define __DISPATCHQUEUE_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include "utils/glUtils.h"
+#include "utils/glLogger.h"
+
+class Context;
+
+class DispatchQueue {
+private:
+    const static size_t     RING_SIZE         = 1024 * 1024;
+    const static size_t     COMMAND_ALIGNMENT = 16;
+
+    class Command {
+    public:
+        size_t              mSize;
+
+        Command(size_t size) : mSize(size)                                      { FUN_ENTRY(GL_LOG_TRACE); }
+        virtual ~Command()                                                      { FUN_ENTRY(GL_LOG_TRACE); }
+        virtual void Execute(Context *context)                                  { FUN_ENTRY(GL_LOG_TRACE); }
+    };
+
+    template<typename F>
+    class CallCommand : public Command {
+    public:
+        F                   mCall;
+
+        CallCommand(size_t size, F &&call) : Command(size), mCall(std::move(call)) { FUN_ENTRY(GL_LOG_TRACE); }
+        void Execute(Context *context) override                                 { FUN_ENTRY(GL_LOG_TRACE); mCall(context); }
+    };
+
+    /// Client vertex array state shadowed on the application thread, so that
+    /// it can tell which draws read client memory without asking the worker
+    typedef struct ClientArrayState {
+        GLuint              arrayBuffer;
+        GLuint              elementArrayBuffer;
+        uint32_t            clientArrays;
+        uint32_t            enabledArrays;
+    } ClientArrayState;
+
+    Context                *mContext;
+    uint8_t                *mRing;
+    std::atomic<size_t>     mHead;
+    std::atomic<size_t>     mTail;
+
+    std::thread             mWorker;
+    std::mutex              mMutex;
+    std::condition_variable mWorkCondition;
+    std::condition_variable mIdleCondition;
+    std::atomic<bool>       mWorkerSleeping;
+    std::atomic<uint32_t>   mWaitingThreads;
+    bool                    mExit;
+
+    ClientArrayState        mClientArrayState;
+
+    void                    Run(void);
+    uint8_t                *Reserve(size_t size);
+    void                    Publish(size_t size);
+
+public:
+// Constructor
+    DispatchQueue(Context *context);
+
+// Destructor
+    ~DispatchQueue();
+
+// Enqueue Functions
+    template<typename F>
+    void Enqueue(F call)
+    {
+        FUN_ENTRY(GL_LOG_TRACE);
+
+        const size_t size = (sizeof(CallCommand<F>) + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
+        new (Reserve(size)) CallCommand<F>(size, std::move(call));
+        Publish(size);
+    }
+
+// Synchronize Functions
+    void                    Synchronize(void);
+
+// Client Array Functions
+    void                    BindBuffer(GLenum target, GLuint buffer);
+    void                    DeleteBuffers(GLsizei n, const GLuint *buffers);
+    void                    VertexAttribPointer(GLuint index);
+    void                    EnableVertexAttribArray(GLuint index, bool enable);
+
+// Has Functions
+    inline bool             HasClientArrays(void)               const { FUN_ENTRY(GL_LOG_TRACE); return (mClientArrayState.clientArrays & mClientArrayState.enabledArrays) != 0; }
+    inline bool             HasElementArrayBuffer(void)         const { FUN_ENTRY(GL_LOG_TRACE); return mClientArrayState.elementArrayBuffer != 0; }
+
+// Get Functions
+    inline Context         *GetContext(void)                    const { FUN_ENTRY(GL_LOG_TRACE); return mContext; }
+};
+
+DispatchQueue *GetCurrentDispatchQueue(void);
+
+#endif // __DISPATCHQUEUE_H__
@@ -24,6 +24,7 @@
 #include "rendering_api_interface.h"
 #include "context/context.h"
 #include "glFunctions.h"
+#include "dispatchQueue.h"
 
 static vkInterface_t  vkInterface;
 api_state_t           gles2_state = nullptr;
@@ -39,8 +40,11 @@ GLPROC                get_proc_addr(const char* procname);
 void                  flush(api_context_t api_context);
 void                  finish(api_context_t api_context);
 void                  bind_to_texture(api_context_t api_context, uint32_t bind);
+uint64_t              insert_fence(api_context_t api_context);
+bool                  wait_fence(api_context_t api_context, uint64_t fence, uint64_t timeout);
 
 static void           FillInVkInterface(vulkanAPI::vkContext_t* vkContext);
+static void           SynchronizeContext(Context *ctx);
 
 rendering_api_interface_t GLES2Interface = {
     gles2_state,
@@ -54,7 +58,9 @@ rendering_api_interface_t GLES2Interface = {
     get_proc_addr,
     flush,
     finish,
-    bind_to_texture
+    bind_to_texture,
+    insert_fence,
+    wait_fence
 };
 
 #if defined(VK_USE_PLATFORM_WIN32_KHR) || defined(VK_USE_PLATFORM_IOS_MVK)
@@ -68,6 +74,17 @@ EGLAPI rendering_api_interface_t * EGLAPIENTRY GetGLES2Interface(void)
 }
 #endif
 
+static void SynchronizeContext(Context *ctx)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // EGL accesses the context directly, so its queued calls must be completed first
+    DispatchQueue *queue = ctx->GetDispatchQueue();
+    if(queue) {
+        queue->Synchronize();
+    }
+}
+
 static void FillInVkInterface(vulkanAPI::vkContext_t* vkContext)
 {
     vkInterface.vkInstance = vkContext->vkInstance;
@@ -103,6 +120,11 @@ api_context_t create_context()
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = new Context();
+
+#ifdef GLOVE_THREADED_DISPATCH
+    ctx->SetDispatchQueue(new DispatchQueue(ctx));
+#endif
+
     return ctx;
 }
 
@@ -111,6 +133,13 @@ void set_read_write_surface(api_context_t api_context, EGLSurfaceInterface *eglR
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+
+    // the previous context may still be recording on its worker thread
+    if(GetCurrentContext() && GetCurrentContext() != ctx) {
+        SynchronizeContext(GetCurrentContext());
+    }
+    SynchronizeContext(ctx);
+
     ctx->SetReadWriteSurfaces(eglReadSurfaceInterface, eglWriteSurfaceInterface);
 
     SetCurrentContext(ctx);
@@ -121,6 +150,11 @@ void delete_context(api_context_t api_context)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+
+    // the worker replays the queued calls into the context, so it stops first
+    delete ctx->GetDispatchQueue();
+    ctx->SetDispatchQueue(nullptr);
+
     delete ctx;
 }
 
@@ -129,6 +163,7 @@ void release_system_fbo(api_context_t api_context)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    SynchronizeContext(ctx);
     ctx->ReleaseSystemFBO();
 }
 
@@ -137,6 +172,7 @@ void set_next_image_index(api_context_t api_context, uint32_t index)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    SynchronizeContext(ctx);
     ctx->SetNextImageIndex(index);
 }
 
@@ -152,6 +188,7 @@ void flush(api_context_t api_context)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    SynchronizeContext(ctx);
     ctx->Flush();
 }
 
@@ -160,6 +197,7 @@ void finish(api_context_t api_context)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    SynchronizeContext(ctx);
     ctx->Finish();
 }
 
@@ -168,5 +206,34 @@ void bind_to_texture(api_context_t api_context, uint32_t bind)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     Context *ctx = reinterpret_cast<Context *>(api_context);
+    SynchronizeContext(ctx);
     ctx->BindToTexture(bind);
 }
+
+uint64_t insert_fence(api_context_t api_context)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Context *ctx = reinterpret_cast<Context *>(api_context);
+    DispatchQueue *queue = ctx->GetDispatchQueue();
+    if(!queue) {
+        return ctx->InsertFence();
+    }
+
+    // the worker inserts the fence after the calls queued before it
+    uint64_t fence = 0;
+    queue->Enqueue([&fence](Context *context) { fence = context->InsertFence(); });
+    queue->Synchronize();
+
+    return fence;
+}
+
+bool wait_fence(api_context_t api_context, uint64_t fence, uint64_t timeout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // The wait may come from any thread. The command buffer manager guards
+    // its fences itself, so it does not have to go through the queue
+    Context *ctx = reinterpret_cast<Context *>(api_context);
+    return ctx->WaitFence(fence, timeout);
+}
@@ -22,27 +22,90 @@
  */
 
 #include "context/context.h"
+#include "api/dispatchQueue.h"
 
-#define CONTEXT_EXEC(func)          FUN_ENTRY(GL_LOG_INFO);                      \
-                                    Context * context = GetCurrentContext();     \
-                                    if (context) {                               \
-                                        context->func;                           \
+// Largest client array that is copied for a call to be queued. Calls with
+// bigger arrays wait for the dispatch queue and run synchronously instead
+#define GLOVE_DISPATCH_MAX_COPY_SIZE                    (64 * 1024)
+
+#define CONTEXT_SYNC()              DispatchQueue * queue = GetCurrentDispatchQueue();                  \
+                                    if (queue) {                                                        \
+                                        queue->Synchronize();                                           \
+                                    }
+
+#define CONTEXT_EXEC(func)          FUN_ENTRY(GL_LOG_INFO);                                             \
+                                    Context * context = GetCurrentContext();                            \
+                                    if (context) {                                                      \
+                                        CONTEXT_SYNC();                                                 \
+                                        context->func;                                                  \
                                     }
 
-#define CONTEXT_EXEC_RETURN(func)   FUN_ENTRY(GL_LOG_INFO);                      \
-                                    Context * context = GetCurrentContext();     \
+#define CONTEXT_EXEC_RETURN(func)   FUN_ENTRY(GL_LOG_INFO);                                             \
+                                    Context * context = GetCurrentContext();                            \
+                                    CONTEXT_SYNC();                                                     \
                                     return context ? context->func : 0;
 
+// Calls that only take values are queued as they are
+#define CONTEXT_EXEC_ASYNC(func)    FUN_ENTRY(GL_LOG_INFO);                                             \
+                                    Context * context = GetCurrentContext();                            \
+                                    DispatchQueue * queue = GetCurrentDispatchQueue();                  \
+                                    if (queue) {                                                        \
+                                        queue->Enqueue([=](Context *ctx) { ctx->func; });               \
+                                    } else if (context) {                                               \
+                                        context->func;                                                  \
+                                    }
+
+// Calls that are queued only when cond holds, as they may read client memory
+#define CONTEXT_EXEC_ASYNC_IF(cond, func)                                                               \
+                                    FUN_ENTRY(GL_LOG_INFO);                                             \
+                                    Context * context = GetCurrentContext();                            \
+                                    DispatchQueue * queue = GetCurrentDispatchQueue();                  \
+                                    if (queue && (cond)) {                                              \
+                                        queue->Enqueue([=](Context *ctx) { ctx->func; });               \
+                                    } else if (context) {                                               \
+                                        if (queue) {                                                    \
+                                            queue->Synchronize();                                       \
+                                        }                                                               \
+                                        context->func;                                                  \
+                                    }
+
+// Calls that read a client array are queued with a copy of the first count elements of it
+#define CONTEXT_EXEC_ASYNC_COPY(func, data, count)                                                      \
+                                    FUN_ENTRY(GL_LOG_INFO);                                             \
+                                    Context * context = GetCurrentContext();                            \
+                                    DispatchQueue * queue = GetCurrentDispatchQueue();                  \
+                                    if (queue && data && (count) > 0 &&                                 \
+                                        (count) * sizeof(*data) <= GLOVE_DISPATCH_MAX_COPY_SIZE) {      \
+                                        auto data##Copy = CopyClientData(data, (count));                \
+                                        queue->Enqueue([=](Context *ctx) { auto data = data##Copy;      \
+                                                                           ctx->func;                   \
+                                                                           delete[] data; });           \
+                                    } else if (context) {                                               \
+                                        if (queue) {                                                    \
+                                            queue->Synchronize();                                       \
+                                        }                                                               \
+                                        context->func;                                                  \
+                                    }
+
+template<typename T>
+static inline T *
+CopyClientData(const T *data, size_t count)
+{
+    T *copy = new T[count];
+    memcpy(static_cast<void *>(copy), static_cast<const void *>(data), count * sizeof(T));
+    return copy;
+}
+
 GL_APICALL void GL_APIENTRY
 glActiveTexture(GLenum texture)
 {
-    CONTEXT_EXEC(ActiveTexture(texture));
+    CONTEXT_EXEC_ASYNC(ActiveTexture(texture));
 }
 
 GL_APICALL void GL_APIENTRY
 glAttachShader(GLuint program, GLuint shader)
 {
-    CONTEXT_EXEC(AttachShader(program, shader));
+    CONTEXT_EXEC_ASYNC(AttachShader(program, shader));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -54,61 +117,70 @@ glBindAttribLocation(GLuint program, GLuint index, const char* name)
 GL_APICALL void GL_APIENTRY
 glBindBuffer(GLenum target, GLuint buffer)
 {
-    CONTEXT_EXEC(BindBuffer(target, buffer));
+    CONTEXT_EXEC_ASYNC(BindBuffer(target, buffer));
+    if (queue) {
+        queue->BindBuffer(target, buffer);
+    }
 }
 
 GL_APICALL void GL_APIENTRY
 glBindFramebuffer(GLenum target, GLuint framebuffer)
 {
-    CONTEXT_EXEC(BindFramebuffer(target, framebuffer));
+    CONTEXT_EXEC_ASYNC(BindFramebuffer(target, framebuffer));
 }
 
 GL_APICALL void GL_APIENTRY
 glBindRenderbuffer(GLenum target, GLuint renderbuffer)
 {
-    CONTEXT_EXEC(BindRenderbuffer(target, renderbuffer));
+    CONTEXT_EXEC_ASYNC(BindRenderbuffer(target, renderbuffer));
 }
 
 GL_APICALL void GL_APIENTRY
 glBlendColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
 {
-    CONTEXT_EXEC(BlendColor(red, green, blue, alpha));
+    CONTEXT_EXEC_ASYNC(BlendColor(red, green, blue, alpha));
 }
 
 GL_APICALL void GL_APIENTRY
 glBlendEquation(GLenum mode)
 {
-    CONTEXT_EXEC(BlendEquation(mode));
+    CONTEXT_EXEC_ASYNC(BlendEquation(mode));
 }
 
 GL_APICALL void GL_APIENTRY
 glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
 {
-    CONTEXT_EXEC(BlendEquationSeparate(modeRGB, modeAlpha));
+    CONTEXT_EXEC_ASYNC(BlendEquationSeparate(modeRGB, modeAlpha));
 }
 
 GL_APICALL void GL_APIENTRY
 glBlendFunc(GLenum sfactor, GLenum dfactor)
 {
-    CONTEXT_EXEC(BlendFunc(sfactor, dfactor));
+    CONTEXT_EXEC_ASYNC(BlendFunc(sfactor, dfactor));
 }
 
 GL_APICALL void GL_APIENTRY
 glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
 {
-    CONTEXT_EXEC(BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha));
+    CONTEXT_EXEC_ASYNC(BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha));
 }
 
 GL_APICALL void GL_APIENTRY
 glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
 {
-    CONTEXT_EXEC(BufferData(target, size, data, usage));
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    if (bytes) {
+        CONTEXT_EXEC_ASYNC_COPY(BufferData(target, size, bytes, usage), bytes, size);
+    } else {
+        CONTEXT_EXEC_ASYNC(BufferData(target, size, nullptr, usage));
+    }
 }
 
 GL_APICALL void GL_APIENTRY
 glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
 {
-    CONTEXT_EXEC(BufferSubData(target, offset, size, data));
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    CONTEXT_EXEC_ASYNC_COPY(BufferSubData(target, offset, size, bytes), bytes, size);
 }
 
 GL_APICALL GLenum GL_APIENTRY
@@ -120,37 +192,37 @@ glCheckFramebufferStatus(GLenum target)
 GL_APICALL void GL_APIENTRY
 glClear(GLbitfield mask)
 {
-    CONTEXT_EXEC(Clear(mask));
+    CONTEXT_EXEC_ASYNC(Clear(mask));
 }
 
 GL_APICALL void GL_APIENTRY
 glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
 {
-    CONTEXT_EXEC(ClearColor(red, green, blue, alpha));
+    CONTEXT_EXEC_ASYNC(ClearColor(red, green, blue, alpha));
 }
 
 GL_APICALL void GL_APIENTRY
 glClearDepthf(GLclampf depth)
 {
-    CONTEXT_EXEC(ClearDepthf(depth));
+    CONTEXT_EXEC_ASYNC(ClearDepthf(depth));
 }
 
 GL_APICALL void GL_APIENTRY
 glClearStencil(GLint s)
 {
-    CONTEXT_EXEC(ClearStencil(s));
+    CONTEXT_EXEC_ASYNC(ClearStencil(s));
 }
 
 GL_APICALL void GL_APIENTRY
 glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
 {
-    CONTEXT_EXEC(ColorMask(red, green, blue, alpha));
+    CONTEXT_EXEC_ASYNC(ColorMask(red, green, blue, alpha));
 }
 
 GL_APICALL void GL_APIENTRY
 glCompileShader(GLuint shader)
 {
-    CONTEXT_EXEC(CompileShader(shader));
+    CONTEXT_EXEC_ASYNC(CompileShader(shader));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -192,13 +264,18 @@ glCreateShader(GLenum type)
 GL_APICALL void GL_APIENTRY
 glCullFace(GLenum mode)
 {
-    CONTEXT_EXEC(CullFace(mode));
+    CONTEXT_EXEC_ASYNC(CullFace(mode));
 }
 
 GL_APICALL void GL_APIENTRY
 glDeleteBuffers(GLsizei n, const GLuint* buffers)
 {
     CONTEXT_EXEC(DeleteBuffers(n, buffers));
+
+    DispatchQueue * queue = GetCurrentDispatchQueue();
+    if (queue) {
+        queue->DeleteBuffers(n, buffers);
+    }
 }
 
 GL_APICALL void GL_APIENTRY
@@ -234,61 +311,70 @@ glDeleteTextures(GLsizei n, const GLuint* textures)
 GL_APICALL void GL_APIENTRY
 glDepthFunc(GLenum func)
 {
-    CONTEXT_EXEC(DepthFunc(func));
+    CONTEXT_EXEC_ASYNC(DepthFunc(func));
 }
 
 GL_APICALL void GL_APIENTRY
 glDepthMask(GLboolean flag)
 {
-    CONTEXT_EXEC(DepthMask(flag));
+    CONTEXT_EXEC_ASYNC(DepthMask(flag));
 }
 
 GL_APICALL void GL_APIENTRY
 glDepthRangef(GLclampf zNear, GLclampf zFar)
 {
-    CONTEXT_EXEC(DepthRangef(zNear, zFar));
+    CONTEXT_EXEC_ASYNC(DepthRangef(zNear, zFar));
 }
 
 GL_APICALL void GL_APIENTRY
 glDetachShader(GLuint program, GLuint shader)
 {
-    CONTEXT_EXEC(DetachShader(program, shader));
+    CONTEXT_EXEC_ASYNC(DetachShader(program, shader));
 }
 
 GL_APICALL void GL_APIENTRY
 glDisable(GLenum cap)
 {
-    CONTEXT_EXEC(Disable(cap));
+    CONTEXT_EXEC_ASYNC(Disable(cap));
 }
 
 GL_APICALL void GL_APIENTRY
 glDisableVertexAttribArray(GLuint index)
 {
-    CONTEXT_EXEC(DisableVertexAttribArray(index));
+    CONTEXT_EXEC_ASYNC(DisableVertexAttribArray(index));
+    if (queue) {
+        queue->EnableVertexAttribArray(index, false);
+    }
 }
 
 GL_APICALL void GL_APIENTRY
 glDrawArrays(GLenum mode, GLint first, GLsizei count)
 {
-    CONTEXT_EXEC(DrawArrays(mode, first, count));
+    // draws that read client arrays must complete before the call returns
+    CONTEXT_EXEC_ASYNC_IF(!queue->HasClientArrays(), DrawArrays(mode, first, count));
 }
 
 GL_APICALL void GL_APIENTRY
 glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
 {
-    CONTEXT_EXEC(DrawElements(mode, count, type, indices));
+    // draws that read client arrays or indices must complete before the call returns
+    CONTEXT_EXEC_ASYNC_IF(!queue->HasClientArrays() && queue->HasElementArrayBuffer(),
+                          DrawElements(mode, count, type, indices));
 }
 
 GL_APICALL void GL_APIENTRY
 glEnable(GLenum cap)
 {
-    CONTEXT_EXEC(Enable(cap));
+    CONTEXT_EXEC_ASYNC(Enable(cap));
 }
 
 GL_APICALL void GL_APIENTRY
 glEnableVertexAttribArray(GLuint index)
 {
-    CONTEXT_EXEC(EnableVertexAttribArray(index));
+    CONTEXT_EXEC_ASYNC(EnableVertexAttribArray(index));
+    if (queue) {
+        queue->EnableVertexAttribArray(index, true);
+    }
 }
 
 GL_APICALL void GL_APIENTRY
@@ -300,7 +386,7 @@ glFinish(void)
 GL_APICALL void GL_APIENTRY
 glFlush(void)
 {
-    CONTEXT_EXEC(Flush());
+    CONTEXT_EXEC_ASYNC(Flush());
 }
 
 GL_APICALL void GL_APIENTRY
@@ -318,7 +404,7 @@ glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuin
 GL_APICALL void GL_APIENTRY
 glFrontFace(GLenum mode)
 {
-    CONTEXT_EXEC(FrontFace(mode));
+    CONTEXT_EXEC_ASYNC(FrontFace(mode));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -348,7 +434,7 @@ glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
 GL_APICALL void GL_APIENTRY
 glBindTexture(GLenum target, GLuint texture)
 {
-    CONTEXT_EXEC(BindTexture(target, texture));
+    CONTEXT_EXEC_ASYNC(BindTexture(target, texture));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -516,7 +602,7 @@ glGetVertexAttribPointerv(GLuint index, GLenum pname, void** pointer)
 GL_APICALL void GL_APIENTRY
 glHint(GLenum target, GLenum mode)
 {
-    CONTEXT_EXEC(Hint(target, mode));
+    CONTEXT_EXEC_ASYNC(Hint(target, mode));
 }
 
 GL_APICALL GLboolean GL_APIENTRY
@@ -564,13 +650,13 @@ glIsTexture(GLuint texture)
 GL_APICALL void GL_APIENTRY
 glLineWidth(GLfloat width)
 {
-    CONTEXT_EXEC(LineWidth(width));
+    CONTEXT_EXEC_ASYNC(LineWidth(width));
 }
 
 GL_APICALL void GL_APIENTRY
 glLinkProgram(GLuint program)
 {
-    CONTEXT_EXEC(LinkProgram(program));
+    CONTEXT_EXEC_ASYNC(LinkProgram(program));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -582,7 +668,7 @@ glPixelStorei(GLenum pname, GLint param)
 GL_APICALL void GL_APIENTRY
 glPolygonOffset(GLfloat factor, GLfloat units)
 {
-    CONTEXT_EXEC(PolygonOffset(factor, units));
+    CONTEXT_EXEC_ASYNC(PolygonOffset(factor, units));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -606,13 +692,13 @@ glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsiz
 GL_APICALL void GL_APIENTRY
 glSampleCoverage(GLclampf value, GLboolean invert)
 {
-    CONTEXT_EXEC(SampleCoverage(value, invert));
+    CONTEXT_EXEC_ASYNC(SampleCoverage(value, invert));
 }
 
 GL_APICALL void GL_APIENTRY
 glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
 {
-    CONTEXT_EXEC(Scissor(x, y, width, height));
+    CONTEXT_EXEC_ASYNC(Scissor(x, y, width, height));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -630,37 +716,37 @@ glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const
 GL_APICALL void GL_APIENTRY
 glStencilFunc(GLenum func, GLint ref, GLuint mask)
 {
-    CONTEXT_EXEC(StencilFunc(func, ref, mask));
+    CONTEXT_EXEC_ASYNC(StencilFunc(func, ref, mask));
 }
 
 GL_APICALL void GL_APIENTRY
 glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
 {
-    CONTEXT_EXEC(StencilFuncSeparate(face, func, ref, mask));
+    CONTEXT_EXEC_ASYNC(StencilFuncSeparate(face, func, ref, mask));
 }
 
 GL_APICALL void GL_APIENTRY
 glStencilMask(GLuint mask)
 {
-    CONTEXT_EXEC(StencilMask(mask));
+    CONTEXT_EXEC_ASYNC(StencilMask(mask));
 }
 
 GL_APICALL void GL_APIENTRY
 glStencilMaskSeparate(GLenum face, GLuint mask)
 {
-    CONTEXT_EXEC(StencilMaskSeparate(face, mask));
+    CONTEXT_EXEC_ASYNC(StencilMaskSeparate(face, mask));
 }
 
 GL_APICALL void GL_APIENTRY
 glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
 {
-    CONTEXT_EXEC(StencilOp(fail, zfail, zpass));
+    CONTEXT_EXEC_ASYNC(StencilOp(fail, zfail, zpass));
 }
 
 GL_APICALL void GL_APIENTRY
 glStencilOpSeparate(GLenum face, GLenum fail, GLenum zfail, GLenum zpass)
 {
-    CONTEXT_EXEC(StencilOpSeparate(face, fail, zfail, zpass));
+    CONTEXT_EXEC_ASYNC(StencilOpSeparate(face, fail, zfail, zpass));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -672,7 +758,7 @@ glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GL
 GL_APICALL void GL_APIENTRY
 glTexParameterf(GLenum target, GLenum pname, GLfloat param)
 {
-    CONTEXT_EXEC(TexParameterf(target, pname, param));
+    CONTEXT_EXEC_ASYNC(TexParameterf(target, pname, param));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -684,7 +770,7 @@ glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params)
 GL_APICALL void GL_APIENTRY
 glTexParameteri(GLenum target, GLenum pname, GLint param)
 {
-    CONTEXT_EXEC(TexParameteri(target, pname, param));
+    CONTEXT_EXEC_ASYNC(TexParameteri(target, pname, param));
 }
 
 GL_APICALL void GL_APIENTRY
@@ -702,187 +788,191 @@ glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsize
 GL_APICALL void GL_APIENTRY
 glUniform1f(GLint location, GLfloat x)
 {
-    CONTEXT_EXEC(Uniform1f(location, x));
+    CONTEXT_EXEC_ASYNC(Uniform1f(location, x));
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform1fv(GLint location, GLsizei count, const GLfloat* v)
 {
-    CONTEXT_EXEC(Uniform1fv(location, count, v));
+    CONTEXT_EXEC_ASYNC_COPY(Uniform1fv(location, count, v), v, count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform1i(GLint location, GLint x)
 {
-    CONTEXT_EXEC(Uniform1i(location, x));
+    CONTEXT_EXEC_ASYNC(Uniform1i(location, x));
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform1iv(GLint location, GLsizei count, const GLint* v)
 {
-    CONTEXT_EXEC(Uniform1iv(location, count, v));
+    CONTEXT_EXEC_ASYNC_COPY(Uniform1iv(location, count, v), v, count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform2f(GLint location, GLfloat x, GLfloat y)
 {
-    CONTEXT_EXEC(Uniform2f(location, x, y));
+    CONTEXT_EXEC_ASYNC(Uniform2f(location, x, y));
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform2fv(GLint location, GLsizei count, const GLfloat* v)
 {
-    CONTEXT_EXEC(Uniform2fv(location, count, v));
+    CONTEXT_EXEC_ASYNC_COPY(Uniform2fv(location, count, v), v, 2 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform2i(GLint location, GLint x, GLint y)
 {
-    CONTEXT_EXEC(Uniform2i(location, x, y));
+    CONTEXT_EXEC_ASYNC(Uniform2i(location, x, y));
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform2iv(GLint location, GLsizei count, const GLint* v)
 {
-    CONTEXT_EXEC(Uniform2iv(location, count, v));
+    CONTEXT_EXEC_ASYNC_COPY(Uniform2iv(location, count, v), v, 2 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z)
 {
-    CONTEXT_EXEC(Uniform3f(location, x, y, z));
+    CONTEXT_EXEC_ASYNC(Uniform3f(location, x, y, z));
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform3fv(GLint location, GLsizei count, const GLfloat* v)
 {
-    CONTEXT_EXEC(Uniform3fv(location, count, v));
+    CONTEXT_EXEC_ASYNC_COPY(Uniform3fv(location, count, v), v, 3 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform3i(GLint location, GLint x, GLint y, GLint z)
 {
-    CONTEXT_EXEC(Uniform3i(location, x, y, z));
+    CONTEXT_EXEC_ASYNC(Uniform3i(location, x, y, z));
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform3iv(GLint location, GLsizei count, const GLint* v)
 {
-    CONTEXT_EXEC(Uniform3iv(location, count, v));
+    CONTEXT_EXEC_ASYNC_COPY(Uniform3iv(location, count, v), v, 3 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
-    CONTEXT_EXEC(Uniform4f(location, x, y, z, w));
+    CONTEXT_EXEC_ASYNC(Uniform4f(location, x, y, z, w));
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform4fv(GLint location, GLsizei count, const GLfloat* v)
 {
-    CONTEXT_EXEC(Uniform4fv(location, count, v));
+    CONTEXT_EXEC_ASYNC_COPY(Uniform4fv(location, count, v), v, 4 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform4i(GLint location, GLint x, GLint y, GLint z, GLint w)
 {
-    CONTEXT_EXEC(Uniform4i(location, x, y, z, w));
+    CONTEXT_EXEC_ASYNC(Uniform4i(location, x, y, z, w));
 }
 
 GL_APICALL void GL_APIENTRY
 glUniform4iv(GLint location, GLsizei count, const GLint* v)
 {
-    CONTEXT_EXEC(Uniform4iv(location, count, v));
+    CONTEXT_EXEC_ASYNC_COPY(Uniform4iv(location, count, v), v, 4 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-    CONTEXT_EXEC(UniformMatrix2fv(location, count, transpose, value));
+    CONTEXT_EXEC_ASYNC_COPY(UniformMatrix2fv(location, count, transpose, value), value, 4 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-    CONTEXT_EXEC(UniformMatrix3fv(location, count, transpose, value));
+    CONTEXT_EXEC_ASYNC_COPY(UniformMatrix3fv(location, count, transpose, value), value, 9 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-    CONTEXT_EXEC(UniformMatrix4fv(location, count, transpose, value));
+    CONTEXT_EXEC_ASYNC_COPY(UniformMatrix4fv(location, count, transpose, value), value, 16 * count);
 }
 
 GL_APICALL void GL_APIENTRY
 glUseProgram(GLuint program)
 {
-    CONTEXT_EXEC(UseProgram(program));
+    CONTEXT_EXEC_ASYNC(UseProgram(program));
 }
 
 GL_APICALL void GL_APIENTRY
 glValidateProgram(GLuint program)
 {
-    CONTEXT_EXEC(ValidateProgram(program));
+    CONTEXT_EXEC_ASYNC(ValidateProgram(program));
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttrib1f(GLuint indx, GLfloat x)
 {
-    CONTEXT_EXEC(VertexAttrib1f(indx, x));
+    CONTEXT_EXEC_ASYNC(VertexAttrib1f(indx, x));
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttrib1fv(GLuint indx, const GLfloat* values)
 {
-    CONTEXT_EXEC(VertexAttrib1fv(indx, values));
+    CONTEXT_EXEC_ASYNC_COPY(VertexAttrib1fv(indx, values), values, 1);
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttrib2f(GLuint indx, GLfloat x, GLfloat y)
 {
-    CONTEXT_EXEC(VertexAttrib2f(indx, x, y));
+    CONTEXT_EXEC_ASYNC(VertexAttrib2f(indx, x, y));
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttrib2fv(GLuint indx, const GLfloat* values)
 {
-    CONTEXT_EXEC(VertexAttrib2fv(indx, values));
+    CONTEXT_EXEC_ASYNC_COPY(VertexAttrib2fv(indx, values), values, 2);
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttrib3f(GLuint indx, GLfloat x, GLfloat y, GLfloat z)
 {
-    CONTEXT_EXEC(VertexAttrib3f(indx, x, y, z));
+    CONTEXT_EXEC_ASYNC(VertexAttrib3f(indx, x, y, z));
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttrib3fv(GLuint indx, const GLfloat* values)
 {
-    CONTEXT_EXEC(VertexAttrib3fv(indx, values));
+    CONTEXT_EXEC_ASYNC_COPY(VertexAttrib3fv(indx, values), values, 3);
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttrib4f(GLuint indx, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
-    CONTEXT_EXEC(VertexAttrib4f(indx, x, y, z, w));
+    CONTEXT_EXEC_ASYNC(VertexAttrib4f(indx, x, y, z, w));
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttrib4fv(GLuint indx, const GLfloat* values)
 {
-    CONTEXT_EXEC(VertexAttrib4fv(indx, values));
+    CONTEXT_EXEC_ASYNC_COPY(VertexAttrib4fv(indx, values), values, 4);
 }
 
 GL_APICALL void GL_APIENTRY
 glVertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* ptr)
 {
-    CONTEXT_EXEC(VertexAttribPointer(indx, size, type, normalized, stride, ptr));
+    // a client pointer is only stored here, it is read by the draw calls
+    CONTEXT_EXEC_ASYNC(VertexAttribPointer(indx, size, type, normalized, stride, ptr));
+    if (queue) {
+        queue->VertexAttribPointer(indx);
+    }
 }
 
 GL_APICALL void GL_APIENTRY
 glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
 {
-    CONTEXT_EXEC(Viewport(x, y, width, height));
+    CONTEXT_EXEC_ASYNC(Viewport(x, y, width, height));
 }
 
 GL_APICALL void GL_APIENTRY
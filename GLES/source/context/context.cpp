@@ -52,7 +52,7 @@ Context::Context()
     mResourceManager = new ResourceManager(mVkContext, mCommandBufferManager);
     mShaderCompiler  = new GlslangShaderCompiler();
     mPipeline        = new vulkanAPI::Pipeline(mVkContext);
-    mCacheManager    = new CacheManager(mVkContext);
+    mCacheManager    = new CacheManager(mVkContext, mCommandBufferManager);
 
     mStateManager.InitVkPipelineStates(mPipeline);
 
@@ -61,10 +61,11 @@ Context::Context()
     mPipeline->SetCacheManager(mCacheManager);
     mResourceManager->SetCacheManager(mCacheManager);
 
-    mWriteSurface = nullptr;
-    mReadSurface  = nullptr;
-    mWriteFBO     = nullptr;
-    mSystemFBO    = nullptr;
+    mWriteSurface  = nullptr;
+    mReadSurface   = nullptr;
+    mWriteFBO      = nullptr;
+    mSystemFBO     = nullptr;
+    mDispatchQueue = nullptr;
 
     //If VK_KHR_maintenance1 is supported, then there is no need to invert the Y
     mIsYInverted        = !(vulkanAPI::GetContext()->mIsMaintenanceExtSupported);
@@ -147,7 +148,7 @@ void
 Context::InitExtensions()
 {
     mCompressedTextureFormats.clear();
-    mExtensions = "GL_OES_get_program_binary GL_OES_rgb8_rgba8 GL_EXT_texture_format_BGRA8888";
+    mExtensions = "GL_OES_get_program_binary GL_OES_rgb8_rgba8 GL_OES_EGL_sync GL_EXT_texture_format_BGRA8888";
     if (mVkContext->vkDeviceFeatures.textureCompressionBC) { 
         mExtensions += " GL_EXT_texture_compression_dxt1 GL_EXT_texture_compression_s3tc";
         mCompressedTextureFormats.push_back(GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
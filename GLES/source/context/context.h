@@ -37,6 +37,7 @@
 #include "rendering_api_interface.h"
 #include <utility>
 #include <map>
+#include <unordered_set>
 
 typedef enum {
     GLOVE_HOST_X86_BINARY = 1,
@@ -45,6 +46,7 @@ typedef enum {
     GLOVE_MAX_BINARY_FORMATS
 } glove_program_binary_formats_e;
 
+class DispatchQueue;
 
 class Context {
 
@@ -61,6 +63,7 @@ private:
     vulkanAPI::Pipeline                        *mPipeline;
     ScreenSpacePass                            *mScreenSpacePass;
     vulkanAPI::CommandBufferManager            *mCommandBufferManager;
+    DispatchQueue                              *mDispatchQueue;
 // ------------
     bool                                        mIsYInverted;
     bool                                        mIsModeLineLoop;
@@ -76,6 +79,9 @@ private:
     typedef std::pair<EGLSurfaceInterface*, EGLSurfaceInterface*> FRAMEBUFFER_SURFACES_PAIR;
     std::map<FRAMEBUFFER_SURFACES_PAIR, Framebuffer*> mSystemFBOMap;
 
+    /// Attachments written by the render passes recorded since the last submission
+    std::unordered_set<const Texture *>         mPendingRenderTargets;
+
 // ------------
 
     std::string                                 mExtensions;
@@ -97,6 +103,8 @@ private:
 
     void UpdateViewportState(vulkanAPI::Pipeline* pipeline);
     void BeginRendering(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled);
+    void EndRendering(void);
+    void FlushPendingRenderTarget(const Texture *texture);
     void PushGeometry(uint32_t vertCount, uint32_t firstVertex, bool indexed, GLenum type, const void *indices);
     void UpdateVertexAttributes(uint32_t vertCount, uint32_t firstVertex);
     void UpdateIndices(uint32_t* offset, uint32_t indexCount, GLenum type, const void* indices, BufferObject* ibo);
@@ -128,17 +136,21 @@ public:
 
     void                    DeleteShader(Shader *shaderPtr);
     void                    ReleaseSystemFBO(void);
+    uint64_t                InsertFence(void);
+    bool                    WaitFence(uint64_t fence, uint64_t timeout);
 
 // Get Functions
     inline  StateManager    *GetStateManager(void)                                { FUN_ENTRY(GL_LOG_TRACE); return &mStateManager; }
     inline  ResourceManager *GetResourceManager(void)                             { FUN_ENTRY(GL_LOG_TRACE); return mResourceManager; }
     inline  bool            IsYInverted(void)                              const  { FUN_ENTRY(GL_LOG_TRACE); return mIsYInverted; }
     inline  bool            IsModeLineLoop(void)                           const  { FUN_ENTRY(GL_LOG_TRACE); return mIsModeLineLoop; }
+    inline  DispatchQueue   *GetDispatchQueue(void)                        const  { FUN_ENTRY(GL_LOG_TRACE); return mDispatchQueue; }
 
 // Set Functions
             void            SetReadWriteSurfaces(EGLSurfaceInterface *eglReadSurfaceInterface, EGLSurfaceInterface *eglWriteSurfaceInterface);
     inline  void            SetNextImageIndex(uint32_t imageIndex)                { FUN_ENTRY(GL_LOG_TRACE); if(mStateManager.GetActiveObjectsState()->IsDefaultFramebufferObjectActive()) mWriteFBO->SetWriteBufferIndex(imageIndex); }
     inline  void            BindToTexture(GLuint bind)                            { FUN_ENTRY(GL_LOG_DEBUG); mSystemFBO->SetBindToTexture(bind); }
+    inline  void            SetDispatchQueue(DispatchQueue *queue)                { FUN_ENTRY(GL_LOG_TRACE); mDispatchQueue = queue; }
 
     inline  bool            HasShaderCompiler(void);
 
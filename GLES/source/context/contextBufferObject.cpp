@@ -39,6 +39,7 @@ Context::BindBuffer(GLenum target, GLuint buffer)
         bo->SetTarget(target);
         bo->SetVkContext(mVkContext);
         bo->SetCacheManager(mCacheManager);
+        bo->SetCommandBufferManager(mCommandBufferManager);
     }
     mStateManager.GetActiveObjectsState()->SetActiveBufferObject(target, bo);
 
@@ -74,10 +75,6 @@ Context::BufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usa
     }
 
     bo->SetUsage(usage);
-    if((data && bo->HasData()) || (data == nullptr && bo->GetSize() && (size_t)size != bo->GetSize())) {
-        bo->Release();
-    }
-
     if(!bo->Allocate(size, data)) {
         RecordError(GL_OUT_OF_MEMORY);
         return;
@@ -141,6 +138,9 @@ Context::DeleteBuffers(GLsizei n, const GLuint* buffers)
                 mStateManager.GetActiveObjectsState()->ResetActiveBufferObject(buf->GetTarget());
             }
 
+            mResourceManager->DeallocateBuffer(buffer);
+        } else if(buffer) {
+            // a name generated but never bound holds a slot only
             mResourceManager->DeallocateBuffer(buffer);
         }
     }
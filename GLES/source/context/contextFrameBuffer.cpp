@@ -51,8 +51,15 @@ Context::BindFramebuffer(GLenum target, GLuint framebuffer)
         return;
     }
 
-    if(mWriteFBO->IsInDrawState()) {
-        Finish();
+    // the render passes of the frame are recorded back to back in the same command
+    // buffer. Without maintenance1 sampling an attachment reads it back to the host,
+    // so the rendering has to be completed on the GPU first.
+    if(!mWriteFBO->IsInIdleState()) {
+        if(mVkContext->mIsMaintenanceExtSupported) {
+            EndRendering();
+        } else {
+            Finish();
+        }
     }
 
     mWriteFBO = fbo;
@@ -105,8 +112,8 @@ Context::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
 
             if(mWriteFBO == fbo) {
 
-                if(mWriteFBO->IsInDrawState()) {
-                    Finish();
+                if(!mWriteFBO->IsInIdleState()) {
+                    EndRendering();
                 }
 
                 mWriteFBO = mSystemFBO;
@@ -117,6 +124,9 @@ Context::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
                 mPipeline->SetUpdateViewportState(true);
             }
 
+            mResourceManager->DeallocateFramebuffer(fboindex);
+        } else if(fboindex) {
+            // a name generated but never bound holds a slot only
             mResourceManager->DeallocateFramebuffer(fboindex);
         }
     }
@@ -148,8 +158,8 @@ Context::FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum render
         return;
     }
 
-    if(renderbuffer != mWriteFBO->GetAttachmentName(attachment) && mWriteFBO->IsInDrawState()) {
-        Finish();
+    if(renderbuffer != mWriteFBO->GetAttachmentName(attachment) && !mWriteFBO->IsInIdleState()) {
+        EndRendering();
     }
 
     switch(attachment) {
@@ -222,8 +232,8 @@ Context::FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget
         return;
     }
 
-    if(texture && texture != mWriteFBO->GetAttachmentName(attachment) && mWriteFBO->IsInDrawState()) {
-        Finish();
+    if(texture && texture != mWriteFBO->GetAttachmentName(attachment) && !mWriteFBO->IsInIdleState()) {
+        EndRendering();
     }
 
     switch(attachment) {
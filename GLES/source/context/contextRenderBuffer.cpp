@@ -73,13 +73,13 @@ Context::DeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers)
                (index == mWriteFBO->GetColorAttachmentName()    ||
                 index == mWriteFBO->GetDepthAttachmentName()    ||
                 index == mWriteFBO->GetStencilAttachmentName()) &&
-                mWriteFBO->IsInDrawState()) {
+                !mWriteFBO->IsInIdleState()) {
 
                 if(index == mWriteFBO->GetColorAttachmentName()) {
                     mWriteFBO->SetStateDelete();
                 }
 
-                Finish();
+                EndRendering();
             }
 
             if(index == mWriteFBO->GetColorAttachmentName()) {
@@ -102,6 +102,9 @@ Context::DeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers)
                 mStateManager.GetActiveObjectsState()->SetActiveRenderbufferObjectID(0);
             }
             mResourceManager->DeallocateRenderbuffer(index);
+        } else if(index) {
+            // a name generated but never bound holds a slot only
+            mResourceManager->DeallocateRenderbuffer(index);
         }
     }
 }
@@ -207,8 +210,8 @@ Context::RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width
     if((activeRenderbufferId == mWriteFBO->GetColorAttachmentName()    ||
         activeRenderbufferId == mWriteFBO->GetDepthAttachmentName()    ||
         activeRenderbufferId == mWriteFBO->GetStencilAttachmentName()) &&
-        mWriteFBO->IsInDrawState()) {
-        Finish();
+        !mWriteFBO->IsInIdleState()) {
+        EndRendering();
     }
 
     Renderbuffer* activeRenderbuffer = mResourceManager->GetRenderbuffer(activeRenderbufferId);
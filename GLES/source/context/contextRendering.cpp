@@ -65,6 +65,56 @@ Context::BeginRendering(bool clearColorEnabled, bool clearDepthEnabled, bool cle
     PrepareRenderPass(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
     mCommandBufferManager->BeginVkDrawCommandBuffer();
     mWriteFBO->BeginVkRenderPass();
+
+    if(mWriteFBO->GetColorAttachmentTexture()) {
+        mPendingRenderTargets.insert(mWriteFBO->GetColorAttachmentTexture());
+    }
+    if(mWriteFBO->GetDepthStencilAttachmentTexture()) {
+        mPendingRenderTargets.insert(mWriteFBO->GetDepthStencilAttachmentTexture());
+    }
+}
+
+void
+Context::EndRendering(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // close the render pass, so that the final layout transitions of the
+    // attachments are recorded right after it, in the same command buffer.
+    // The next render pass flushes them before it begins.
+    mWriteFBO->EndVkRenderPass();
+
+    if(!mWriteFBO->IsInDeleteState()) {
+        if(mWriteFBO == mSystemFBO) {
+            if(mWriteFBO->GetSurfaceType() == GLOVE_SURFACE_WINDOW) {
+                mWriteFBO->PrepareVkImage(VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+            } else if (mWriteFBO->GetSurfaceType() == GLOVE_SURFACE_PBUFFER) {
+                if(mSystemFBO->GetBindToTexture()) {
+                    mWriteFBO->PrepareVkImage(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                }
+            }
+        } else {
+            mWriteFBO->PrepareVkImage(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+    }
+
+    mWriteFBO->SetStateIdle();
+}
+
+void
+Context::FlushPendingRenderTarget(const Texture *texture)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // transfers are recorded outside of the draw command buffer and run ahead
+    // of it, so a texture rendered or sampled by draws that have not been
+    // submitted yet must have them submitted first
+    if(mPendingRenderTargets.find(texture) == mPendingRenderTargets.end() && !texture->IsReadPending()) {
+        return;
+    }
+
+    EndRendering();
+    Flush();
 }
 
 void
@@ -95,9 +145,8 @@ Context::Clear(GLbitfield mask)
 void
 Context::ClearSimple(bool clearColorEnabled, bool clearDepthEnabled, bool clearStencilEnabled)
 {
-    if(mWriteFBO->IsInDrawState()) {
-        Finish();
-    }
+    // the clear values are applied when the render pass begins, so start a new one
+    mWriteFBO->EndVkRenderPass();
     mWriteFBO->SetStateClear();
 
     BeginRendering(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
@@ -116,11 +165,12 @@ Context::ClearWithColorMask(bool clearColorEnabled, bool clearDepthEnabled, bool
         return;
     }
 
-    if(mWriteFBO->IsInClearState()) {
-        Finish();
-    }
+    // the screen-space pass is drawn in a new render pass, which the following
+    // draws continue, as with a simple clear
+    mWriteFBO->EndVkRenderPass();
+    mWriteFBO->SetStateClear();
 
-    PrepareRenderPass(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
+    BeginRendering(clearColorEnabled, clearDepthEnabled, clearStencilEnabled);
 
     StateFramebufferOperations *stateFramebufferOperations = mStateManager.GetFramebufferOperationsState();
 
@@ -155,24 +205,20 @@ Context::ClearWithColorMask(bool clearColorEnabled, bool clearDepthEnabled, bool
         return;
     }
 
-    mCommandBufferManager->BeginVkDrawCommandBuffer();
-    mWriteFBO->BeginVkRenderPass();
-
-    const VkCommandBuffer *secondaryCmdBuffer = mCommandBufferManager->AllocateVkSecondaryCmdBuffers(1);
-    mCommandBufferManager->BeginVkSecondaryCommandBuffer(secondaryCmdBuffer, *mWriteFBO->GetVkRenderPass(), *mWriteFBO->GetActiveVkFramebuffer());
-
-    mScreenSpacePass->BindPipeline(secondaryCmdBuffer);
-    mScreenSpacePass->BindUniformDescriptors(secondaryCmdBuffer);
-    mScreenSpacePass->BindVertexBuffers(secondaryCmdBuffer);
+    const VkCommandBuffer *drawCmdBuffer = mCommandBufferManager->BeginVkDrawRecording(*mWriteFBO->GetVkRenderPass(), *mWriteFBO->GetActiveVkFramebuffer());
+    if(drawCmdBuffer == nullptr) {
+        Finish();
+        return;
+    }
 
-    pipeline->UpdateDynamicState(secondaryCmdBuffer, mStateManager.GetRasterizationState()->GetLineWidth());
+    mScreenSpacePass->BindPipeline(drawCmdBuffer);
+    mScreenSpacePass->BindUniformDescriptors(drawCmdBuffer);
+    mScreenSpacePass->BindVertexBuffers(drawCmdBuffer);
 
-    mScreenSpacePass->Draw(secondaryCmdBuffer);
-    mCommandBufferManager->EndVkSecondaryCommandBuffer(secondaryCmdBuffer);
+    pipeline->UpdateDynamicState(drawCmdBuffer, mCommandBufferManager->GetBindState(), mStateManager.GetRasterizationState()->GetLineWidth());
 
-    VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
-    vkCmdExecuteCommands(activeCmdBuffer, 1, secondaryCmdBuffer);
-    Finish();
+    mScreenSpacePass->Draw(drawCmdBuffer);
+    mCommandBufferManager->EndVkDrawRecording(drawCmdBuffer);
 }
 
 void
@@ -251,24 +297,24 @@ Context::PushGeometry(uint32_t vertCount, uint32_t firstVertex, bool indexed, GL
         mPipeline->SetColorBlendAttachmentWriteMask(GLColorMaskToVkColorComponentFlags(mStateManager.GetFramebufferOperationsState()->GetColorMask()));
     }
 
-    VkCommandBuffer *secondaryCmdBuffer = mCommandBufferManager->AllocateVkSecondaryCmdBuffers(1);
-    mCommandBufferManager->BeginVkSecondaryCommandBuffer(secondaryCmdBuffer, *mWriteFBO->GetVkRenderPass(), *mWriteFBO->GetActiveVkFramebuffer());
+    VkCommandBuffer *drawCmdBuffer = mCommandBufferManager->BeginVkDrawRecording(*mWriteFBO->GetVkRenderPass(), *mWriteFBO->GetActiveVkFramebuffer());
+    if(drawCmdBuffer == nullptr) {
+        Finish();
+        return;
+    }
 
-    mPipeline->Bind(secondaryCmdBuffer);
-    BindUniformDescriptors(secondaryCmdBuffer);
-    BindVertexBuffers(secondaryCmdBuffer);
+    mPipeline->Bind(drawCmdBuffer, mCommandBufferManager->GetBindState());
+    BindUniformDescriptors(drawCmdBuffer);
+    BindVertexBuffers(drawCmdBuffer);
     if(indexed) {
-        BindIndexBuffer(secondaryCmdBuffer, indexOffset, GlToVkIndexType(type));
+        BindIndexBuffer(drawCmdBuffer, indexOffset, GlToVkIndexType(type));
     }
     UpdateViewportState(mPipeline);
 
-    mPipeline->UpdateDynamicState(secondaryCmdBuffer, mStateManager.GetRasterizationState()->GetLineWidth());
-
-    DrawGeometry(secondaryCmdBuffer, indexed, firstVertex, vertCount);
-    mCommandBufferManager->EndVkSecondaryCommandBuffer(secondaryCmdBuffer);
+    mPipeline->UpdateDynamicState(drawCmdBuffer, mCommandBufferManager->GetBindState(), mStateManager.GetRasterizationState()->GetLineWidth());
 
-    VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
-    vkCmdExecuteCommands(activeCmdBuffer, 1, secondaryCmdBuffer);
+    DrawGeometry(drawCmdBuffer, indexed, firstVertex, vertCount);
+    mCommandBufferManager->EndVkDrawRecording(drawCmdBuffer);
 }
 
 void
@@ -276,6 +322,11 @@ Context::UpdateIndices(uint32_t* offset, uint32_t indexCount, GLenum type, const
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    // The bound index buffer is read by this draw even when the indices need no preparation
+    if(ibo) {
+        ibo->SetReadSerial();
+    }
+
     if(mPipeline->GetUpdateIndexBuffer() || indices) {
         mStateManager.GetActiveShaderProgram()->PrepareIndexBufferObject(offset, indexCount, type, indices, ibo);
         mPipeline->SetUpdateIndexBuffer(false);
@@ -303,13 +354,19 @@ Context::BindUniformDescriptors(VkCommandBuffer *CmdBuffer)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mStateManager.GetActiveShaderProgram()->GetValidDescriptorSet();
+    mStateManager.GetActiveShaderProgram()->UpdateBuiltInUniformData(mStateManager.GetViewportTransformationState()->GetMinDepthRange(),
+                                                                     mStateManager.GetViewportTransformationState()->GetMaxDepthRange());
+    mStateManager.GetActiveShaderProgram()->UpdateDescriptorSet();
 
     if(*mStateManager.GetActiveShaderProgram()->GetVkDescSet()) {
-        mStateManager.GetActiveShaderProgram()->UpdateBuiltInUniformData(mStateManager.GetViewportTransformationState()->GetMinDepthRange(),
-                                                                         mStateManager.GetViewportTransformationState()->GetMaxDepthRange());
-        mStateManager.GetActiveShaderProgram()->UpdateDescriptorSet();
-        vkCmdBindDescriptorSets(*CmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mStateManager.GetActiveShaderProgram()->GetVkPipelineLayout(), 0, 1, mStateManager.GetActiveShaderProgram()->GetVkDescSet(), 0, nullptr);
+        mCommandBufferManager->GetBindState()->BindDescriptorSet(CmdBuffer, mStateManager.GetActiveShaderProgram()->GetVkPipelineLayout(), *mStateManager.GetActiveShaderProgram()->GetVkDescSet(),
+                                                                 mStateManager.GetActiveShaderProgram()->GetDynamicOffsetCount(), mStateManager.GetActiveShaderProgram()->GetDynamicOffsets());
+    }
+
+    const ShaderResourceInterface::uniformBlock *pushConstantBlock = mStateManager.GetActiveShaderProgram()->GetPushConstantBlock();
+    if(pushConstantBlock) {
+        mCommandBufferManager->GetBindState()->PushConstants(CmdBuffer, mStateManager.GetActiveShaderProgram()->GetVkPipelineLayout(), mStateManager.GetActiveShaderProgram()->GetPushConstantStages(),
+                                                             static_cast<uint32_t>(pushConstantBlock->blockSize), pushConstantBlock->pClientData);
     }
 }
 
@@ -319,10 +376,8 @@ Context::BindVertexBuffers(VkCommandBuffer *CmdBuffer)
     FUN_ENTRY(GL_LOG_TRACE);
 
     if(mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount()) {
-        VkDeviceSize *offsets = new VkDeviceSize[mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount()];
-        memset(offsets, 0, sizeof(VkDeviceSize) * mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount());
-        vkCmdBindVertexBuffers(*CmdBuffer, 0, mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount(), mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffers(), offsets);
-        delete [] offsets;
+        mCommandBufferManager->GetBindState()->BindVertexBuffers(CmdBuffer, mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersCount(), mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffers(),
+                                                                 mStateManager.GetActiveShaderProgram()->GetActiveVertexVkBuffersOffsets());
     }
 }
 
@@ -332,7 +387,7 @@ Context::BindIndexBuffer(VkCommandBuffer *CmdBuffer, uint32_t offset, VkIndexTyp
     FUN_ENTRY(GL_LOG_TRACE);
 
     if(mStateManager.GetActiveShaderProgram()->GetActiveIndexVkBuffer()) {
-        vkCmdBindIndexBuffer(*CmdBuffer, mStateManager.GetActiveShaderProgram()->GetActiveIndexVkBuffer(), offset, type);
+        mCommandBufferManager->GetBindState()->BindIndexBuffer(CmdBuffer, mStateManager.GetActiveShaderProgram()->GetActiveIndexVkBuffer(), offset, type);
     }
 }
 
@@ -423,6 +478,12 @@ Context::Finish(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    if(mWriteFBO == nullptr) {
+        return;
+    }
+
+    EndRendering();
+
     if(!Flush()) {
         return;
     }
@@ -431,19 +492,6 @@ Context::Finish(void)
         return;
     }
 
-    if(!mWriteFBO->IsInDeleteState()) {
-        if(mWriteFBO == mSystemFBO) {
-            if(mWriteFBO->GetSurfaceType() == GLOVE_SURFACE_WINDOW) {
-                mWriteFBO->PrepareVkImage(VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
-            } else if (mWriteFBO->GetSurfaceType() == GLOVE_SURFACE_PBUFFER) {
-                if(mSystemFBO->GetBindToTexture()) {
-                    mWriteFBO->PrepareVkImage(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-                }
-            }
-        } else {
-            mWriteFBO->PrepareVkImage(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        }
-    }
     mWriteFBO->SetStateIdle();
 
     mResourceManager->ResetShaderProgramDescSetsState();
@@ -460,14 +508,33 @@ Context::Flush(void)
         return false;
     }
 
-    if(mWriteFBO->EndVkRenderPass()) {
-        mCommandBufferManager->EndVkDrawCommandBuffer();
-        mCommandBufferManager->SubmitVkDrawCommandBuffer();
-    }
+    // submits the recorded draws as well as any pending uploads and transitions
+    mWriteFBO->EndVkRenderPass();
+    mCommandBufferManager->EndVkDrawCommandBuffer();
+    mCommandBufferManager->SubmitVkDrawCommandBuffer();
+    mPendingRenderTargets.clear();
+
+    mCacheManager->CleanUpCompletedFrameCaches();
 
     return true;
 }
 
+uint64_t
+Context::InsertFence(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return mCommandBufferManager->GetFenceSerial();
+}
+
+bool
+Context::WaitFence(uint64_t fence, uint64_t timeout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return mCommandBufferManager->WaitSerial(fence, timeout);
+}
+
 void
 Context::SetClearRect(void)
 {
@@ -350,7 +350,9 @@ Context::CreateShaderCompiler(void)
         ObjectArray<ShaderProgram> *shaderProgramArray = mResourceManager->GetShaderProgramArray();
         auto &objects = shaderProgramArray->GetObjects();
         for (uint32_t i = 0; i < objects.Size(); ++i) {
-            objects[i]->SetShaderCompiler(mShaderCompiler);
+            if(objects[i]) {
+                objects[i]->SetShaderCompiler(mShaderCompiler);
+            }
         }
     }
 }
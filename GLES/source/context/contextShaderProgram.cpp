@@ -645,8 +645,10 @@ Context::ProgramBinaryOES(GLuint program, GLenum binaryFormat, const void *binar
     AttachShader(program, vs);
     AttachShader(program, fs);
 
-    progPtr->UsePrecompiledBinary(binary, length);
-    progPtr->SetShaderModules();
+    // a rejected binary leaves the program unlinked
+    if(progPtr->UsePrecompiledBinary(binary, length)) {
+        progPtr->SetShaderModules();
+    }
 }
 
 void
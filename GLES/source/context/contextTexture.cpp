@@ -97,11 +97,11 @@ Context::DeleteTextures(GLsizei n, const GLuint* textures)
 
         if (texture && mResourceManager->TextureExists(texture)) {
 
-            if(mWriteFBO->IsInDrawState()) {
+            if(!mWriteFBO->IsInIdleState()) {
                 if(texture == mWriteFBO->GetColorAttachmentName()) {
                     mWriteFBO->SetStateDelete();
                 }
-                Finish();
+                EndRendering();
             }
 
             if(texture == mWriteFBO->GetColorAttachmentName()) {
@@ -128,6 +128,9 @@ Context::DeleteTextures(GLsizei n, const GLuint* textures)
                 }
             }
 
+            mResourceManager->DeallocateTexture(texture);
+        } else if(texture) {
+            // a name generated but never bound holds a slot only
             mResourceManager->DeallocateTexture(texture);
         }
     }
@@ -160,6 +163,7 @@ Context::GenerateMipmap(GLenum target)
         return;
     }
 
+    FlushPendingRenderTarget(activeTexture);
     activeTexture->GenerateMipmaps(mStateManager.GetHintAspectsState()->GetMode(GL_GENERATE_MIPMAP_HINT));
 }
 
@@ -388,6 +392,7 @@ Context::TexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei w
     // copy the buffer contents to the texture
     Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
     GLint layer = (target == GL_TEXTURE_2D) ? 0 : target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+    FlushPendingRenderTarget(activeTexture);
     activeTexture->SetState(width, height, level, layer, format, type, mStateManager.GetPixelStorageState()->GetPixelStoreUnpack(), pixels);
 
     if(activeTexture->IsCompleted()) {
@@ -469,10 +474,16 @@ Context::TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset,
                       (int)(GlTypeToElementSize(activeTexture->GetType())),
                       Texture::GetDefaultInternalAlignment());
 
+    FlushPendingRenderTarget(activeTexture);
+
+    // a level already in the image is updated in place, staging the subrectangle
+    // only and leaving the rest of the texture and its format untouched
+    const bool resident = activeTexture->IsLevelResident(level, layer);
+
     // copy the buffer contents to the texture
     activeTexture->SetSubState(&srcRect, &dstRect, level, layer, srcInternalFormat, pixels);
 
-    if(activeTexture->IsCompleted()) {
+    if(!resident && activeTexture->IsCompleted()) {
         // pass contents to the driver
         VkFormat vkformat = activeTexture->FindSupportedVkColorFormat(GlColorFormatToVkColorFormat(format, type));
         activeTexture->SetVkFormat(vkformat);
@@ -552,6 +563,9 @@ Context::CopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint
     uint8_t *stagePixels = new uint8_t[stageSize];
     srcRect.y = fbTexture->GetInvertedYOrigin(&srcRect);
 
+    FlushPendingRenderTarget(fbTexture);
+    FlushPendingRenderTarget(activeTexture);
+
     // copy the framebuffer contents to the temp buffer
     // and convert them to the texture's internal format
     fbTexture->CopyPixelsToHost(&srcRect, &dstRect, 0, 0, internalformat, static_cast<void *>(stagePixels));
@@ -628,6 +642,9 @@ Context::CopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoff
     uint8_t *stagePixels = new uint8_t[stageSize];
     srcRect.y = fbTexture->GetInvertedYOrigin(&srcRect);
 
+    FlushPendingRenderTarget(fbTexture);
+    FlushPendingRenderTarget(activeTexture);
+
     // copy the framebuffer subcontents to the temp buffer
     // and convert them to the texture's internal format
     fbTexture->CopyPixelsToHost(&srcRect, &dstRect, 0, 0, dstInternalFormat, static_cast<void *>(stagePixels));
@@ -712,6 +729,7 @@ Context::CompressedTexImage2D(GLenum target, GLint level, GLenum internalformat,
     // copy the buffer contents to the texture
     Texture *activeTexture = mStateManager.GetActiveObjectsState()->GetActiveTexture(target);
     GLint layer = (target == GL_TEXTURE_2D) ? 0 : target - GL_TEXTURE_CUBE_MAP_POSITIVE_X;
+    FlushPendingRenderTarget(activeTexture);
     activeTexture->SetCompressedState(width, height, level, layer, internalformat, imageSize, data);
 
     if (activeTexture->IsCompleted()) {
@@ -456,9 +456,51 @@ GlslangShaderCompiler::CompileUniforms(const glslang::TProgram* prog)
 
     assert(mUniforms.size() == (uint32_t)nLiveUniforms);
 
+    /// Pick the loose uniforms that are pushed as constants instead.
+    /// Matrices go first, as they are most often per object transforms
+    std::vector<bool> isPushConstant(mUniforms.size(), false);
+    std::vector<uint32_t> pushConstants;
+    size_t pushConstantsSize = 0;
+    for(int pass = 0; pass < 2; ++pass) {
+        for(uint32_t i = 0; i < mUniforms.size(); ++i) {
+            const uniform_t &uni = mUniforms[i];
+            const bool isMatrix = uni.glType == GL_FLOAT_MAT3 || uni.glType == GL_FLOAT_MAT4;
+
+            /// mat2 and arrays are laid out differently in push constant blocks, keep them in the uniform block
+            if(!IsUniformPackable(uni) || prog->getUniformTType(i)->isArray() || uni.glType == GL_FLOAT_MAT2 || isMatrix != (pass == 0)) {
+                continue;
+            }
+
+            const size_t alignment = GlslTypeToBaseAlignment(uni.glType);
+            const size_t offset    = (pushConstantsSize + alignment - 1) & ~(alignment - 1);
+            if(offset + GlslTypeToSize(uni.glType) <= GLOVE_MAX_PUSH_CONSTANTS_SIZE) {
+                isPushConstant[i] = true;
+                pushConstants.push_back(i);
+                pushConstantsSize = offset + GlslTypeToSize(uni.glType);
+            }
+        }
+    }
+
     /// Generate locations for uniforms
     /// and bindings for uniform blocks
     uint32_t location = 0, binding = 0;
+
+    /// Loose uniforms share a single block, which takes the lowest binding
+    for(uint32_t i = 0; i < mUniforms.size(); ++i) {
+        if(IsUniformPackable(mUniforms[i]) && !isPushConstant[i]) {
+            const std::string blockName = std::string(STRINGIFY_MACRO(GLOVE_DEFAULT_UNIFORM_BLOCK));
+            mUniformBlocks[blockName] = {blockName,                                                     /// Copy name for debugging
+                                         std::string("uni") + std::to_string(binding),                  /// Construct uniform block's name
+                                         binding,                                                       /// Binding index
+                                         false,                                                         /// Definitely not an opaque type
+                                         0,                                                             /// blockSize (not known yet)
+                                         INVALID_SHADER,                                                /// stage (set by its members)
+                                         nullptr};                                                      /// This block packs base types (or arrays of them)
+            ++binding;
+            break;
+        }
+    }
+
     for(const auto &aggr : mAggregates) {
         /// Each unique aggregate name will be encapsulated into a uniform block
         if(mUniformBlocks.find(aggr.second.name) == mUniformBlocks.end()) {
@@ -486,10 +528,25 @@ GlslangShaderCompiler::CompileUniforms(const glslang::TProgram* prog)
         }
     }
 
-    assert(mUniformBlocks.size() == mAggregates.size());
-
     /// For uniforms that do not belong to an aggregate type
-    for(auto &uni : mUniforms) {
+    size_t packedOffset = 0;
+    for(uint32_t i = 0; i < mUniforms.size(); ++i) {
+        uniform_t &uni = mUniforms[i];
+
+        if(isPushConstant[i]) {
+            /// Placed into the push constant block below
+            uni.location = location;
+            location += uni.arraySize ? uni.arraySize : 1;
+            continue;
+        }
+
+        if(IsUniformPackable(uni)) {
+            uni.location = location;
+            location += uni.arraySize ? uni.arraySize : 1;
+            PackUniform(&uni, prog->getUniformTType(i), &mUniformBlocks.find(std::string(STRINGIFY_MACRO(GLOVE_DEFAULT_UNIFORM_BLOCK)))->second, &packedOffset);
+            continue;
+        }
+
         if(!uni.pAggregate) {
             const bool isSampler = uni.glType == GL_SAMPLER_2D || uni.glType == GL_SAMPLER_CUBE;
 
@@ -516,6 +573,81 @@ GlslangShaderCompiler::CompileUniforms(const glslang::TProgram* prog)
             location += uni.arraySize ? uni.arraySize : 1;
         }
     }
+
+    /// The push constant block takes the highest binding, although it is not bound to any
+    if(!pushConstants.empty()) {
+        const std::string blockName = std::string(STRINGIFY_MACRO(GLOVE_PUSH_CONSTANT_BLOCK));
+        mUniformBlocks[blockName] = {blockName,                                                         /// Copy name for debugging
+                                     std::string("uni") + std::to_string(binding),                      /// Construct uniform block's name
+                                     binding,                                                           /// Binding index
+                                     false,                                                             /// Definitely not an opaque type
+                                     pushConstantsSize,                                                 /// blockSize
+                                     INVALID_SHADER,                                                    /// stage (set by its members)
+                                     nullptr};                                                          /// This block packs base types
+        uniformBlock_t *pBlock = &mUniformBlocks[blockName];
+        pBlock->isPushConstant = true;
+        ++binding;
+
+        size_t pushConstantOffset = 0;
+        for(auto i : pushConstants) {
+            PackUniform(&mUniforms[i], prog->getUniformTType(i), pBlock, &pushConstantOffset);
+        }
+        assert(pushConstantOffset == pushConstantsSize);
+    }
+}
+
+void
+GlslangShaderCompiler::PackUniform(uniform_t *uniform, const glslang::TType *uniformType, uniformBlock_t *pBlock, size_t *offset)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const int32_t arraySize = uniform->arraySize ? uniform->arraySize : 1;
+
+    /// std140: array elements start at vec4 boundaries, other members at their base alignment
+    const size_t alignment = uniformType->isArray() ? 16 : GlslTypeToBaseAlignment(uniform->glType);
+    const size_t size      = uniformType->isArray() ? arraySize * GlslTypeToAllignment(uniform->glType) : GlslTypeToSize(uniform->glType);
+    *offset = (*offset + alignment - 1) & ~(alignment - 1);
+
+    const std::string variableName = std::string(uniform->variableName, 0, uniform->variableName.find_first_of("["));
+    uniform->declaration = (uniformType->getQualifier().precision != glslang::EpqNone ?
+                            std::string(glslang::GetPrecisionQualifierString(uniformType->getQualifier().precision)) + std::string(" ") : std::string("")) +
+                           std::string(GlslTypeToName(uniform->glType)) + std::string(" ") + variableName +
+                           (uniformType->isArray() ? std::string("[") + std::to_string(arraySize) + std::string("]") : std::string("")) + std::string(";");
+
+    uniform->pBlock = pBlock;
+    uniform->offset = *offset;
+    pBlock->blockStage = static_cast<shader_type_t>(pBlock->blockStage | uniform->stage);
+    pBlock->packedUniforms.push_back(uniform);
+
+    *offset += size;
+}
+
+bool
+GlslangShaderCompiler::IsUniformPackable(const uniform_t &uniform) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(uniform.pAggregate || !GlslTypeToName(uniform.glType)) {
+        return false;
+    }
+
+    /// Names of the generated blocks are renamed in the source, keep such uniforms in a block of their own
+    const std::string uniStr("uni");
+    if(!uniform.variableName.compare(0, uniStr.length(), uniStr) &&
+       uniform.variableName.find_first_not_of("0123456789", uniStr.length()) == std::string::npos) {
+        return false;
+    }
+
+    /// The block is declared in both stages. A uniform of one stage can join it
+    /// only if its name is not used for anything else in the other stage
+    if(uniform.stage == (SHADER_TYPE_VERTEX | SHADER_TYPE_FRAGMENT)) {
+        return true;
+    }
+
+    const std::string variableName = std::string(uniform.variableName, 0, uniform.variableName.find_first_of("["));
+    const std::string otherSource  = std::string(uniform.stage == SHADER_TYPE_VERTEX ? mSlangFragCompiler->GetSource() : mSlangVertCompiler->GetSource());
+
+    return FindToken(variableName, otherSource, 0) == std::string::npos;
 }
 
 void
@@ -609,6 +741,7 @@ GlslangShaderCompiler::BuildUniformReflection(void)
         mShaderReflection->SetUniformBlockBlockSize(block->blockSize, i);
         mShaderReflection->SetUniformBlockBlockStage(block->blockStage, i);
         mShaderReflection->SetUniformBlockOpaque(block->isOpaque, i);
+        mShaderReflection->SetUniformBlockPushConstant(block->isPushConstant, i);
         ++i;
     }
 
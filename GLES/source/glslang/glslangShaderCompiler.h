@@ -67,6 +67,8 @@ private:
 
     void CompileAttributes(const glslang::TProgram* prog);
     void CompileUniforms(const glslang::TProgram* prog);
+    bool IsUniformPackable(const uniform_t &uniform) const;
+    void PackUniform(uniform_t *uniform, const glslang::TType *uniformType, uniformBlock_t *pBlock, size_t *offset);
     void SetUniformBlocksOffset(const glslang::TProgram* prog);
     void SetUniformBlocksSizes(const glslang::TProgram* prog);
     void BuildUniformReflection(void);
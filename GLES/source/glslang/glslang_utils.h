@@ -25,6 +25,7 @@
 #define __GLSLANG_UTILS_H__
 
 #include "utils/glsl_types.h"
+#include <vector>
 
 namespace glslang {
     class TShader;
@@ -37,18 +38,23 @@ typedef struct {
 } aggregate_t;
 typedef std::map<std::string, aggregate_t>  aggregateMap_t;
 
+struct uniform_t;
+
 struct uniformBlock_t {
     std::string                     name;                       /// For debug
     std::string                     glslBlockName;              /// Block name that will be generated in final GLSL
     uint32_t                        binding;                    /// layout decoration
     bool                            isOpaque;                   /// true for opaque types (samplers)
+    bool                            isPushConstant;             /// true for the block of push constants
     size_t                          blockSize;                  /// Uniform block's size in bytes (including inactive variables)
     shader_type_t                   blockStage;                 /// Uniform block's shader stage
     const aggregate_t *             pAggregate;
+    std::vector<const uniform_t *>  packedUniforms;             /// Loose uniforms packed into the default uniform block, in declaration order
 
     uniformBlock_t():
         binding(0),
         isOpaque(false),
+        isPushConstant(false),
         blockSize(0),
         blockStage(INVALID_SHADER),
         pAggregate(nullptr)
@@ -60,6 +66,7 @@ struct uniformBlock_t {
        glslBlockName(gbn),
        binding(b),
        isOpaque(io),
+       isPushConstant(false),
        blockSize(bs),
        blockStage(bStage),
        pAggregate(pAggr)
@@ -86,6 +93,7 @@ struct uniform_t {
     uniformBlock_t *                pBlock;                     /// Pointer to uniformBlock_t this uniform belongs
     shader_type_t                   stage;                      /// Uniform's shader stage
     size_t                          offset;                     /// Offset from start of uniform block's data
+    std::string                     declaration;                /// Member declaration (if packed into the default uniform block)
 
     uniform_t()
      : glType(0),
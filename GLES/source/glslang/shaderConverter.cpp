@@ -255,6 +255,17 @@ ShaderConverter::ProcessUniforms(std::string& source, const uniformBlockMap_t &u
     std::string layoutSyntax;
     std::string blockSyntax;
 
+    /// Loose uniforms packed together, if any
+    std::vector<const uniformBlock_t *> packedBlocks;
+    uniBlockIt = uniformBlockMap.find(std::string(STRINGIFY_MACRO(GLOVE_DEFAULT_UNIFORM_BLOCK)));
+    if(uniBlockIt != uniformBlockMap.cend()) {
+        packedBlocks.push_back(&uniBlockIt->second);
+    }
+    uniBlockIt = uniformBlockMap.find(std::string(STRINGIFY_MACRO(GLOVE_PUSH_CONSTANT_BLOCK)));
+    if(uniBlockIt != uniformBlockMap.cend()) {
+        packedBlocks.push_back(&uniBlockIt->second);
+    }
+
     /// Convert uniforms into uniform blocks
     std::string token;
     const std::string uniformLiteralStr("uniform");
@@ -353,6 +364,24 @@ ShaderConverter::ProcessUniforms(std::string& source, const uniformBlockMap_t &u
             token = std::string("gl_DepthRange");
         }
 
+        /// Packed uniforms are declared in the default uniform block or the push constant block instead
+        bool isPacked = false;
+        for(const auto block : packedBlocks) {
+            for(const auto uni : block->packedUniforms) {
+                if(!uni->variableName.compare(0, uni->variableName.find_first_of("["), token)) {
+                    isPacked = true;
+                    break;
+                }
+            }
+        }
+
+        if(isPacked) {
+            found = source.find(";", found);
+            source.erase(f1, found + 1 - f1);
+            found = FindToken(uniformLiteralStr, source, f1);
+            continue;
+        }
+
         /// Construct uniform block
         uniBlockIt = uniformBlockMap.find(token);
         if(uniBlockIt != uniformBlockMap.cend()) {
@@ -381,6 +410,29 @@ ShaderConverter::ProcessUniforms(std::string& source, const uniformBlockMap_t &u
 
         found = FindToken(uniformLiteralStr, source, found);
     }
+
+    /// Declare the packed blocks on the empty line that closes the header,
+    /// so that they precede all user code and line numbers stay the same
+    blockSyntax = std::string("");
+    for(const auto block : packedBlocks) {
+        if(!(block->blockStage & mShaderType)) {
+            continue;
+        }
+
+        layoutSyntax = block->isPushConstant ? std::string("layout(push_constant) ") :
+                                               "layout(" + mMemLayoutQualifier + ", binding = " + std::to_string(block->binding) + std::string(") ");
+        blockSyntax += layoutSyntax + uniformLiteralStr + " " + block->glslBlockName + std::string(" {");
+        for(const auto uni : block->packedUniforms) {
+            blockSyntax += std::string(" ") + uni->declaration;
+        }
+        blockSyntax += std::string(" }; ");
+    }
+
+    if(!blockSyntax.empty()) {
+        found = source.find(shaderLimitsBuiltIns);
+        assert(found != std::string::npos);
+        source.insert(found + strlen(shaderLimitsBuiltIns) - 1, blockSyntax);
+    }
 }
 
 void
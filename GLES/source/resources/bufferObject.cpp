@@ -29,14 +29,36 @@
 
 #include "bufferObject.h"
 #include "vulkan/memory.h"
+#include "utils/cacheManager.h"
+
+// Number of updates, each less than GLOVE_BUFFER_IDLE_SERIALS submissions
+// apart, after which a buffer is considered hot and kept host visible
+#define GLOVE_BUFFER_HOT_UPDATES                        4
+
+// Number of submissions without updates after which a hot buffer cools down
+// and is placed in the tier of its usage hint again
+#define GLOVE_BUFFER_IDLE_SERIALS                       64
+
+// Offset alignment of the staged buffer uploads
+#define GLOVE_STAGING_BUFFER_ALIGNMENT                  4
+
+// Updates up to this size are recorded inline with vkCmdUpdateBuffer instead
+// of being staged. It must not exceed 65536 bytes and 0 disables them
+#define GLOVE_INLINE_BUFFER_UPDATE_SIZE                 1024
 
 BufferObject::BufferObject(const vulkanAPI::vkContext_t *vkContext, const VkBufferUsageFlags vkBufferUsageFlags, const VkSharingMode vkSharingMode, const VkFlags vkFlags)
-: mVkContext(vkContext), mUsage(GL_STATIC_DRAW), mTarget(GL_INVALID_VALUE), mAllocated(false)
+: mVkContext(vkContext), mUsage(GL_STATIC_DRAW), mTarget(GL_INVALID_VALUE), mAllocated(false),
+  mCommandBufferManager(nullptr), mCacheManager(nullptr),
+  mVkFlags(vkFlags), mDeviceLocal(false), mReadSerial(0), mWriteSerial(0), mHostShadowed(false)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
     mBuffer = new vulkanAPI::Buffer(vkContext, vkBufferUsageFlags, vkSharingMode);
     mMemory = new vulkanAPI::Memory(vkContext, vkFlags);
+
+    // transfer buffers only live for the copy they serve
+    mMemory->SetCategory((vkBufferUsageFlags & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) ?
+                         vulkanAPI::DEVICE_MEMORY_CATEGORY_VERTEX_INDEX : vulkanAPI::DEVICE_MEMORY_CATEGORY_TRANSIENT);
 }
 
 BufferObject::~BufferObject()
@@ -57,27 +79,395 @@ BufferObject::Release()
     mAllocated = false;
 }
 
+void
+BufferObject::SetReadSerial(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mCommandBufferManager != nullptr) {
+        mReadSerial = mCommandBufferManager->GetActiveSerial();
+    }
+}
+
+bool
+BufferObject::IsPending(uint64_t serial) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return mCommandBufferManager != nullptr && serial > mCommandBufferManager->GetCompletedSerial();
+}
+
+BufferUpdateTracker::BufferUpdateTracker()
+: mUpdateCount(0), mUpdateSerial(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+void
+BufferUpdateTracker::TrackUpdate(uint64_t serial)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the update count saturates while updates keep coming and a long idle
+    // period starts it over, so that buffers do not bounce between tiers.
+    // The first data specification is never an idle gap.
+    if(mUpdateSerial != 0 && serial - mUpdateSerial >= GLOVE_BUFFER_IDLE_SERIALS) {
+        mUpdateCount = 1;
+    } else if(mUpdateCount < GLOVE_BUFFER_HOT_UPDATES) {
+        ++mUpdateCount;
+    }
+    mUpdateSerial = serial;
+}
+
+bool
+BufferUpdateTracker::PreferDeviceLocal(GLenum usage) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // dynamic and stream buffers stay host visible, static ones leave
+    // device local memory only while they are updated frequently
+    return usage == GL_STATIC_DRAW && mUpdateCount < GLOVE_BUFFER_HOT_UPDATES;
+}
+
+void
+BufferObject::TrackUpdate(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mCommandBufferManager == nullptr) {
+        return;
+    }
+
+    mUpdateTracker.TrackUpdate(mCommandBufferManager->GetActiveSerial());
+}
+
+bool
+BufferObject::PreferDeviceLocal(void) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // staged copies are recorded in the upload command buffer, and released
+    // buffers must be kept alive by the cache manager until it has executed
+    if(mCommandBufferManager == nullptr || mCacheManager == nullptr) {
+        return false;
+    }
+
+    return mUpdateTracker.PreferDeviceLocal(mUsage);
+}
+
 bool
 BufferObject::Allocate(size_t size, const void *data)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    TrackUpdate();
+
+    // re-specifying the data store orphans the current one, which the cache
+    // manager keeps alive until the submissions reading it have completed
+    if(mAllocated) {
+        Release();
+    }
+
+    const bool result = AllocateStorage(size, data);
+    UpdateHostShadow(size, 0, data);
+
+    return result;
+}
+
+bool
+BufferObject::AllocateStorage(size_t size, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // buffers updated through the command stream are transfer destinations,
+    // and transfer sources for readbacks and renaming, whatever their tier
+    if(mCommandBufferManager != nullptr) {
+        mBuffer->SetFlags(mBuffer->GetFlags() | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    }
+
+    mDeviceLocal = PreferDeviceLocal();
+    mMemory->SetFlags(mDeviceLocal ? static_cast<VkFlags>(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) : mVkFlags);
+    mReadSerial  = 0;
+    mWriteSerial = 0;
+
     mBuffer->SetSize(size);
 
     mAllocated = mBuffer->Create()                                            &&
                  mMemory->GetBufferMemoryRequirements(mBuffer->GetVkBuffer()) &&
                  mMemory->Create()                                            &&
-                 mMemory->SetData(size, 0, data)                              &&
-                 mMemory->BindBufferMemory(mBuffer->GetVkBuffer());
+                 mMemory->BindBufferMemory(mBuffer->GetVkBuffer())            &&
+                 WriteData(size, 0, data);
     return mAllocated;
 }
 
+bool
+BufferObject::WriteData(size_t size, size_t offset, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the host only writes contents that no unfinished submission accesses
+    if(mMemory->IsHostVisible() && !IsPending(mReadSerial) && !IsPending(mWriteSerial)) {
+        return mMemory->SetData(size, offset, data);
+    }
+
+    return UploadData(size, offset, data);
+}
+
+bool
+BufferObject::UploadData(size_t size, size_t offset, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // small updates travel inside the command buffer itself
+    const bool inlined = data != nullptr && size <= GLOVE_INLINE_BUFFER_UPDATE_SIZE &&
+                         !(size & 3) && !(offset & 3);
+
+    // reserve the staging range first, as a full ring flushes the upload command buffer
+    VkBuffer     stagingBuffer = VK_NULL_HANDLE;
+    VkDeviceSize stagingOffset = 0;
+    const bool   staged = data != nullptr && !inlined &&
+                          mCommandBufferManager->AllocateStagingMemory(size, GLOVE_STAGING_BUFFER_ALIGNMENT, data, &stagingBuffer, &stagingOffset);
+
+    // uploads that do not fit in the staging ring are copied synchronously from a buffer of their own
+    BufferObject    *tbo = nullptr;
+    VkCommandBuffer  cmdBuffer;
+    if(data != nullptr && !inlined && !staged) {
+        tbo = new TransferSrcBufferObject(mVkContext);
+        if(!tbo->Allocate(size, data)) {
+            delete tbo;
+            return false;
+        }
+        stagingBuffer = tbo->GetVkBuffer();
+
+        mCommandBufferManager->BeginVkAuxCommandBuffer();
+        cmdBuffer = mCommandBufferManager->GetAuxCommandBuffer();
+    } else {
+        VkCommandBuffer *uploadCmdBuffer = mCommandBufferManager->BeginVkUploadCommandBuffer();
+        if(uploadCmdBuffer == nullptr) {
+            return false;
+        }
+        cmdBuffer = *uploadCmdBuffer;
+        mWriteSerial = mCommandBufferManager->GetActiveSerial();
+    }
+
+    // the copy must neither overwrite data still read by earlier submissions
+    // nor be reordered with earlier transfers, and later draws must see its result
+    VkMemoryBarrier barrier;
+    barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.pNext         = nullptr;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    if(inlined) {
+        vkCmdUpdateBuffer(cmdBuffer, mBuffer->GetVkBuffer(), offset, size, data);
+    } else if(data != nullptr) {
+        VkBufferCopy region;
+        region.srcOffset = stagingOffset;
+        region.dstOffset = offset;
+        region.size      = size;
+        vkCmdCopyBuffer(cmdBuffer, stagingBuffer, mBuffer->GetVkBuffer(), 1, &region);
+    } else {
+        vkCmdFillBuffer(cmdBuffer, mBuffer->GetVkBuffer(), 0, VK_WHOLE_SIZE, 0);
+    }
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    if(tbo != nullptr) {
+        mCommandBufferManager->EndVkAuxCommandBuffer();
+        mCommandBufferManager->SubmitVkAuxCommandBuffer();
+        mCommandBufferManager->WaitVkAuxCommandBuffer();
+
+        delete tbo;
+        mWriteSerial = 0;
+    }
+
+    return true;
+}
+
+bool
+BufferObject::ReadbackData(size_t size, size_t offset, void *data) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    BufferObject *tbo = new TransferDstBufferObject(mVkContext);
+    if(!tbo->Allocate(size, nullptr)) {
+        delete tbo;
+        return false;
+    }
+
+    // pending uploads to this buffer are submitted ahead of the aux command buffer
+    mCommandBufferManager->BeginVkAuxCommandBuffer();
+    VkCommandBuffer cmdBuffer = mCommandBufferManager->GetAuxCommandBuffer();
+    {
+        VkBufferCopy region;
+        region.srcOffset = offset;
+        region.dstOffset = 0;
+        region.size      = size;
+        vkCmdCopyBuffer(cmdBuffer, mBuffer->GetVkBuffer(), tbo->GetVkBuffer(), 1, &region);
+
+        VkMemoryBarrier barrier;
+        barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.pNext         = nullptr;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+    mCommandBufferManager->EndVkAuxCommandBuffer();
+    mCommandBufferManager->SubmitVkAuxCommandBuffer();
+    mCommandBufferManager->WaitVkAuxCommandBuffer();
+
+    const bool result = tbo->GetData(size, 0, data);
+    delete tbo;
+
+    return result;
+}
+
+bool
+BufferObject::Migrate(size_t size, size_t offset, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the update is merged with the current contents, which are only
+    // read back when the update does not cover the whole buffer
+    if(data == nullptr) {
+        return false;
+    }
+
+    const size_t bufferSize = mBuffer->GetSize();
+    uint8_t *contents = new uint8_t[bufferSize];
+    if(size != bufferSize && !GetData(bufferSize, 0, contents)) {
+        delete[] contents;
+        return false;
+    }
+    memcpy(contents + offset, data, size);
+
+    Release();
+    const bool result = AllocateStorage(bufferSize, contents);
+    delete[] contents;
+
+    return result;
+}
+
+bool
+BufferObject::Rename(size_t size, size_t offset, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // without the cache manager, the old data store could not outlive the draws reading it
+    if(mCacheManager == nullptr || data == nullptr) {
+        return false;
+    }
+
+    vulkanAPI::Buffer *oldBuffer = mBuffer;
+    vulkanAPI::Memory *oldMemory = mMemory;
+
+    mBuffer = new vulkanAPI::Buffer(mVkContext, oldBuffer->GetFlags(), oldBuffer->GetSharingMode());
+    mMemory = new vulkanAPI::Memory(mVkContext, oldMemory->GetFlags());
+    mMemory->SetCategory(oldMemory->GetCategory());
+    mBuffer->SetCacheManager(mCacheManager);
+    mMemory->SetCacheManager(mCacheManager);
+    mBuffer->SetSize(oldBuffer->GetSize());
+
+    if(!mBuffer->Create()                                            ||
+       !mMemory->GetBufferMemoryRequirements(mBuffer->GetVkBuffer()) ||
+       !mMemory->Create()                                            ||
+       !mMemory->BindBufferMemory(mBuffer->GetVkBuffer())) {
+        delete mBuffer;
+        delete mMemory;
+        mBuffer = oldBuffer;
+        mMemory = oldMemory;
+        return false;
+    }
+
+    // the current contents are carried over on the host, unless the command
+    // stream still writes them or they are not host visible
+    const size_t bufferSize = oldBuffer->GetSize();
+    void *oldData = nullptr;
+    mReadSerial = 0;
+    if(oldMemory->IsHostVisible() && mMemory->IsHostVisible() && !IsPending(mWriteSerial) &&
+       oldMemory->GetMappedData(0, &oldData)) {
+        mWriteSerial = 0;
+        mMemory->SetData(bufferSize, 0, oldData);
+        mMemory->SetData(size, offset, data);
+    } else {
+        VkCommandBuffer *uploadCmdBuffer = mCommandBufferManager->BeginVkUploadCommandBuffer();
+        if(uploadCmdBuffer != nullptr) {
+            VkBufferCopy region;
+            region.srcOffset = 0;
+            region.dstOffset = 0;
+            region.size      = bufferSize;
+            vkCmdCopyBuffer(*uploadCmdBuffer, oldBuffer->GetVkBuffer(), mBuffer->GetVkBuffer(), 1, &region);
+        }
+        UploadData(size, offset, data);
+    }
+
+    // the old data store is retired by fence through the cache manager
+    oldBuffer->Release();
+    oldMemory->Release();
+    delete oldBuffer;
+    delete oldMemory;
+
+    return true;
+}
+
 bool
 BufferObject::GetData(size_t size, size_t offset, void *data) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    return mMemory->GetData(size, offset, data);
+    // contents still written by the command stream are read back after it
+    if(mMemory->IsHostVisible() && !IsPending(mWriteSerial)) {
+        return mMemory->GetData(size, offset, data);
+    }
+
+    // device local contents needed on the CPU, e.g. for index or vertex
+    // conversions, are read back once and then shadowed on the host, so
+    // that the draws using them do not stall on a readback each
+    if(mDeviceLocal && !mHostShadowed) {
+        mHostShadow.resize(GetSize());
+        mHostShadowed = ReadbackData(GetSize(), 0, mHostShadow.data());
+    }
+
+    if(mHostShadowed && offset + size <= mHostShadow.size()) {
+        memcpy(data, mHostShadow.data() + offset, size);
+        return true;
+    }
+
+    return ReadbackData(size, offset, data);
+}
+
+void
+BufferObject::UpdateHostShadow(size_t size, size_t offset, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mHostShadowed) {
+        return;
+    }
+
+    // host visible contents are read directly
+    if(!mDeviceLocal) {
+        mHostShadowed = false;
+        std::vector<uint8_t>().swap(mHostShadow);
+        return;
+    }
+
+    mHostShadow.resize(GetSize());
+    if(offset + size > mHostShadow.size()) {
+        return;
+    }
+
+    if(data != nullptr) {
+        memcpy(mHostShadow.data() + offset, data, size);
+    } else {
+        memset(mHostShadow.data() + offset, 0, size);
+    }
 }
 
 void
@@ -85,7 +475,24 @@ BufferObject::UpdateData(size_t size, size_t offset, const void *data)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mMemory->UpdateData(size, offset, data);
+    TrackUpdate();
+
+    // move the buffer to the tier matching its observed update frequency
+    if(mAllocated && mDeviceLocal != PreferDeviceLocal() && Migrate(size, offset, data)) {
+        UpdateHostShadow(size, offset, data);
+        return;
+    }
+
+    // draws already recorded in the active command buffer must keep reading
+    // the current contents, so the update goes to a fresh data store
+    if(mAllocated && mCommandBufferManager != nullptr && mReadSerial == mCommandBufferManager->GetActiveSerial() &&
+       Rename(size, offset, data)) {
+        UpdateHostShadow(size, offset, data);
+        return;
+    }
+
+    WriteData(size, offset, data);
+    UpdateHostShadow(size, offset, data);
 }
 
 void
@@ -98,13 +505,13 @@ BufferObject::SetTarget(GLenum target)
     if(mTarget != target && mTarget != GL_INVALID_VALUE) {
         VkBufferUsageFlags combinedBuffers =
                 static_cast<VkBufferUsageFlags>(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
-        if(mBuffer->GetFlags() != combinedBuffers && mAllocated == true) {
+        if((mBuffer->GetFlags() & combinedBuffers) != combinedBuffers && mAllocated == true) {
             size_t size = mBuffer->GetSize();
             uint8_t *srcData = new uint8_t[size];
             this->GetData(size, 0, srcData);
             this->Release();
             mBuffer->SetFlags(combinedBuffers);
-            this->Allocate(size, srcData);
+            this->AllocateStorage(size, srcData);
             delete[] srcData;
         }
     } else if(target == GL_ARRAY_BUFFER) {
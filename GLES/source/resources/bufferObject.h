@@ -27,9 +27,26 @@
 #include "GLES2/gl2.h"
 #include "vulkan/memory.h"
 #include "vulkan/buffer.h"
+#include "vulkan/cbManager.h"
+#include <vector>
 
 class CacheManager;
 
+/// Observes the updates of a buffer to pick the memory tier it belongs in
+class BufferUpdateTracker {
+private:
+    uint32_t                mUpdateCount;
+    uint64_t                mUpdateSerial;
+
+public:
+                            BufferUpdateTracker();
+
+    void                    TrackUpdate(uint64_t serial);
+    bool                    PreferDeviceLocal(GLenum usage)             const;
+
+    inline uint32_t         GetUpdateCount(void)                        const   { FUN_ENTRY(GL_LOG_TRACE); return mUpdateCount; }
+};
+
 class BufferObject {
 private:
     const
@@ -42,6 +59,31 @@ private:
     vulkanAPI::Memory*      mMemory;
     vulkanAPI::Buffer*      mBuffer;
 
+    vulkanAPI::CommandBufferManager *mCommandBufferManager;
+    CacheManager*           mCacheManager;
+
+    VkFlags                 mVkFlags;
+    bool                    mDeviceLocal;
+    BufferUpdateTracker     mUpdateTracker;
+    uint64_t                mReadSerial;
+    uint64_t                mWriteSerial;
+
+    // host copy of device local contents that are read on the CPU
+    mutable
+    std::vector<uint8_t>    mHostShadow;
+    mutable bool            mHostShadowed;
+
+    void                    TrackUpdate(void);
+    bool                    PreferDeviceLocal(void)                     const;
+    bool                    AllocateStorage(size_t size, const void *data);
+    bool                    Migrate(size_t size, size_t offset, const void *data);
+    bool                    Rename(size_t size, size_t offset, const void *data);
+    bool                    WriteData(size_t size, size_t offset, const void *data);
+    bool                    UploadData(size_t size, size_t offset, const void *data);
+    bool                    ReadbackData(size_t size, size_t offset, void *data) const;
+    void                    UpdateHostShadow(size_t size, size_t offset, const void *data);
+    bool                    IsPending(uint64_t serial)                  const;
+
 public:
     explicit                BufferObject(const vulkanAPI::vkContext_t *vkContext          = nullptr,
                                          const VkBufferUsageFlags      vkBufferUsageFlags = VK_NULL_HANDLE,
@@ -68,15 +110,20 @@ public:
 
 // Set Functions
     void                    SetTarget(GLenum target);
+    void                    SetReadSerial(void);
     inline void             SetUsage(GLenum usage)                                { FUN_ENTRY(GL_LOG_TRACE); mUsage     = usage; }
     inline void             SetVkContext(const vulkanAPI::vkContext_t *vkContext) { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext;
                                                                                                              mBuffer->SetContext(vkContext);
                                                                                                              mMemory->SetContext(vkContext); }
-    inline void             SetCacheManager(CacheManager *cacheManager)           { FUN_ENTRY(GL_LOG_TRACE); mBuffer->SetCacheManager(cacheManager);
+    inline void             SetCacheManager(CacheManager *cacheManager)           { FUN_ENTRY(GL_LOG_TRACE); mCacheManager = cacheManager;
+                                                                                                             mBuffer->SetCacheManager(cacheManager);
                                                                                                              mMemory->SetCacheManager(cacheManager); }
+    inline void             SetCommandBufferManager(
+                                vulkanAPI::CommandBufferManager *cbManager)     { FUN_ENTRY(GL_LOG_TRACE); mCommandBufferManager = cbManager; }
 // Has/Is Functions
     inline bool             HasData(void)                               const   { FUN_ENTRY(GL_LOG_TRACE); return mBuffer->GetVkBuffer() != VK_NULL_HANDLE; }
     inline bool             IsIndexBuffer(void)                         const   { FUN_ENTRY(GL_LOG_TRACE); return mBuffer->GetFlags() & VK_BUFFER_USAGE_INDEX_BUFFER_BIT; }
+    inline bool             IsDeviceLocal(void)                         const   { FUN_ENTRY(GL_LOG_TRACE); return mDeviceLocal; }
 };
 
 class IndexBufferObject : public BufferObject
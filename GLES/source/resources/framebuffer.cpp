@@ -421,8 +421,12 @@ Framebuffer::BeginVkRenderPass()
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // transitions requested since the previous render pass go right before this one
+    mCommandBufferManager->FlushDrawBarrier();
+
     VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
-    mRenderPass->Begin(&activeCmdBuffer, mFramebuffers[mWriteBufferIndex]->GetFramebuffer(), true);
+    mRenderPass->Begin(&activeCmdBuffer, mFramebuffers[mWriteBufferIndex]->GetFramebuffer(), !mCommandBufferManager->IsInlineRecording());
+    mCommandBufferManager->SetRenderPassActive(true);
 }
 
 bool
@@ -431,7 +435,13 @@ Framebuffer::EndVkRenderPass(void)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     VkCommandBuffer activeCmdBuffer = mCommandBufferManager->GetActiveCommandBuffer();
-    return mRenderPass->End(&activeCmdBuffer);
+    if(!mRenderPass->End(&activeCmdBuffer)) {
+        return false;
+    }
+
+    mCommandBufferManager->SetRenderPassActive(false);
+
+    return true;
 }
 
 void
@@ -455,6 +465,7 @@ Framebuffer::Create(void)
 
     for(uint32_t i = 0; i < mAttachmentColors.size(); ++i) {
         vulkanAPI::Framebuffer *frameBuffer = new vulkanAPI::Framebuffer(mVkContext);
+        frameBuffer->SetCacheManager(mCacheManager);
 
         std::vector<VkImageView> imageViews;
         if(GetColorAttachmentTexture(i)) {
@@ -28,11 +28,14 @@
 #include "genericVertexAttribute.h"
 #include "utils/glUtils.h"
 
+#define GLOVE_STREAMING_VERTEX_ALIGNMENT                16
+
 GenericVertexAttribute::GenericVertexAttribute()
 : mElements(4), mType(GL_FLOAT), mNormalized(false), mStride(0), mEnabled(false),
   mOffset(0), mPtr(0),
   mInternalVbo(nullptr), mExternalVbo(nullptr),
-  mInternalVBOStatus(true), mCacheManager(nullptr)
+  mInternalVBOStatus(true), mCacheManager(nullptr), mCommandBufferManager(nullptr),
+  mStreamVkBuffer(VK_NULL_HANDLE), mStreamOffset(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -50,7 +53,7 @@ GenericVertexAttribute::~GenericVertexAttribute()
 }
 
 BufferObject*
-GenericVertexAttribute::UpdateVertexAttribute(uint32_t numVertices, bool& updatedVBO)
+GenericVertexAttribute::UpdateVertexAttribute(uint32_t numVertices, bool closeLoop, bool& updatedVBO)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
@@ -63,31 +66,96 @@ GenericVertexAttribute::UpdateVertexAttribute(uint32_t numVertices, bool& update
         GLsizei stride = GetStride() > 0 ? GetStride() : GetNumElements() * GlAttribTypeToElementSize(GetType());
         SetStride(stride);
 
-        // Create a vbo located on client-space (e.g, glVertexAttribPointer) or
+        // Stream data located on client-space (e.g, glVertexAttribPointer) or
         // attach a vbo lotated on server-space (e.g., glBindBuffer)
-        return IsInternalVBO() ? GenerateUserSpaceVBO(numVertices, updatedVBO) : AttachDeviceSpaceVBO(numVertices, updatedVBO);
+        return IsInternalVBO() ? UpdateUserSpaceData(numVertices, closeLoop, updatedVBO) : AttachDeviceSpaceVBO(numVertices, updatedVBO);
      } else {
         return UpdateGenericValueVBO(updatedVBO);
     }
 }
 
 BufferObject*
-GenericVertexAttribute::GenerateUserSpaceVBO(uint32_t numVertices, bool& updatedVBO)
+GenericVertexAttribute::UpdateUserSpaceData(uint32_t numVertices, bool closeLoop, bool& updatedVBO)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    BufferObject *vbo = new VertexBufferObject(mVkContext);
-    void *srcData = reinterpret_cast<void*>(GetPointer());
-    size_t byteSize = numVertices * GetStride();
+    const void *srcData = reinterpret_cast<const void*>(GetPointer());
+    uint8_t *convertedData = nullptr;
 
     // explicitly convert GL_FIXED to GL_FLOAT
-    if(GetType() != GL_FIXED) {
-        vbo->Allocate(byteSize, srcData);
+    if(GetType() == GL_FIXED) {
+        size_t byteSize = numVertices * GetStride();
+        convertedData = new uint8_t[byteSize];
+        ConvertFixedBufferToFloat(convertedData, byteSize, srcData, numVertices);
+        srcData = convertedData;
+    }
+
+    BufferObject *vbo = nullptr;
+    if(!StreamUserSpaceData(numVertices, srcData, closeLoop, updatedVBO)) {
+        vbo = GenerateUserSpaceVBO(numVertices, srcData, updatedVBO);
+    }
+
+    delete[] convertedData;
+
+    return vbo;
+}
+
+bool
+GenericVertexAttribute::StreamUserSpaceData(uint32_t numVertices, const void *srcData, bool closeLoop, bool& updatedVBO)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mCommandBufferManager) {
+        return false;
+    }
+
+    const size_t byteSize = numVertices * GetStride();
+    const size_t loopSize = closeLoop ? GetStride() : 0;
+
+    // client arrays are appended to the streaming ring, instead of getting a vbo per draw
+    const void *streamData = srcData;
+    uint8_t *loopData = nullptr;
+    if(closeLoop) {
+        loopData = new uint8_t[byteSize + loopSize];
+        memcpy(loopData, srcData, byteSize);
+        memcpy(loopData + byteSize, srcData, loopSize);
+        streamData = loopData;
     }
-    else {
-        ConvertFixedBufferToFloat(vbo, byteSize, srcData, numVertices);
+
+    VkBuffer     buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    bool streamed = mCommandBufferManager->AllocateStreamingMemory(byteSize + loopSize, GLOVE_STREAMING_VERTEX_ALIGNMENT, streamData, &buffer, &offset);
+    delete[] loopData;
+
+    if(!streamed) {
+        return false;
     }
 
+    // offsets are bound along with the buffer, so the pipeline is affected only when the buffer changes
+    updatedVBO      = (buffer != mStreamVkBuffer);
+    mStreamVkBuffer = buffer;
+    mStreamOffset   = offset;
+
+    SetOffset(0);
+    SetCurrentVbo(nullptr);
+    SetInternalVBOStatus(true);
+
+    return true;
+}
+
+BufferObject*
+GenericVertexAttribute::GenerateUserSpaceVBO(uint32_t numVertices, const void *srcData, bool& updatedVBO)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    BufferObject *vbo = new VertexBufferObject(mVkContext);
+    size_t byteSize = numVertices * GetStride();
+
+    vbo->Allocate(byteSize, srcData);
+
+    mStreamVkBuffer = VK_NULL_HANDLE;
+    mStreamOffset   = 0;
+
     SetOffset(0);
     SetCurrentVbo(vbo);
     SetInternalVBOStatus(true);
@@ -107,9 +175,12 @@ GenericVertexAttribute::AttachDeviceSpaceVBO(uint32_t numVertices, bool& updated
     if(GetType() == GL_FIXED) {
         size_t byteSize = vbo->GetSize();
         uint8_t *srcData = new uint8_t[byteSize];
+        uint8_t *dstData = new uint8_t[byteSize];
         vbo->GetData(byteSize, 0, srcData);
+        ConvertFixedBufferToFloat(dstData, byteSize, srcData, numVertices);
         vbo = new VertexBufferObject(mVkContext);
-        ConvertFixedBufferToFloat(vbo, byteSize, srcData, numVertices);
+        vbo->Allocate(byteSize, dstData);
+        delete[] dstData;
         delete[] srcData;
         mCacheManager->CacheVBO(vbo);
         updatedVBO = true;
@@ -130,6 +201,8 @@ GenericVertexAttribute::UpdateGenericValueVBO(bool& updatedVBO)
     //SetNumElements(4);
     SetType(GL_FLOAT);
     SetStride(mElements * GlAttribTypeToElementSize(mType));
+    mStreamVkBuffer = VK_NULL_HANDLE;
+    mStreamOffset   = 0;
     SetCurrentVbo(vbo);
     SetInternalVBOStatus(true);
     updatedVBO = true;
@@ -137,13 +210,12 @@ GenericVertexAttribute::UpdateGenericValueVBO(bool& updatedVBO)
 }
 
 void
-GenericVertexAttribute::ConvertFixedBufferToFloat(BufferObject* vbo, size_t byteSize,
-                                                  void *srcData, size_t numVertices)
+GenericVertexAttribute::ConvertFixedBufferToFloat(uint8_t *dstBuffer, size_t byteSize,
+                                                  const void *srcData, size_t numVertices)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     const uint8_t* srcBuffer = static_cast<const uint8_t*>(srcData);
-    uint8_t* dstBuffer = new uint8_t[byteSize];
 
     // this is needed to preserve data in case the buffer contains
     // other data as well. For efficiency it can be commented out.
@@ -167,9 +239,6 @@ GenericVertexAttribute::ConvertFixedBufferToFloat(BufferObject* vbo, size_t byte
             }
         }
     }
-
-    vbo->Allocate(byteSize, dstBuffer);
-    delete[] dstBuffer;
 }
 
 void
@@ -211,4 +280,5 @@ GenericVertexAttribute::Set(GLint nElements, GLenum type, GLboolean normalized,
     SetOffset(internalVBO ? 0 : reinterpret_cast<uintptr_t>(ptr));
     SetInternalVBOStatus(internalVBO);
     SetCurrentVbo(vbo);
+    mStreamVkBuffer = VK_NULL_HANDLE;
 }
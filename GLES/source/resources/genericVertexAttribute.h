@@ -27,6 +27,7 @@
 #include "bufferObject.h"
 #include "utils/GlToVkConverter.h"
 #include "utils/cacheManager.h"
+#include "vulkan/cbManager.h"
 
 class GenericVertexAttribute {
 private:
@@ -44,15 +45,22 @@ private:
     BufferObject                       *mExternalVbo;
     bool                                mInternalVBOStatus;
     CacheManager                       *mCacheManager;
+    vulkanAPI::CommandBufferManager    *mCommandBufferManager;
+
+    VkBuffer                            mStreamVkBuffer;
+    VkDeviceSize                        mStreamOffset;
+
+    BufferObject                       *GenerateUserSpaceVBO(uint32_t numVertices, const void *srcData, bool &updatedVBO);
+    bool                                StreamUserSpaceData(uint32_t numVertices, const void *srcData, bool closeLoop, bool &updatedVBO);
 
 public:
     GenericVertexAttribute();
     ~GenericVertexAttribute();
 
-    void                                ConvertFixedBufferToFloat(BufferObject* vbo, size_t byteSize, void *srcData, size_t numVertices);
-    BufferObject                       *UpdateVertexAttribute(uint32_t numVertices, bool &updatedVBO);
+    void                                ConvertFixedBufferToFloat(uint8_t *dstBuffer, size_t byteSize, const void *srcData, size_t numVertices);
+    BufferObject                       *UpdateVertexAttribute(uint32_t numVertices, bool closeLoop, bool &updatedVBO);
     BufferObject                       *UpdateGenericValueVBO(bool &updatedVBO);
-    BufferObject                       *GenerateUserSpaceVBO(uint32_t numVertices, bool &updatedVBO);
+    BufferObject                       *UpdateUserSpaceData(uint32_t numVertices, bool closeLoop, bool &updatedVBO);
     BufferObject                       *AttachDeviceSpaceVBO(uint32_t numVertices, bool &updatedVBO);
 
     // Release Functions
@@ -67,6 +75,8 @@ public:
     inline uintptr_t                    GetOffset(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mOffset;     }
     inline uintptr_t                    GetPointer(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mPtr;        }
     inline const BufferObject *         GetExternalVbo(void)              const { FUN_ENTRY(GL_LOG_TRACE); return mExternalVbo;}
+    inline VkBuffer                     GetStreamVkBuffer(void)           const { FUN_ENTRY(GL_LOG_TRACE); return mStreamVkBuffer; }
+    inline VkDeviceSize                 GetStreamOffset(void)             const { FUN_ENTRY(GL_LOG_TRACE); return mStreamOffset; }
 
     inline VkFormat                     GetVkFormat(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return GlAttribPointerToVkFormat(mElements, mType, mNormalized); }
     inline bool                         IsInternalVBO(void)        const { FUN_ENTRY(GL_LOG_TRACE); return mInternalVBOStatus;}
@@ -92,6 +102,7 @@ public:
     inline void                         SetPointer(uintptr_t ptr)                   { FUN_ENTRY(GL_LOG_TRACE); mPtr             = ptr;         }
     inline void                         SetInternalVBOStatus(bool internalVBO)      { FUN_ENTRY(GL_LOG_TRACE); mInternalVBOStatus     = internalVBO; }
     inline void                         SetCacheManager(CacheManager *cacheManager) { FUN_ENTRY(GL_LOG_TRACE); mCacheManager = cacheManager; }
+    inline void                         SetCommandBufferManager(vulkanAPI::CommandBufferManager *cbManager) { FUN_ENTRY(GL_LOG_TRACE); mCommandBufferManager = cbManager; }
     inline void                         SetGenericValue(const GLfloat *ptr)         { FUN_ENTRY(GL_LOG_TRACE); mGenericValue[0] = ptr[0];
                                                                                                                mGenericValue[1] = ptr[1];
                                                                                                                mGenericValue[2] = ptr[2];
@@ -155,6 +155,52 @@ CopyPixelsConvert(
     }
 }
 
+// copies and converts pixels between buffers, a row at a time
+void
+CopyPixelsKernel(
+            const ImageRect* srcRect,
+            const void* srcData,
+            const ImageRect* dstRect,
+            void* dstData,
+            pixelKernel_t kernel)
+{
+
+    // size of an entire row in bytes
+    const uint32_t srcRowStride = srcRect->GetRectAlignedRowInBytes();
+    const uint32_t dstRowStride = dstRect->GetRectAlignedRowInBytes();
+
+    // rectangle offset in the memory block
+    const uint32_t srcCurrentRowIndex = srcRect->GetStartRowIndex(srcRowStride);
+    const uint32_t dstCurrentRowIndex = dstRect->GetStartRowIndex(dstRowStride);
+
+    // obtain ptr locations with the byte offset
+    const uint8_t* srcPtr = static_cast<const uint8_t*>(srcData) + srcCurrentRowIndex;
+    uint8_t* dstPtr = static_cast<uint8_t*>(dstData) + dstCurrentRowIndex;
+
+    const pixelRowKernel_t rowKernel = GetPixelKernel(kernel);
+
+    // rows are contiguous only when the pixel sizes match the ones of the kernel,
+    // otherwise the pixels are converted one by one at the rectangle offsets
+    const uint32_t srcPixelBytes = srcRect->GetPixelByteOffset();
+    const uint32_t dstPixelBytes = dstRect->GetPixelByteOffset();
+    const bool     contiguous    = srcPixelBytes == PixelKernelSrcBytes(kernel) &&
+                                   dstPixelBytes == PixelKernelDstBytes(kernel);
+
+    // perform the conversion
+    for(int row = 0; row < srcRect->height; ++row) {
+        if(contiguous) {
+            rowKernel(srcPtr, dstPtr, srcRect->width);
+        } else {
+            for(int col = 0; col < srcRect->width; ++col) {
+                rowKernel(&srcPtr[col * srcPixelBytes], &dstPtr[col * dstPixelBytes], 1);
+            }
+        }
+        // offset by the number of bytes per row
+        dstPtr = dstPtr + dstRowStride;
+        srcPtr = srcPtr + srcRowStride;
+    }
+}
+
 // copies pixels between two buffers
 // buffers must have the same format but may have different alignment
 void
@@ -211,20 +257,20 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToRGBA);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_BGRA_TO_RGBA);
             break;
         case GL_LUMINANCE_ALPHA:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToLuminanceAlpha);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_BGRA_TO_LUMINANCE_ALPHA);
             break;
         case GL_LUMINANCE:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToLuminance);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_BGRA_TO_LUMINANCE);
             break;
         case GL_ALPHA:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToAlpha);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_BGRA_TO_ALPHA);
             break;
         case GL_RGB:
         case GL_RGB8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromBGRA, &Color::ConvertToRGB);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_BGRA_TO_RGB);
             break;
 
         default: NOT_FOUND_ENUM(dstFormat); break;
@@ -239,10 +285,10 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
             break;
         case GL_RGB:
         case GL_RGB8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGBA, &Color::ConvertToRGB);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_RGBA_TO_RGB);
             break;
         case GL_ALPHA:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGBA, &Color::ConvertToAlpha);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_RGBA_TO_ALPHA);
             break;
 
         default: NOT_FOUND_ENUM(dstFormat); break;
@@ -257,7 +303,7 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
             CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
             break;
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromRGB, &Color::ConvertToRGBA);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_RGB_TO_RGBA);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -269,11 +315,11 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
             CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
             break;
         case GL_LUMINANCE:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminanceAlpha, &Color::ConvertToLuminance);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_LUMINANCE_ALPHA_TO_LUMINANCE);
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminanceAlpha, &Color::ConvertToRGBA);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_LUMINANCE_ALPHA_TO_RGBA);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -285,11 +331,11 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
             CopyPixelsNoConversion(srcRect, srcData, dstRect, dstData);
             break;
         case GL_LUMINANCE_ALPHA:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminance, &Color::ConvertToLuminanceAlpha);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_LUMINANCE_TO_LUMINANCE_ALPHA);
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromLuminance, &Color::ConvertToRGBA);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_LUMINANCE_TO_RGBA);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -302,7 +348,7 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::FromAlpha, &Color::ConvertToRGBA);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_ALPHA_TO_RGBA);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -315,7 +361,7 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From4444, &Color::ConvertToRGBA);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_4444_TO_RGBA);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -328,7 +374,7 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
             break;
         case GL_RGBA:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From5551, &Color::ConvertToRGBA);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_5551_TO_RGBA);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
@@ -342,10 +388,10 @@ ConvertPixels(GLenum srcFormat, GLenum dstFormat,
         case GL_RGBA:
         case GL_RGB8_OES:
         case GL_RGBA8_OES:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From565, &Color::ConvertToRGBA);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_565_TO_RGBA);
             break;
         case GL_LUMINANCE:
-            CopyPixelsConvert(srcRect, srcData, dstRect, dstData, &Color::From565, &Color::ConvertToLuminance);
+            CopyPixelsKernel(srcRect, srcData, dstRect, dstData, PIXEL_KERNEL_565_TO_LUMINANCE);
             break;
         default: NOT_FOUND_ENUM(dstFormat); break;
         }
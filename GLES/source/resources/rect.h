@@ -29,6 +29,7 @@
 #include <cmath>
 #include <algorithm>
 #include "utils/color.hpp"
+#include "utils/pixelKernels.h"
 
 class Rect {
 
@@ -85,6 +86,12 @@ void                    CopyPixelsConvert(
                         void* dstData,
                         Color (*SrcColorFunPtr)(const uint8_t*),
                         void (*DstColorFunPtr)(Color&, uint8_t*));
+void                    CopyPixelsKernel(
+                        const ImageRect* srcRect,
+                        const void* srcData,
+                        const ImageRect* dstRect,
+                        void* dstData,
+                        pixelKernel_t kernel);
 void                    ConvertPixels(GLenum srcFormat , GLenum dstFormat,
                         ImageRect* srcRect,
                         const void* srcData,
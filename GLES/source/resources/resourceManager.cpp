@@ -109,6 +109,9 @@ ResourceManager::UpdateFramebufferObjects(GLuint index, GLenum target)
     auto &objects = mFramebuffers.GetObjects();
     for (uint32_t i = 0; i < objects.Size(); ++i) {
         Framebuffer *fb = objects[i];
+        if(!fb) {
+            continue;
+        }
         if((fb->GetColorAttachmentType()   == target && index == fb->GetColorAttachmentName()) ||
            (fb->GetDepthAttachmentType()   == target && index == fb->GetDepthAttachmentName()) ||
            (fb->GetStencilAttachmentType() == target && index == fb->GetStencilAttachmentName())) {
@@ -125,7 +128,7 @@ ResourceManager::IsTextureAttachedToFBO(const Texture *texture)
     auto &objects = mFramebuffers.GetObjects();
     for (uint32_t i = 0; i < objects.Size(); ++i) {
         Framebuffer *fb = objects[i];
-        if(fb->GetColorAttachmentType() == GL_TEXTURE && texture == fb->GetColorAttachmentTexture()) {
+        if(fb && fb->GetColorAttachmentType() == GL_TEXTURE && texture == fb->GetColorAttachmentTexture()) {
             return true;
         }
     }
@@ -141,6 +144,8 @@ ResourceManager::ResetShaderProgramDescSetsState(void)
     ObjectArray<ShaderProgram> *shaderProgramArray = GetShaderProgramArray();
     auto &objects = shaderProgramArray->GetObjects();
     for (uint32_t i = 0; i < objects.Size(); ++i) {
-        objects[i]->MoveUsingDescriptorSetsToPending();
+        if(objects[i]) {
+            objects[i]->MoveUsingDescriptorSetsToPending();
+        }
     }
 }
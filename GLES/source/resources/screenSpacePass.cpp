@@ -337,7 +337,7 @@ ScreenSpacePass::BindPipeline(const VkCommandBuffer *cmdBuffer) const
     FUN_ENTRY(GL_LOG_DEBUG);
 
 
-    mPipeline->Bind(cmdBuffer);
+    mPipeline->Bind(cmdBuffer, mCommandBufferManager->GetBindState());
 }
 
 void
@@ -346,7 +346,7 @@ ScreenSpacePass::BindVertexBuffers(const VkCommandBuffer *cmdBuffer) const
     FUN_ENTRY(GL_LOG_DEBUG);
 
     // bind vertex buffers
-    vkCmdBindVertexBuffers(*cmdBuffer, 0, 1, &mVertexVkBuffer, &mVertexVkBufferOffset);
+    mCommandBufferManager->GetBindState()->BindVertexBuffers(cmdBuffer, 1, &mVertexVkBuffer, &mVertexVkBufferOffset);
 }
 
 void
@@ -356,8 +356,19 @@ ScreenSpacePass::BindUniformDescriptors(const VkCommandBuffer *cmdBuffer) const
 
     mShaderData.shaderProgram->UpdateDescriptorSet();
     mShaderData.shaderProgram->UpdateBuiltInUniformData(0.0f, 1.0f);
-    vkCmdBindDescriptorSets(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mShaderData.shaderProgram->GetVkPipelineLayout(), 0, 1,
-                            mShaderData.shaderProgram->GetVkDescSet(), 0, nullptr);
+    if(*mShaderData.shaderProgram->GetVkDescSet()) {
+        mCommandBufferManager->GetBindState()->BindDescriptorSet(cmdBuffer, mShaderData.shaderProgram->GetVkPipelineLayout(),
+                                                                 *mShaderData.shaderProgram->GetVkDescSet(),
+                                                                 mShaderData.shaderProgram->GetDynamicOffsetCount(),
+                                                                 mShaderData.shaderProgram->GetDynamicOffsets());
+    }
+
+    const ShaderResourceInterface::uniformBlock *pushConstantBlock = mShaderData.shaderProgram->GetPushConstantBlock();
+    if(pushConstantBlock) {
+        mCommandBufferManager->GetBindState()->PushConstants(cmdBuffer, mShaderData.shaderProgram->GetVkPipelineLayout(),
+                                                             mShaderData.shaderProgram->GetPushConstantStages(),
+                                                             static_cast<uint32_t>(pushConstantBlock->blockSize), pushConstantBlock->pClientData);
+    }
 }
 
 void
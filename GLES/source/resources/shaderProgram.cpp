@@ -28,6 +28,7 @@
 
 #include "shaderProgram.h"
 #include "context/context.h"
+#include <algorithm>
 #include <iterator>
 
 ShaderProgram::ShaderProgram(const vulkanAPI::vkContext_t *vkContext, vulkanAPI::CommandBufferManager *cbManager)
@@ -40,6 +41,7 @@ ShaderProgram::ShaderProgram(const vulkanAPI::vkContext_t *vkContext, vulkanAPI:
 
     for (auto& gva : mGenericVertexAttributes) {
         gva.SetVkContext(vkContext);
+        gva.SetCommandBufferManager(cbManager);
     }
 
     mCommandBufferManager = cbManager;
@@ -62,6 +64,10 @@ ShaderProgram::ShaderProgram(const vulkanAPI::vkContext_t *vkContext, vulkanAPI:
     mVkDescSet = VK_NULL_HANDLE;
     mVkPipelineLayout = VK_NULL_HANDLE;
 
+    mDynamicOffsetCount = 0;
+    mUniformDataSerial = 0;
+    mPushConstantStages = 0;
+
     mPipelineCache = new vulkanAPI::PipelineCache(mVkContext);
 
     mStageCount = 0;
@@ -73,6 +79,7 @@ ShaderProgram::ShaderProgram(const vulkanAPI::vkContext_t *vkContext, vulkanAPI:
     mIsPrecompiled = false;
     mValidated = false;
     mActiveVertexVkBuffersCount = 0;
+    memset(mActiveVertexVkBuffersOffsets, 0, sizeof(mActiveVertexVkBuffersOffsets));
     mActiveIndexVkBuffer = VK_NULL_HANDLE;
     mExplicitIbo = nullptr;
 
@@ -522,20 +529,25 @@ ShaderProgram::AllocateExplicitIndexBuffer(const void* data, size_t size, Buffer
 }
 
 bool
-ShaderProgram::ConvertIndexBufferToUint16(const void* srcData, size_t elementCount, BufferObject** ibo)
+ShaderProgram::UploadIndices(const void* data, size_t size, size_t elementByteSize, VkDeviceSize* offset)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    uint16_t* convertedIndicesU16 = new uint16_t[elementCount];
-    size_t actualSize = elementCount * sizeof(uint16_t);
+    // client indices are appended to the streaming ring, instead of getting an index buffer per draw
+    if(mCommandBufferManager &&
+       mCommandBufferManager->AllocateStreamingMemory(size, elementByteSize, data, &mActiveIndexVkBuffer, offset)) {
+        return true;
+    }
 
-    bool validatedBuffer = ConvertBuffer<uint8_t, uint16_t>(srcData, convertedIndicesU16, elementCount);
-    if(validatedBuffer) {
-        validatedBuffer = AllocateExplicitIndexBuffer(convertedIndicesU16, actualSize, ibo);
+    BufferObject *ibo = nullptr;
+    if(!AllocateExplicitIndexBuffer(data, size, &ibo)) {
+        return false;
     }
-    delete[] convertedIndicesU16;
 
-    return validatedBuffer;
+    *offset = 0;
+    mActiveIndexVkBuffer = ibo->GetVkBuffer();
+
+    return true;
 }
 
 void
@@ -572,48 +584,58 @@ ShaderProgram::PrepareIndexBufferObject(uint32_t* firstIndex, uint32_t indexCoun
     FUN_ENTRY(GL_LOG_DEBUG);
 
     mActiveIndexVkBuffer = VK_NULL_HANDLE;
-    size_t actualSize = indexCount * (type == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort));
-    VkDeviceSize offset = 0;
-    bool validatedBuffer = true;
+
+    const bool   lineLoop       = mGLContext->IsModeLineLoop();
+    const size_t elementSize    = type == GL_UNSIGNED_INT  ? sizeof(GLuint)  : sizeof(GLushort);
+    const size_t srcElementSize = type == GL_UNSIGNED_BYTE ? sizeof(GLubyte) : elementSize;
+    const size_t actualSize     = indexCount * elementSize;
 
     // Index buffer requires special handling for passing data and handling unsigned bytes:
     // - If there is a index buffer bound, use the indices parameter as offset.
-    // - Otherwise, indices contains the index buffer data. Therefore create a temporary object and store the data there.
+    // - Otherwise, indices contains the index buffer data, which is uploaded to the streaming ring.
     // If the data format is GL_UNSIGNED_BYTE (not supported by Vulkan), convert the data to uint16 and pass this instead.
+    if(ibo && type != GL_UNSIGNED_BYTE && !lineLoop) {
+        *firstIndex = static_cast<uint32_t>(reinterpret_cast<VkDeviceSize>(indices));
+        mActiveIndexVkBuffer = ibo->GetVkBuffer();
+        return;
+    }
+
+    // If the primitives are rendered with GL_LINE_LOOP, which is not supported
+    // in Vulkan, the first index is added at the end.
+    const uint32_t srcCount = lineLoop ? indexCount - 1 : indexCount;
+
+    const void *srcData = indices;
+    uint8_t *readbackData = nullptr;
     if(ibo) {
-        offset = reinterpret_cast<VkDeviceSize>(indices);
+        readbackData = new uint8_t[srcCount * srcElementSize];
+        ibo->GetData(srcCount * srcElementSize, reinterpret_cast<VkDeviceSize>(indices), readbackData);
+        srcData = readbackData;
+    }
 
+    bool validatedBuffer = true;
+    const void *uploadData = srcData;
+    uint8_t *convertedData = nullptr;
+    if(type == GL_UNSIGNED_BYTE || lineLoop) {
+        convertedData = new uint8_t[actualSize];
         if(type == GL_UNSIGNED_BYTE) {
-            assert(indexCount <= ibo->GetSize());
-            uint8_t* srcData = new uint8_t[indexCount];
-            ibo->GetData(indexCount, offset, srcData);
-            offset = 0;
-            validatedBuffer = ConvertIndexBufferToUint16(srcData, indexCount, &ibo);
-            delete[] srcData;
-        }
-    } else {
-        if(type == GL_UNSIGNED_BYTE) {
-            validatedBuffer = ConvertIndexBufferToUint16(indices, indexCount, &ibo);
+            validatedBuffer = ConvertBuffer<uint8_t, uint16_t>(srcData, convertedData, srcCount);
         } else {
-            validatedBuffer = AllocateExplicitIndexBuffer(indices, actualSize, &ibo);
+            memcpy(convertedData, srcData, srcCount * elementSize);
         }
-    }
-
-    if(mGLContext->IsModeLineLoop()) {
-        size_t sizeOne = type == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
-        uint8_t* srcData = new uint8_t[indexCount * sizeOne];
 
-        ibo->GetData(actualSize - sizeOne, offset, srcData);
-        LineLoopConversion(srcData, indexCount, sizeOne);
-
-        validatedBuffer = AllocateExplicitIndexBuffer(srcData, actualSize, &ibo);
-        delete[] srcData;
+        if(lineLoop) {
+            LineLoopConversion(convertedData, indexCount, elementSize);
+        }
+        uploadData = convertedData;
     }
 
-    if(validatedBuffer) {
-        *firstIndex = (uint32_t)offset;
-        mActiveIndexVkBuffer = ibo->GetVkBuffer();
+    VkDeviceSize offset = 0;
+    if(validatedBuffer && UploadIndices(uploadData, actualSize, elementSize, &offset)) {
+        *firstIndex = static_cast<uint32_t>(offset);
     }
+
+    delete[] convertedData;
+    delete[] readbackData;
 }
 
 bool
@@ -641,13 +663,14 @@ ShaderProgram::UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVert
     FUN_ENTRY(GL_LOG_DEBUG);
 
     struct bufferLocations {
-        VkBuffer buffer;
-        int32_t  stride;
+        VkBuffer     buffer;
+        VkDeviceSize offset;
+        int32_t      stride;
 
-        bool operator ==(const bufferLocations &other) const { return (buffer == other.buffer && stride == other.stride); }
+        bool operator ==(const bufferLocations &other) const { return (buffer == other.buffer && offset == other.offset && stride == other.stride); }
     };
 
-    // store attribute locations containing the same VkBuffer and stride
+    // store attribute locations containing the same VkBuffer, offset and stride
     // as they are directly associated with vertex input bindings
     static bufferLocations unique_buffer_strides[GLOVE_MAX_VERTEX_ATTRIBS];
     static uint32_t locations[GLOVE_MAX_VERTEX_ATTRIBS][GLOVE_MAX_VERTEX_ATTRIBS];
@@ -673,17 +696,24 @@ ShaderProgram::UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVert
                 continue;
             }
 
+            // If the primitives are rendered with GL_LINE_LOOP, which is not
+            // supported in Vulkan, we have to modify the vbo and add the first vertex at the end.
+            const bool closeLoop = mGLContext->IsModeLineLoop() && !mActiveIndexVkBuffer;
+
+            // client arrays are streamed, so they come without a vbo and with an offset
             GenericVertexAttribute& gva = genericVertAttribs[location];
             bool updatedVBO   = false;
-            BufferObject *vbo = gva.UpdateVertexAttribute(static_cast<uint32_t>(firstVertex + vertCount), updatedVBO);
+            BufferObject *vbo = gva.UpdateVertexAttribute(static_cast<uint32_t>(firstVertex + vertCount), closeLoop, updatedVBO);
             if(updatedVBO) {
                 updatedVertexAttrib = true;
             }
-            VkBuffer bo       = vbo->GetVkBuffer();
+            VkBuffer     bo       = vbo ? vbo->GetVkBuffer() : gva.GetStreamVkBuffer();
+            VkDeviceSize boOffset = vbo ? 0 : gva.GetStreamOffset();
+            if(vbo) {
+                vbo->SetReadSerial();
+            }
 
-            // If the primitives are rendered with GL_LINE_LOOP, which is not
-            // supported in Vulkan, we have to modify the vbo and add the first vertex at the end.
-            if(mGLContext->IsModeLineLoop() && !mActiveIndexVkBuffer) {
+            if(closeLoop && vbo) {
                 BufferObject* vboLineLoopUpdated = new VertexBufferObject(mVkContext);
 
                 size_t sizeOld = vbo->GetSize();
@@ -704,7 +734,7 @@ ShaderProgram::UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVert
 
             // store each location
             int32_t stride      = gva.GetStride();
-            bufferLocations p   = {bo, stride};
+            bufferLocations p   = {bo, boOffset, stride};
             uint32_t index = 0;
             for (; index < unique_buffer_strides_count; ++index) {
                 if (p == unique_buffer_strides[index]) {
@@ -722,10 +752,7 @@ ShaderProgram::UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVert
         }
     }
 
-    if(!updatedVertexAttrib) {
-        return false;
-    }
-
+    // buffers and offsets are refreshed on every draw, as streamed arrays move within the ring
     memset(mActiveVertexVkBuffers, VK_NULL_HANDLE, sizeof(VkBuffer) * mActiveVertexVkBuffersCount);
     mActiveVertexVkBuffersCount = 0;
 
@@ -737,11 +764,12 @@ ShaderProgram::UpdateVertexAttribProperties(size_t vertCount, uint32_t firstVert
         for (uint32_t j = 0; j < locations_count[i]; ++j) {
             vboLocationBindings[locals[j]] = current_binding;
         }
-        mActiveVertexVkBuffers[current_binding] = bo;
+        mActiveVertexVkBuffers[current_binding]        = bo;
+        mActiveVertexVkBuffersOffsets[current_binding] = unique_buffer_strides[i].offset;
         ++current_binding;
     }
     mActiveVertexVkBuffersCount = current_binding;
-    return true;
+    return updatedVertexAttrib;
 }
 
 void
@@ -784,16 +812,21 @@ ShaderProgram::GenerateVertexInputProperties(std::vector<GenericVertexAttribute>
     mVkPipelineVertexInput.vertexAttributeDescriptionCount = count;
 }
 
-void
+bool
 ShaderProgram::UsePrecompiledBinary(const void *binary, size_t binarySize)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mLinked = true;
+    mLinked = false;
 
     ResetVulkanVertexInput();
 
     uint32_t reflectionOffset = mShaderCompiler->DeserializeReflection(binary);
+    if(!reflectionOffset) {
+        return false;
+    }
+
+    mLinked = true;
     uint32_t spirvOffset = DeserializeShadersSpirv(reinterpret_cast<const uint8_t *>(binary) + reflectionOffset);
     const uint8_t *vulkanDataPtr = reinterpret_cast<const uint8_t *>(binary) + reflectionOffset + spirvOffset;
 
@@ -802,6 +835,8 @@ ShaderProgram::UsePrecompiledBinary(const void *binary, size_t binarySize)
     mPipelineCache->Create(vulkanDataPtr, binarySize - reflectionOffset);
 
     mIsPrecompiled = true;
+
+    return true;
 }
 
 void
@@ -929,6 +964,7 @@ ShaderProgram::ReleaseVkObjects(void)
         vkFreeDescriptorSets(mVkContext->vkDevice, mVkDescPool, 1, &descSet);
         mUsingDescSets.pop();
     }
+    mVkDescSet = VK_NULL_HANDLE;
 
     if (mVkDescPool != VK_NULL_HANDLE) {
         mCommandBufferManager->UnrefResouce(mVkDescPool);
@@ -955,13 +991,35 @@ ShaderProgram::CreateDescriptorSetLayout(uint32_t nLiveUniformBlocks)
         mVkDescSetLayoutBind = nullptr;
     }
 
+    /// Uniform blocks live in the uniform ring and are bound with dynamic offsets, so that
+    /// new uniform data never needs a descriptor write. Only a few dynamic buffers are
+    /// guaranteed per set, the rest are bound at fixed offsets. Dynamic offsets are
+    /// consumed in binding order.
+    std::vector<uint32_t> bufferBlocks;
+    for(uint32_t i = 0; i < nLiveUniformBlocks; ++i) {
+        mShaderResourceInterface.SetUniformBlockDynamic(i, false);
+        if(!mShaderResourceInterface.IsUniformBlockOpaque(i)) {
+            bufferBlocks.push_back(i);
+        }
+    }
+    std::sort(bufferBlocks.begin(), bufferBlocks.end(), [this](uint32_t a, uint32_t b) {
+        return mShaderResourceInterface.GetUniformBlockBinding(a) < mShaderResourceInterface.GetUniformBlockBinding(b);
+    });
+
+    mDynamicOffsetCount = 0;
+    for(uint32_t i = 0; i < bufferBlocks.size() && i < GLOVE_MAX_DYNAMIC_UNIFORM_BUFFERS; ++i) {
+        mShaderResourceInterface.SetUniformBlockDynamic(bufferBlocks[i], true);
+        mDynamicUniformBlocks[mDynamicOffsetCount] = bufferBlocks[i];
+        mDynamicOffsets[mDynamicOffsetCount++] = 0;
+    }
+
     if(nLiveUniformBlocks) {
         mVkDescSetLayoutBind = new VkDescriptorSetLayoutBinding[nLiveUniformBlocks];
         assert(mVkDescSetLayoutBind);
 
         for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniformBlocks(); ++i) {
             mVkDescSetLayoutBind[i].binding = mShaderResourceInterface.GetUniformBlockBinding(i);
-            mVkDescSetLayoutBind[i].descriptorType = mShaderResourceInterface.IsUniformBlockOpaque(i) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            mVkDescSetLayoutBind[i].descriptorType = mShaderResourceInterface.GetUniformBlockDescriptorType(i);
             mVkDescSetLayoutBind[i].descriptorCount = 1;
             mVkDescSetLayoutBind[i].stageFlags = mShaderResourceInterface.GetUniformBlockBlockStage(i) == (SHADER_TYPE_VERTEX | SHADER_TYPE_FRAGMENT) ? VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT :
                                                  mShaderResourceInterface.GetUniformBlockBlockStage(i) == SHADER_TYPE_VERTEX ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -995,6 +1053,23 @@ ShaderProgram::CreateDescriptorSetLayout(uint32_t nLiveUniformBlocks)
     pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
     pipelineLayoutCreateInfo.pPushConstantRanges    = nullptr;
 
+    /// Small uniforms picked when linking are pushed as constants with every draw
+    VkPushConstantRange pushConstantRange;
+    const ShaderResourceInterface::uniformBlock *pushConstantBlock = mShaderResourceInterface.GetPushConstantBlock();
+    mPushConstantStages = 0;
+    if(pushConstantBlock) {
+        assert(pushConstantBlock->blockSize <= GLOVE_MAX_PUSH_CONSTANTS_SIZE);
+        mPushConstantStages = pushConstantBlock->blockStage == (SHADER_TYPE_VERTEX | SHADER_TYPE_FRAGMENT) ? VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT :
+                              pushConstantBlock->blockStage == SHADER_TYPE_VERTEX ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        pushConstantRange.stageFlags = mPushConstantStages;
+        pushConstantRange.offset     = 0;
+        pushConstantRange.size       = static_cast<uint32_t>(pushConstantBlock->blockSize);
+
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges    = &pushConstantRange;
+    }
+
     if(vkCreatePipelineLayout(mVkContext->vkDevice, &pipelineLayoutCreateInfo, 0, &mVkPipelineLayout) != VK_SUCCESS) {
         assert(0);
         return false;
@@ -1017,7 +1092,7 @@ ShaderProgram::CreateDescriptorPool(uint32_t nLiveUniformBlocks)
 
     for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniformBlocks(); ++i) {
         descTypeCounts[i].descriptorCount = 1;
-        descTypeCounts[i].type = mShaderResourceInterface.IsUniformBlockOpaque(i) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descTypeCounts[i].type = mShaderResourceInterface.GetUniformBlockDescriptorType(i);
         assert(descTypeCounts[i].type == mVkDescSetLayoutBind[i].descriptorType);
     }
 
@@ -1094,10 +1169,17 @@ ShaderProgram::MoveUsingDescriptorSetsToPending(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // The current set stays in use, as the next draws keep binding it until it needs an update
     while (!mUsingDescSets.empty()) {
-        mPendingDescSets.push(mUsingDescSets.front());
+        if(mUsingDescSets.front() != mVkDescSet) {
+            mPendingDescSets.push(mUsingDescSets.front());
+        }
         mUsingDescSets.pop();
     }
+
+    if(mVkDescSet != VK_NULL_HANDLE) {
+        mUsingDescSets.push(mVkDescSet);
+    }
 }
 
 bool
@@ -1161,7 +1243,6 @@ ShaderProgram::UpdateDescriptorSet(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    assert(mVkDescSet);
     assert(mGLContext);
     assert(mVkContext);
 
@@ -1169,18 +1250,25 @@ ShaderProgram::UpdateDescriptorSet(void)
         return;
     }
 
-    /// Transfer any new local uniform data into the buffer objects
-    if(mUpdateDescriptorData) {
-        bool allocatedNewBufferObject = false;
-        mShaderResourceInterface.UpdateUniformBufferData(mVkContext, &allocatedNewBufferObject);
-        if(allocatedNewBufferObject) {
+    /// Write any new local uniform data into the uniform ring. The data of the
+    /// previous submissions is reclaimed, so every new submission writes it again
+    if(mUpdateDescriptorData || mUniformDataSerial != mCommandBufferManager->GetActiveSerial()) {
+        bool updatedDescriptors = false;
+        mShaderResourceInterface.UpdateUniformBufferData(mVkContext, mCommandBufferManager, &updatedDescriptors);
+        if(updatedDescriptors) {
             mUpdateDescriptorSets = true;
         }
 
+        for(uint32_t i = 0; i < mDynamicOffsetCount; ++i) {
+            mDynamicOffsets[i] = static_cast<uint32_t>(mShaderResourceInterface.GetUniformBlock(mDynamicUniformBlocks[i]).offset);
+        }
+
+        mUniformDataSerial = mCommandBufferManager->GetActiveSerial();
         mUpdateDescriptorData = false;
     }
 
-    // Check if any texture is attached to a user-based FBO
+    // Check if any texture is attached to a user-based FBO, record the queued
+    // updates of the sampled textures and mark them as read by the active submission
     for(uint32_t i = 0; i < mShaderResourceInterface.GetLiveUniforms(); ++i) {
         if(mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_2D || mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_CUBE) {
             for(int32_t j = 0; j < mShaderResourceInterface.GetUniformArraySize(i); ++j) {
@@ -1189,20 +1277,28 @@ ShaderProgram::UpdateDescriptorSet(void)
                 /// Sampler might need an update
                 Texture *activeTexture = mGLContext->GetStateManager()->GetActiveObjectsState()->GetActiveTexture(
                 mShaderResourceInterface.GetUniformType(i) == GL_SAMPLER_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP, textureUnit); // TODO remove mGlContext
-                if(mGLContext->GetResourceManager()->IsTextureAttachedToFBO(activeTexture)) {
+                activeTexture->FlushQueuedUploads();
+                activeTexture->SetReadSerial();
+                if(!mUpdateDescriptorSets && mGLContext->GetResourceManager()->IsTextureAttachedToFBO(activeTexture)) {
                     mUpdateDescriptorSets = true;
-                    break;
                 }
             }
         }
     }
 
-    /// This can be true only in three occasions:
+    /// This can be true only in these occasions:
     /// 1. This is a freshly linked shader. So the descriptor sets need to be created
     /// 2. There has been an update in a sampler via the glUniform1i()
     /// 3. glBindTexture has been called
     /// 4. Texture is attached to a user-based FBO
-    if(!mUpdateDescriptorSets) {
+    /// 5. Uniform data moved to another buffer, or a block without a dynamic offset moved
+    /// Otherwise the current descriptor set is still valid and is bound again as it is
+    if(!mUpdateDescriptorSets && mVkDescSet != VK_NULL_HANDLE) {
+        return;
+    }
+
+    /// Draws already recorded may still read the current set, so the update goes to another one
+    if(!GetValidDescriptorSet()) {
         return;
     }
 
@@ -1222,6 +1318,7 @@ ShaderProgram::UpdateSamplerDescriptors(void)
     /// Get texture units from samplers
     uint32_t samp = 0;
     uint32_t *map_block_texDescriptor = (uint32_t *)calloc(nLiveUniformBlocks, sizeof(uint32_t));
+    uint32_t *map_block_texCount = (uint32_t *)calloc(nLiveUniformBlocks, sizeof(uint32_t));
     VkDescriptorImageInfo *textureDescriptors = nullptr;
     if(nSamplers) {
         textureDescriptors = (VkDescriptorImageInfo *)calloc(nSamplers, sizeof(VkDescriptorImageInfo));
@@ -1312,6 +1409,7 @@ ShaderProgram::UpdateSamplerDescriptors(void)
 
                     if(j == 0) {
                         map_block_texDescriptor[uniform.blockIndex] = samp;
+                        map_block_texCount[uniform.blockIndex] = uniform.arraySize;
                     }
                     ++samp;
                 }
@@ -1321,10 +1419,10 @@ ShaderProgram::UpdateSamplerDescriptors(void)
     assert(samp == nSamplers);
 
     samp = 0;
+    VkDescriptorBufferInfo *bufferDescriptors = (VkDescriptorBufferInfo *)calloc(nLiveUniformBlocks, sizeof(VkDescriptorBufferInfo));
     VkWriteDescriptorSet *writes = (VkWriteDescriptorSet *)calloc(nLiveUniformBlocks, sizeof(VkWriteDescriptorSet));
     for(uint32_t i = 0; i < nLiveUniformBlocks; ++i) {
         auto &uniformBlock = mShaderResourceInterface.GetUniformBlock(i);
-        auto &uniform = mShaderResourceInterface.GetUniform(i);
         writes[i].sType      = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         writes[i].pNext      = nullptr;
         writes[i].dstSet     = mVkDescSet;
@@ -1333,12 +1431,17 @@ ShaderProgram::UpdateSamplerDescriptors(void)
         if(uniformBlock.isOpaque) {
             writes[i].pImageInfo      = &textureDescriptors[map_block_texDescriptor[i]];
             writes[i].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            writes[i].descriptorCount = uniform.arraySize; 
-            samp += uniform.arraySize; 
+            writes[i].descriptorCount = map_block_texCount[i];
+            samp += map_block_texCount[i];
         } else {
+            /// Blocks with a dynamic offset are written at the start of the buffer
+            bufferDescriptors[i].buffer = uniformBlock.vkBuffer;
+            bufferDescriptors[i].offset = uniformBlock.isDynamic ? 0 : uniformBlock.offset;
+            bufferDescriptors[i].range  = uniformBlock.blockSize;
+
             writes[i].descriptorCount = 1;
-            writes[i].descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            writes[i].pBufferInfo     = uniformBlock.pBufferObject->GetBufferDescInfo();
+            writes[i].descriptorType  = mShaderResourceInterface.GetUniformBlockDescriptorType(i);
+            writes[i].pBufferInfo     = &bufferDescriptors[i];
         }
     }
     assert(samp == nSamplers);
@@ -1346,6 +1449,8 @@ ShaderProgram::UpdateSamplerDescriptors(void)
     vkUpdateDescriptorSets(mVkContext->vkDevice, nLiveUniformBlocks, writes, 0, nullptr);
 
     free(map_block_texDescriptor);
+    free(map_block_texCount);
+    free(bufferDescriptors);
     free(writes);
     free(textureDescriptors);
 
@@ -1383,7 +1488,6 @@ ShaderProgram::BuildShaderResourceInterface(void)
     mShaderResourceInterface.CreateInterface();
     mShaderResourceInterface.SetReflection(nullptr);
     mShaderResourceInterface.AllocateUniformClientData();
-    mShaderResourceInterface.AllocateUniformBufferObjects(mVkContext);
 
     mShaderResourceInterface.SetActiveUniformMaxLength();
     mShaderResourceInterface.SetActiveAttributeMaxLength();
@@ -51,6 +51,12 @@ private:
     std::queue<VkDescriptorSet>                         mUsingDescSets;
     VkPipelineLayout                                    mVkPipelineLayout;
 
+    uint32_t                                            mDynamicOffsetCount;
+    uint32_t                                            mDynamicOffsets[GLOVE_MAX_DYNAMIC_UNIFORM_BUFFERS];
+    uint32_t                                            mDynamicUniformBlocks[GLOVE_MAX_DYNAMIC_UNIFORM_BUFFERS];
+    uint64_t                                            mUniformDataSerial;
+    VkShaderStageFlags                                  mPushConstantStages;
+
     vulkanAPI::PipelineCache                           *mPipelineCache;
     CacheManager                                       *mCacheManager;
 
@@ -60,6 +66,7 @@ private:
 
     uint32_t                                            mActiveVertexVkBuffersCount;
     VkBuffer                                            mActiveVertexVkBuffers[GLOVE_MAX_VERTEX_ATTRIBS];
+    VkDeviceSize                                        mActiveVertexVkBuffersOffsets[GLOVE_MAX_VERTEX_ATTRIBS];
 
     std::vector<GenericVertexAttribute>                 mGenericVertexAttributes;
 
@@ -106,8 +113,8 @@ private:
     void                                                GenerateVertexInputProperties(std::vector<GenericVertexAttribute>& genericVertAttribs, const uint32_t *vboLocationBindings);
 
     void                                                LineLoopConversion(void* data, uint32_t indexCount, size_t elementByteSize);
-    bool                                                ConvertIndexBufferToUint16(const void* srcData, size_t elementCount, BufferObject** ibo);
     bool                                                AllocateExplicitIndexBuffer(const void* data, size_t size, BufferObject** ibo);
+    bool                                                UploadIndices(const void* data, size_t size, size_t elementByteSize, VkDeviceSize* offset);
     uint32_t                                            GetMaxIndex(BufferObject* ibo, uint32_t indexCount, size_t actualSize, VkDeviceSize offset);
 
 public:
@@ -131,7 +138,7 @@ public:
     bool                                                ValidateSamplers(void);
     void                                                EnableUpdateOfDescriptorSets(void)                  { FUN_ENTRY(GL_LOG_TRACE); mUpdateDescriptorSets = true; }
 
-    void                                                UsePrecompiledBinary(const void *binary, size_t binarySize);
+    bool                                                UsePrecompiledBinary(const void *binary, size_t binarySize);
     void                                                GetBinaryData(void *binary, GLsizei *binarySize);
     GLsizei                                             GetBinaryLength(void);
 
@@ -153,14 +160,19 @@ public:
     VkPipelineLayout                                    GetVkPipelineLayout(void)                   const   { FUN_ENTRY(GL_LOG_TRACE); return mVkPipelineLayout; }
     int                                                 GetStagesIDs(uint32_t index)                const   { FUN_ENTRY(GL_LOG_TRACE); return mStagesIDs[index]; }
     const VkDescriptorSet                              *GetVkDescSet(void)                          const   { FUN_ENTRY(GL_LOG_TRACE); return &mVkDescSet; }
+    uint32_t                                            GetDynamicOffsetCount(void)                 const   { FUN_ENTRY(GL_LOG_TRACE); return mDynamicOffsetCount; }
+    const uint32_t                                     *GetDynamicOffsets(void)                     const   { FUN_ENTRY(GL_LOG_TRACE); return mDynamicOffsets; }
+    const ShaderResourceInterface::uniformBlock        *GetPushConstantBlock(void)                  const   { FUN_ENTRY(GL_LOG_TRACE); return mShaderResourceInterface.GetPushConstantBlock(); }
+    VkShaderStageFlags                                  GetPushConstantStages(void)                 const   { FUN_ENTRY(GL_LOG_TRACE); return mPushConstantStages; }
     uint32_t                                            GetActiveVertexVkBuffersCount(void)         const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexVkBuffersCount; }
     const VkBuffer                                     *GetActiveVertexVkBuffers(void)              const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexVkBuffers; }
+    const VkDeviceSize                                 *GetActiveVertexVkBuffersOffsets(void)       const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveVertexVkBuffersOffsets; }
     VkBuffer                                            GetActiveIndexVkBuffer(void)                const   { FUN_ENTRY(GL_LOG_TRACE); return mActiveIndexVkBuffer; }
     inline std::vector<GenericVertexAttribute>&         GetGenericVertexAttributes(void)                    { FUN_ENTRY(GL_LOG_TRACE); return mGenericVertexAttributes; }
     inline GenericVertexAttribute*                      GetGenericVertexAttribute(size_t index)             { FUN_ENTRY(GL_LOG_TRACE); return &mGenericVertexAttributes[index]; }
 
     void                                                SetCommandBufferManager(
-                                                        vulkanAPI::CommandBufferManager *cbManager)         { FUN_ENTRY(GL_LOG_TRACE); mCommandBufferManager = cbManager;}
+                                                        vulkanAPI::CommandBufferManager *cbManager)         { FUN_ENTRY(GL_LOG_TRACE); mCommandBufferManager = cbManager; for (auto& gva : mGenericVertexAttributes) { gva.SetCommandBufferManager(cbManager); } }
     void                                                SetVkContext(const vulkanAPI::vkContext_t *vkContext) { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext; mPipelineCache->SetContext(mVkContext); for (auto& gva : mGenericVertexAttributes) { gva.SetVkContext(vkContext); } }
     void                                                SetGlContext(Context *context)                      { FUN_ENTRY(GL_LOG_TRACE); assert(context); mGLContext = context; }
     void                                                SetShaderCompiler(ShaderCompiler* shaderCompiler)   { FUN_ENTRY(GL_LOG_TRACE); assert(shaderCompiler != nullptr); mShaderCompiler = shaderCompiler; }
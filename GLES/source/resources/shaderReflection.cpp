@@ -49,6 +49,10 @@ ShaderReflection::SerializeReflection(void *binary) const
     uint8_t *rawDataPtr = reinterpret_cast<uint8_t *>(binary);
     uint32_t *u32DataPtr = nullptr;
 
+    u32DataPtr = reinterpret_cast<uint32_t *>(rawDataPtr);
+    *u32DataPtr = GLSLANG_REFLECTION_VERSION;
+    rawDataPtr += sizeof(uint32_t);
+
     u32DataPtr = reinterpret_cast<uint32_t *>(rawDataPtr);
     *u32DataPtr = mReflectionData.mLiveAttributes;
     rawDataPtr += sizeof(uint32_t);
@@ -110,9 +114,11 @@ ShaderReflection::SerializeReflection(void *binary) const
         rawDataPtr += sizeof(uint32_t);
         *rawDataPtr = mReflectionData.mUniformBlockReflection[i].isOpaque;
         rawDataPtr += sizeof(bool);
+        *rawDataPtr = mReflectionData.mUniformBlockReflection[i].isPushConstant;
+        rawDataPtr += sizeof(bool);
     }
 
-    return sizeof(reflectionData);
+    return GetReflectionSize();
 }
 
 uint32_t
@@ -123,6 +129,14 @@ ShaderReflection::DeserializeReflection(const void *binary)
     const uint8_t *rawDataPtr = reinterpret_cast<const uint8_t *>(binary);
     const uint32_t *u32DataPtr = nullptr;
 
+    // binaries with another layout are rejected, the program has to be linked again
+    u32DataPtr = reinterpret_cast<const uint32_t *>(rawDataPtr);
+    if(*u32DataPtr != GLSLANG_REFLECTION_VERSION) {
+        GLOVE_PRINT_ERR("Program binary reflection version %u is not supported\n", *u32DataPtr);
+        return 0;
+    }
+    rawDataPtr += sizeof(uint32_t);
+
     u32DataPtr = reinterpret_cast<const uint32_t *>(rawDataPtr);
     mReflectionData.mLiveAttributes = *u32DataPtr;
     rawDataPtr += sizeof(uint32_t);
@@ -184,9 +198,11 @@ ShaderReflection::DeserializeReflection(const void *binary)
         rawDataPtr += sizeof(uint32_t);
         mReflectionData.mUniformBlockReflection[i].isOpaque = *rawDataPtr;
         rawDataPtr += sizeof(bool);
+        mReflectionData.mUniformBlockReflection[i].isPushConstant = *rawDataPtr;
+        rawDataPtr += sizeof(bool);
     }
 
-    return sizeof(reflectionData);
+    return GetReflectionSize();
 }
 
 void
@@ -194,24 +210,25 @@ ShaderReflection::ReadReflection() const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    printf("\nGL_ACTIVE_ATTRIBUTES: %d\n", mReflectionData.mLiveAttributes);
+    GLOVE_PRINT(GL_LOG_DEBUG, "\nGL_ACTIVE_ATTRIBUTES: %d\n", mReflectionData.mLiveAttributes);
     for(uint32_t i = 0; i < mReflectionData.mLiveAttributes; ++i) {
-        printf("%s (0x%x)\n", mReflectionData.mAttributeReflection[i].name, mReflectionData.mAttributeReflection[i].type);
-        printf("location: %u\n", mReflectionData.mAttributeReflection[i].location);
+        GLOVE_PRINT(GL_LOG_DEBUG, "%s (0x%x)\n", mReflectionData.mAttributeReflection[i].name, mReflectionData.mAttributeReflection[i].type);
+        GLOVE_PRINT(GL_LOG_DEBUG, "location: %u\n", mReflectionData.mAttributeReflection[i].location);
     }
 
-    printf("\nGL_ACTIVE_UNIFORMS: %d\n", mReflectionData.mLiveUniforms);
+    GLOVE_PRINT(GL_LOG_DEBUG, "\nGL_ACTIVE_UNIFORMS: %d\n", mReflectionData.mLiveUniforms);
     for(uint32_t i = 0; i < mReflectionData.mLiveUniforms; ++i) {
-        printf("%s (0x%x)\n", mReflectionData.mUniformReflection[i].reflectionName, mReflectionData.mUniformReflection[i].glType);
-        printf("arraySize: %u, bufferOffset: %zu\n", mReflectionData.mUniformReflection[i].arraySize, mReflectionData.mUniformReflection[i].offset);
-        printf("location: %u, blockIndex: %u\n", mReflectionData.mUniformReflection[i].location, mReflectionData.mUniformReflection[i].blockIndex);
+        GLOVE_PRINT(GL_LOG_DEBUG, "%s (0x%x)\n", mReflectionData.mUniformReflection[i].reflectionName, mReflectionData.mUniformReflection[i].glType);
+        GLOVE_PRINT(GL_LOG_DEBUG, "arraySize: %u, bufferOffset: %zu\n", mReflectionData.mUniformReflection[i].arraySize, mReflectionData.mUniformReflection[i].offset);
+        GLOVE_PRINT(GL_LOG_DEBUG, "location: %u, blockIndex: %u\n", mReflectionData.mUniformReflection[i].location, mReflectionData.mUniformReflection[i].blockIndex);
     }
 
-    printf("\nGL_ACTIVE_UNIFORM_BLOCKS: %d\n", mReflectionData.mLiveUniformBlocks);
+    GLOVE_PRINT(GL_LOG_DEBUG, "\nGL_ACTIVE_UNIFORM_BLOCKS: %d\n", mReflectionData.mLiveUniformBlocks);
     for(uint32_t i = 0; i < mReflectionData.mLiveUniformBlocks; ++i) {
-        printf("%s , blockSize: %zu)\n", mReflectionData.mUniformBlockReflection[i].glslBlockName, mReflectionData.mUniformBlockReflection[i].blockSize);
-        printf("blockStage: %u\n", mReflectionData.mUniformBlockReflection[i].blockStage);
-        printf("binding: %u, isOpaque: %u\n", mReflectionData.mUniformBlockReflection[i].binding, mReflectionData.mUniformBlockReflection[i].isOpaque);
+        GLOVE_PRINT(GL_LOG_DEBUG, "%s , blockSize: %zu)\n", mReflectionData.mUniformBlockReflection[i].glslBlockName, mReflectionData.mUniformBlockReflection[i].blockSize);
+        GLOVE_PRINT(GL_LOG_DEBUG, "blockStage: %u\n", mReflectionData.mUniformBlockReflection[i].blockStage);
+        GLOVE_PRINT(GL_LOG_DEBUG, "binding: %u, isOpaque: %u, isPushConstant: %u\n", mReflectionData.mUniformBlockReflection[i].binding, mReflectionData.mUniformBlockReflection[i].isOpaque,
+                                                                                     mReflectionData.mUniformBlockReflection[i].isPushConstant);
     }
 }
 
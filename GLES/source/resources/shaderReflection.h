@@ -37,6 +37,10 @@
 #define GLSLANG_MAX_UNIFORM_BLOCKS                GLOVE_MAX_COMBINED_UNIFORM_VECTORS
 #define GLSLANG_MAX_UNIFORM_BLOCK_NAME_LENGTH     50
 
+// Version of the serialized reflection, increased on every change of its layout
+// (2: isPushConstant of the uniform blocks)
+#define GLSLANG_REFLECTION_VERSION                2
+
 class ShaderReflection {
 private:
     typedef struct {
@@ -60,6 +64,7 @@ private:
         size_t        blockSize;
         shader_type_t blockStage;
         bool          isOpaque;
+        bool          isPushConstant;
     } uniformBlock;
 
     typedef struct {
@@ -82,7 +87,7 @@ public:
     GLenum GetAttributeType(const char *name) const;
     uint32_t DeserializeReflection(const void *binary);
     uint32_t SerializeReflection(void *binary) const;
-    uint32_t GetReflectionSize(void)                                          const { FUN_ENTRY(GL_LOG_TRACE); return sizeof(reflectionData); }
+    uint32_t GetReflectionSize(void)                                          const { FUN_ENTRY(GL_LOG_TRACE); return sizeof(uint32_t) + sizeof(reflectionData); }
     void ReadReflection() const;
 
     inline uint32_t GetLiveAttributes(void)                                   const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mLiveAttributes; }
@@ -105,6 +110,7 @@ public:
     inline size_t GetUniformBlockBlockSize(uint32_t index)                    const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].blockSize; }
     inline shader_type_t GetUniformBlockBlockStage(uint32_t index)            const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].blockStage; }
     inline bool GetUniformBlockOpaque(uint32_t index)                         const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].isOpaque; }
+    inline bool GetUniformBlockPushConstant(uint32_t index)                   const { FUN_ENTRY(GL_LOG_TRACE); return mReflectionData.mUniformBlockReflection[index].isPushConstant; }
 
     inline void SetLiveAttributes(uint32_t LiveAttributes)                          { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mLiveAttributes = LiveAttributes; }
     inline void SetLiveUniforms(uint32_t LiveUniforms)                              { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mLiveUniforms = LiveUniforms; }
@@ -126,6 +132,7 @@ public:
     inline void SetUniformBlockBlockSize(size_t blockSize, uint32_t index)          { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].blockSize = blockSize; }
     inline void SetUniformBlockBlockStage(shader_type_t blockStage, uint32_t index) { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].blockStage = blockStage; }
     inline void SetUniformBlockOpaque(bool opaque, uint32_t index)                  { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].isOpaque = opaque; }
+    inline void SetUniformBlockPushConstant(bool pushConstant, uint32_t index)      { FUN_ENTRY(GL_LOG_TRACE); mReflectionData.mUniformBlockReflection[index].isPushConstant = pushConstant; }
 };
 
 #endif //__SHADERREFLECTION_H__
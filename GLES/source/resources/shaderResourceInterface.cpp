@@ -26,6 +26,7 @@
  */
 
 #include "shaderResourceInterface.h"
+#include "vulkan/cbManager.h"
 #include "utils/parser_helpers.h"
 #include "utils/glUtils.h"
 #include "utils/glLogger.h"
@@ -77,8 +78,6 @@ ShaderResourceInterface::CreateInterface(void)
     mLiveUniforms = mShaderReflection->GetLiveUniforms();
     mLiveUniformBlocks = mShaderReflection->GetLiveUniformBlocks();
 
-    assert(mLiveUniforms == mLiveUniformBlocks);
-
     mAttributeInterface.reserve(mLiveAttributes);
     mUniforms.Reserve(mLiveUniforms);
     mUniformBlocks.Reserve(mLiveUniformBlocks);
@@ -100,14 +99,26 @@ ShaderResourceInterface::CreateInterface(void)
         mUniforms.PushBack(u);
     }
 
+    mLiveSamplers = 0;
     for(uint32_t i = 0; i < mLiveUniformBlocks; ++i) {
         uniformBlock *ub = new uniformBlock(
             mShaderReflection->GetUniformBlockGlslBlockName(i),
             mShaderReflection->GetUniformBlockBinding(i),
             mShaderReflection->GetUniformBlockBlockSize(i),
             mShaderReflection->GetUniformBlockBlockStage(i),
-            mShaderReflection->GetUniformBlockOpaque(i));
+            mShaderReflection->GetUniformBlockOpaque(i),
+            mShaderReflection->GetUniformBlockPushConstant(i));
         mUniformBlocks.PushBack(ub);
+
+        if(ub->isOpaque) {
+            ++mLiveSamplers;
+        }
+    }
+
+    /// The push constant block has the highest binding and needs no descriptor,
+    /// so it is kept past the blocks that are counted as live
+    if(mLiveUniformBlocks && mUniformBlocks[mLiveUniformBlocks - 1]->isPushConstant) {
+        --mLiveUniformBlocks;
     }
 }
 
@@ -121,62 +132,65 @@ ShaderResourceInterface::AllocateUniformClientData(void)
         size_t clientDataSize = uni->arraySize * GlslTypeToSize(uni->glType);
         uni->pClientData = (uint8_t *)calloc(clientDataSize, sizeof(uint8_t));
     }
-}
 
-bool
-ShaderResourceInterface::AllocateUniformBufferObjects(const vulkanAPI::vkContext_t *vkContext)
-{
-    FUN_ENTRY(GL_LOG_DEBUG);
-
-    mLiveSamplers = 0;
     for (uint32_t i = 0; i < mUniformBlocks.Size(); ++i) {
-        auto &uniBlock = mUniformBlocks[i];
-        UniformBufferObject *ubo = nullptr;
-        if(!uniBlock->isOpaque) {
-            assert(uniBlock->blockSize);
-            ubo = new UniformBufferObject(vkContext);
-            ubo->Allocate(uniBlock->requiredSize, nullptr, uniBlock->blockSize);
-        } else {
-            ++ mLiveSamplers;
+        auto& block = mUniformBlocks[i];
+        if(!block->isOpaque) {
+            block->pClientData = new uint8_t[block->blockSize]();
         }
-        uniBlock->pBufferObject = ubo;
     }
-
-    return true;
 }
 
 bool
-ShaderResourceInterface::UpdateUniformBufferData(const vulkanAPI::vkContext_t *vkContext, bool *allocatedNewBufferObject)
+ShaderResourceInterface::UpdateUniformBufferData(const vulkanAPI::vkContext_t *vkContext, vulkanAPI::CommandBufferManager *cbManager, bool *updatedDescriptors)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for (uint32_t i = 0; i < mUniformBlocks.Size(); ++i) {
+    const uint64_t serial = cbManager->GetActiveSerial();
+
+    for (uint32_t i = 0; i < mLiveUniformBlocks; ++i) {
         auto &uniformBlock = mUniformBlocks[i];
-        auto &uniform = mUniforms[i];
 
-        if (uniform->clientDataDirty) {
-            uniform->clientDataDirty = false;
+        if (uniformBlock->isOpaque) {
+            continue;
+        }
 
-            if (IsBuildInUniform(uniform->reflectionName)) {
-                continue;
-            }
+        /// Ring space is handed back once the submission it was written for has completed,
+        /// so data left unchanged since an earlier submission is written again
+        if (!uniformBlock->clientDataDirty && uniformBlock->serial == serial) {
+            continue;
+        }
+        uniformBlock->clientDataDirty = false;
 
-            UniformBufferObject *bufferObject = uniformBlock->pBufferObject;
-            if(bufferObject) {
-                mCacheManager->CacheUBO(bufferObject);
-            }
+        UniformBufferObject *bufferObject = uniformBlock->pBufferObject;
+        if (bufferObject) {
+            mCacheManager->CacheUBO(bufferObject);
+            uniformBlock->pBufferObject = nullptr;
+        }
 
-            bufferObject = mCacheManager->GetUBO(uniformBlock->cacheIndex);
-            if (bufferObject) {
-                bufferObject->UpdateData(uniformBlock->blockSize, 0, uniform->pClientData);
-            } else {
-                bufferObject = new UniformBufferObject(vkContext);
-                bufferObject->Allocate(uniformBlock->requiredSize, uniform->pClientData, uniformBlock->blockSize);
+        VkBuffer     vkBuffer = VK_NULL_HANDLE;
+        VkDeviceSize offset   = 0;
+        if (!cbManager->AllocateUniformMemory(uniformBlock->blockSize, uniformBlock->pClientData, &vkBuffer, &offset)) {
+            /// The ring is full with the data of the draws being recorded, so the block gets a buffer of its own
+            bufferObject = new UniformBufferObject(vkContext);
+            if (!bufferObject->Allocate(uniformBlock->blockSize, uniformBlock->pClientData, uniformBlock->blockSize)) {
+                delete bufferObject;
+                uniformBlock->vkBuffer = VK_NULL_HANDLE;
+                uniformBlock->serial   = 0;
+                return false;
             }
             uniformBlock->pBufferObject = bufferObject;
+            vkBuffer = bufferObject->GetVkBuffer();
+        }
 
-            *allocatedNewBufferObject = true;
+        /// Dynamic blocks only need a descriptor write when they move to another buffer
+        if (vkBuffer != uniformBlock->vkBuffer || (!uniformBlock->isDynamic && offset != uniformBlock->offset)) {
+            *updatedDescriptors = true;
         }
+
+        uniformBlock->vkBuffer = vkBuffer;
+        uniformBlock->offset   = offset;
+        uniformBlock->serial   = serial;
     }
 
     return true;
@@ -246,7 +260,20 @@ ShaderResourceInterface::SetUniformClientData(uint32_t location, size_t size, co
     assert(arrayOffset + size <= uniform->arraySize * GlslTypeToSize(uniform->glType));
 
     memcpy(static_cast<void *>(uniform->pClientData + arrayOffset), ptr, size);
-    uniform->clientDataDirty = true;
+
+    /// Mirror the data into the block, where std140 starts every array element at a vec4 boundary
+    uniformBlock *block = mUniformBlocks[uniform->blockIndex];
+    assert(!block->isOpaque);
+
+    const size_t elementSize = GlslTypeToSize(uniform->glType);
+    const size_t arrayStride = GlslTypeToAllignment(uniform->glType);
+    size_t blockOffset = uniform->offset + (location - uniform->location) * arrayStride;
+    for(size_t copied = 0; copied < size; copied += elementSize) {
+        assert(blockOffset + elementSize <= block->blockSize);
+        memcpy(static_cast<void *>(block->pClientData + blockOffset), static_cast<const uint8_t *>(ptr) + copied, elementSize);
+        blockOffset += arrayStride;
+    }
+    block->clientDataDirty = true;
 }
 
 void
@@ -59,9 +59,8 @@ public:
         size_t                      offset;
         // uniform data
         uint8_t                    *pClientData;
-        bool                        clientDataDirty;
 
-        uniform() : location(0), blockIndex(0), arraySize(0), glType(0), offset(0), pClientData(nullptr), clientDataDirty(false)
+        uniform() : location(0), blockIndex(0), arraySize(0), glType(0), offset(0), pClientData(nullptr)
         {
             FUN_ENTRY(GL_LOG_TRACE);
         }
@@ -73,8 +72,7 @@ public:
            arraySize(size),
            glType(type),
            offset(offset),
-           pClientData(nullptr),
-           clientDataDirty(false)
+           pClientData(nullptr)
         {
             FUN_ENTRY(GL_LOG_TRACE);
         }
@@ -96,44 +94,41 @@ public:
         size_t                      blockSize;
         shader_type_t               blockStage;
         bool                        isOpaque;
+        bool                        isPushConstant;
+        bool                        isDynamic;
+        // std140 copy of the block's data
+        uint8_t                    *pClientData;
+        bool                        clientDataDirty;
 
-        size_t                      requiredSize;
-        uint32_t                    cacheIndex;
+        VkBuffer                    vkBuffer;
+        VkDeviceSize                offset;
+        uint64_t                    serial;
 
         UniformBufferObject *       pBufferObject;
 
-        uniformBlock() : binding(0), blockSize(0), blockStage(INVALID_SHADER), isOpaque(false), requiredSize(0), cacheIndex(0), pBufferObject(nullptr)
+        uniformBlock() : binding(0), blockSize(0), blockStage(INVALID_SHADER), isOpaque(false), isPushConstant(false), isDynamic(false), pClientData(nullptr), clientDataDirty(false), vkBuffer(VK_NULL_HANDLE), offset(0), serial(0), pBufferObject(nullptr)
         {
             FUN_ENTRY(GL_LOG_TRACE);
         }
 
-        uniformBlock(std::string blockName, uint32_t bind, size_t bSize, shader_type_t shaderType, bool opaque)
+        uniformBlock(std::string blockName, uint32_t bind, size_t bSize, shader_type_t shaderType, bool opaque, bool pushConstant)
          : glslBlockName(blockName),
            binding(bind),
            blockSize(bSize),
            blockStage(shaderType),
            isOpaque(opaque),
-           requiredSize(0),
-           cacheIndex(0),
+           isPushConstant(pushConstant),
+           isDynamic(false),
+           pClientData(nullptr),
+           clientDataDirty(false),
+           vkBuffer(VK_NULL_HANDLE),
+           offset(0),
+           serial(0),
            pBufferObject(nullptr)
         {
             FUN_ENTRY(GL_LOG_TRACE);
 
-            if (!opaque) {
-                assert(bSize > 0);
-                if ((bSize & (bSize - 1)) == 0) {
-                    requiredSize = bSize;
-                } else {
-                    requiredSize = 1;
-                    while (bSize) {
-                        requiredSize <<= 1;
-                        bSize >>= 1;
-                    }
-                }
-                while (requiredSize >> (cacheIndex + 1)) {
-                    ++ cacheIndex;
-                }
-            }
+            assert(opaque || bSize > 0);
         }
 
         ~uniformBlock()
@@ -144,6 +139,11 @@ public:
                 delete pBufferObject;
                 pBufferObject = nullptr;
             }
+
+            if(pClientData) {
+                delete[] pClientData;
+                pClientData = nullptr;
+            }
         }
     };
 
@@ -196,12 +196,16 @@ public:
     inline GLenum GetUniformType(uint32_t index)                                const { FUN_ENTRY(GL_LOG_TRACE); return mUniforms[index]->glType; }
     void CopyUniformClientData(uint32_t location, size_t size, void *ptr);
     inline const uint8_t* GetUniformClientData(uint32_t index)                  const { FUN_ENTRY(GL_LOG_DEBUG); return mUniforms[index]->pClientData; }
-    inline UniformBufferObject * GetUniformBufferObject(uint32_t index)         const { FUN_ENTRY(GL_LOG_DEBUG); return mUniformBlocks[index]->pBufferObject; }
     int GetUniformLocation(const char *name) const;
 
     inline uint32_t GetUniformBlockBinding(uint32_t index)                      const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlocks[index]->binding; }
     inline shader_type_t GetUniformBlockBlockStage(uint32_t index)              const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlocks[index]->blockStage; }
     inline bool IsUniformBlockOpaque(uint32_t index)                            const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlocks[index]->isOpaque; }
+    inline const uniformBlock * GetPushConstantBlock(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlocks.Size() > mLiveUniformBlocks ? mUniformBlocks[mLiveUniformBlocks] : nullptr; }
+    inline bool IsUniformBlockDynamic(uint32_t index)                           const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlocks[index]->isDynamic; }
+    inline VkDescriptorType GetUniformBlockDescriptorType(uint32_t index)       const { FUN_ENTRY(GL_LOG_TRACE); return mUniformBlocks[index]->isOpaque  ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER :
+                                                                                                                           mUniformBlocks[index]->isDynamic ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC :
+                                                                                                                                                              VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; }
 
     const ShaderResourceInterface::uniform * GetUniformAtLocation(uint32_t location);
     const ShaderResourceInterface::attribute * GetVertexAttribute(int index) const;
@@ -212,13 +216,13 @@ public:
     inline void SetCustomAttribsLayout(const char *name, int index)                   { FUN_ENTRY(GL_LOG_TRACE); mCustomAttributesLayout[std::string(name)] = index; }
     inline void SetReflectionSize(void)                                               { FUN_ENTRY(GL_LOG_TRACE); mReflectionSize = mShaderReflection->GetReflectionSize(); }
     inline void SetCacheManager(CacheManager *cacheManager)                           { FUN_ENTRY(GL_LOG_TRACE); mCacheManager = cacheManager; }
+    inline void SetUniformBlockDynamic(uint32_t index, bool dynamic)                  { FUN_ENTRY(GL_LOG_TRACE); mUniformBlocks[index]->isDynamic = dynamic; }
 
     void SetUniformClientData(uint32_t location, size_t size, const void *ptr);
     void SetSampler(uint32_t location, int count, const int *textureUnit);
 
     void AllocateUniformClientData(void);
-    bool AllocateUniformBufferObjects(const vulkanAPI::vkContext_t *vkContext);
-    bool UpdateUniformBufferData(const vulkanAPI::vkContext_t *vkContext, bool *allocatedNewBufferObject);
+    bool UpdateUniformBufferData(const vulkanAPI::vkContext_t *vkContext, vulkanAPI::CommandBufferManager *cbManager, bool *updatedDescriptors);
 
     void UpdateAttributeInterface(void);
     void CreateInterface(void);
@@ -25,6 +25,12 @@
  *  A texture can be used in two ways: (a) it can be the source of a texture
  *  access from a Shader or (b) it can be used as an attachment.
  *
+ *  The pixels of a level are kept on the host only until they are uploaded.
+ *  From then on the Vulkan image is the only copy: sub-image updates are
+ *  uploaded in place, readbacks copy from the image, and when the image has
+ *  to be created again (e.g. for more mip levels or another usage) the
+ *  resident levels are copied over from the old image on the GPU.
+ *
  */
 
 #include "texture.h"
@@ -33,6 +39,15 @@
 #include "utils/cacheManager.h"
 
 #define NUMBER_OF_MIP_LEVELS(w, h)                      (std::floor(std::log2(std::max((w),(h)))) + 1)
+// Offset alignment of the staged uploads. It is a multiple of 4 and of
+// every texel and compressed block size, as vkCmdCopyBufferToImage requires
+#define GLOVE_STAGING_COPY_ALIGNMENT                    48
+
+// Updates up to this size are queued and merged into a single copy, recorded
+// before the texture is next sampled, rendered, transferred or reallocated
+#define GLOVE_QUEUED_UPLOAD_MAX_SIZE                    (64 * 1024)
+// Queued updates are recorded once their data would exceed this size
+#define GLOVE_QUEUED_UPLOAD_QUEUE_SIZE                  (1024 * 1024)
 
 // TODO:: this needs to be further discussed
 int Texture::mDefaultInternalAlignment = 1;
@@ -42,7 +57,8 @@ Texture::Texture(const vulkanAPI::vkContext_t *vkContext, vulkanAPI::CommandBuff
 mFormat(GL_INVALID_VALUE), mTarget(GL_INVALID_VALUE), mType(GL_INVALID_VALUE), mInternalFormat(GL_INVALID_VALUE),
 mExplicitType(GL_INVALID_VALUE), mExplicitInternalFormat(GL_INVALID_VALUE),
 mMipLevelsCount(1), mLayersCount(1), mState(nullptr), mDataUpdated(false), mDataNoInvertion(false), mFboColorAttached(false), mIsNPOT(false), mIsNPOTAccessCompleted(false),
-mDepthStencilTexture(nullptr), mDepthStencilTextureRefCount(0u), mDirty(false)
+mDepthStencilTexture(nullptr), mDepthStencilTextureRefCount(0u), mDirty(false), mReadSerial(0),
+mAllocatedVkFormat(VK_FORMAT_UNDEFINED), mAllocatedVkUsage(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -50,6 +66,8 @@ mDepthStencilTexture(nullptr), mDepthStencilTextureRefCount(0u), mDirty(false)
     mImageView = new vulkanAPI::ImageView(vkContext);
     mMemory    = new vulkanAPI::Memory(vkContext, vkFlags);
     mSampler   = new vulkanAPI::Sampler(vkContext);
+
+    mMemory->SetCategory(vulkanAPI::DEVICE_MEMORY_CATEGORY_TEXTURE);
 }
 
 Texture::~Texture()
@@ -144,6 +162,36 @@ Texture::IsCompleted(void)
     return true;
 }
 
+bool
+Texture::IsLevelResident(GLint level, GLint layer) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mState == nullptr || layer >= mLayersCount || level >= static_cast<GLint>(mState[layer].Size())) {
+        return false;
+    }
+
+    return level < mMipLevelsCount && mState[layer][level]->resident && IsVkTextureCompatible();
+}
+
+bool
+Texture::IsReadPending(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return mCommandBufferManager != nullptr && mReadSerial == mCommandBufferManager->GetActiveSerial();
+}
+
+void
+Texture::SetReadSerial(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mCommandBufferManager != nullptr) {
+        mReadSerial = mCommandBufferManager->GetActiveSerial();
+    }
+}
+
 bool
 Texture::IsValid(void)
 {
@@ -227,7 +275,7 @@ Texture::AllocateVkMemory(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    mMemory->GetImageMemoryRequirements(mImage->GetImage());
+    mMemory->GetImageMemoryRequirements(mImage->GetImage(), mImage->GetImageTiling());
 
     return mMemory->Create() && mMemory->BindImageMemory(mImage->GetImage());
 }
@@ -254,16 +302,145 @@ Texture::CreateVkTexture(void)
         return false;
     }
 
-    PrepareVkImageLayout(VK_IMAGE_LAYOUT_GENERAL);
+    // a new image is first written by the copies of the upload stream
+    PrepareVkImageLayout(VK_IMAGE_LAYOUT_GENERAL, vulkanAPI::CMD_STREAM_UPLOAD);
+
+    mAllocatedVkFormat = mImage->GetFormat();
+    mAllocatedVkUsage  = mImage->GetImageUsage();
+
+    return true;
+}
+
+bool
+Texture::IsVkTextureCompatible(void) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return mImage->GetImage()      != VK_NULL_HANDLE                          &&
+           mImage->GetWidth()      == static_cast<uint32_t>(GetWidth())       &&
+           mImage->GetHeight()     == static_cast<uint32_t>(GetHeight())      &&
+           mImage->GetMipLevels()  == static_cast<uint32_t>(mMipLevelsCount)  &&
+           mImage->GetFormat()     == mAllocatedVkFormat                      &&
+           mImage->GetImageUsage() == mAllocatedVkUsage;
+}
+
+bool
+Texture::CanReleaseHostData(void) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the levels of an image created again are copied from the old one, which
+    // must then outlive the copy and be usable as a transfer source
+    const VkImageUsageFlags transferUsage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    return mCacheManager != nullptr                                &&
+           (mImage->GetImageUsage() & transferUsage) == transferUsage &&
+           VkFormatIsColor(mImage->GetFormat());
+}
+
+bool
+Texture::HasResidentLevels(void) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(GLint layer = 0; layer < mLayersCount; ++layer) {
+        for(uint32_t level = 0; level < mState[layer].Size(); ++level) {
+            if(mState[layer][level]->resident) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool
+Texture::CopyResidentLevels(vulkanAPI::Image *srcImage)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // only levels keeping their dimensions in the new image are copied, the rest is lost
+    std::vector<VkImageCopy> regions;
+    std::vector<State_t *>   copiedStates;
+    for(GLint layer = 0; layer < mLayersCount; ++layer) {
+        for(GLint level = 0; level < static_cast<GLint>(mState[layer].Size()); ++level) {
+            State_t *state = mState[layer][level];
+            if(!state->resident) {
+                continue;
+            }
+            state->resident = false;
+
+            if(level >= mMipLevelsCount || level >= static_cast<GLint>(srcImage->GetMipLevels()) ||
+               state->width  != static_cast<GLint>(std::max(srcImage->GetWidth()  >> level, 1u)) ||
+               state->height != static_cast<GLint>(std::max(srcImage->GetHeight() >> level, 1u)) ||
+               state->width  != std::max(GetWidth()  >> level, 1) ||
+               state->height != std::max(GetHeight() >> level, 1)) {
+                continue;
+            }
+
+            VkImageCopy region;
+            memset(static_cast<void *>(&region), 0, sizeof(region));
+            region.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.srcSubresource.mipLevel       = level;
+            region.srcSubresource.baseArrayLayer = layer;
+            region.srcSubresource.layerCount     = 1;
+            region.dstSubresource                = region.srcSubresource;
+            region.extent.width                  = state->width;
+            region.extent.height                 = state->height;
+            region.extent.depth                  = 1;
+            regions.push_back(region);
+            copiedStates.push_back(state);
+        }
+    }
+
+    if(regions.empty()) {
+        return true;
+    }
+
+    VkCommandBuffer *uploadCmdBuffer = mCommandBufferManager->BeginVkUploadCommandBuffer();
+    if(uploadCmdBuffer == nullptr) {
+        return false;
+    }
+
+    mImage->ModifyImageSubresourceRange(0, mMipLevelsCount, 0, mLayersCount);
+    VkImageLayout imageLayout = mImage->GetImageLayout();
+    imageLayout = (imageLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                   imageLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? imageLayout : VK_IMAGE_LAYOUT_GENERAL;
+
+    // recorded ahead of the draws of the active submission, which the old image outlives
+    srcImage->ModifyImageSubresourceRange(0, srcImage->GetMipLevels(), 0, srcImage->GetLayers());
+    srcImage->ModifyImageLayout(uploadCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    mImage->ModifyImageLayout(uploadCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    srcImage->CopyImage(uploadCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        mImage->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        static_cast<uint32_t>(regions.size()), regions.data());
+    mImage->ModifyImageLayout(uploadCmdBuffer, imageLayout);
+
+    for(auto state : copiedStates) {
+        state->resident = true;
+    }
 
     return true;
 }
 
+void
+Texture::ReleaseState(State_t *state)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(state->data) {
+        delete [] (uint8_t *)state->data;
+        state->data = nullptr;
+    }
+}
+
 bool
 Texture::Allocate(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    FlushQueuedUploads();
+
     State_t *state = mState[0][0];
 
     SetWidth (state->width);
@@ -278,11 +455,65 @@ Texture::Allocate(void)
     mExplicitInternalFormat = VkFormatToGlInternalformat(mImage->GetFormat());
     mExplicitType           = GlInternalFormatToGlType(mExplicitInternalFormat);
 
-    if(!CreateVkTexture()) {
-        return false;
+    // an image that still fits the texture is kept, so that only the levels
+    // specified since are uploaded
+    if(!IsVkTextureCompatible()) {
+        vulkanAPI::Image  *oldImage  = nullptr;
+        vulkanAPI::Memory *oldMemory = nullptr;
+
+        // the old image can only be copied from as it was created
+        if(CanReleaseHostData() && HasResidentLevels() &&
+           mImage->GetImage() != VK_NULL_HANDLE        &&
+           mImage->GetFormat() == mAllocatedVkFormat   &&
+           (mAllocatedVkUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+            oldImage  = mImage;
+            oldMemory = mMemory;
+
+            mImage = new vulkanAPI::Image(mVkContext);
+            mImage->SetFormat(oldImage->GetFormat());
+            mImage->SetImageUsage(oldImage->GetImageUsage());
+            mImage->SetImageTiling(oldImage->GetImageTiling());
+            mImage->SetImageTarget(oldImage->GetImageTarget());
+            mImage->SetCacheManager(mCacheManager);
+
+            mMemory = new vulkanAPI::Memory(mVkContext, oldMemory->GetFlags());
+            mMemory->SetCategory(oldMemory->GetCategory());
+            mMemory->SetCacheManager(mCacheManager);
+        }
+
+        bool created = CreateVkTexture();
+
+        if(oldImage != nullptr) {
+            if(created) {
+                created = CopyResidentLevels(oldImage);
+            }
+
+            // destroyed once the submission copying from them has completed
+            delete oldImage;
+            delete oldMemory;
+        }
+
+        if(!created) {
+            for(GLint layer = 0; layer < mLayersCount; ++layer) {
+                for(uint32_t level = 0; level < mState[layer].Size(); ++level) {
+                    mState[layer][level]->resident = false;
+                }
+            }
+            return false;
+        }
+
+        // without a copy the new image starts out empty, levels still on the host are uploaded again
+        if(oldImage == nullptr) {
+            for(GLint layer = 0; layer < mLayersCount; ++layer) {
+                for(uint32_t level = 0; level < mState[layer].Size(); ++level) {
+                    mState[layer][level]->resident = false;
+                }
+            }
+        }
     }
 
-    bool isCompressed = GlInternalFormatIsCompressed(mExplicitInternalFormat);
+    bool isCompressed    = GlInternalFormatIsCompressed(mExplicitInternalFormat);
+    bool releaseHostData = CanReleaseHostData();
 
     // NOTE:: there is an implicit conversion of all textures to GL_RGBA
     // TODO:: this should definitely NOT be the case
@@ -292,9 +523,11 @@ Texture::Allocate(void)
     for(GLint layer = 0; layer < mLayersCount; ++layer) {
         for(GLint level = 0; level < mMipLevelsCount; ++level) {
             state = mState[layer][level];
-            if(!state->data) {
+            if(state->resident || !state->data) {
+                state->resident = true;
                 continue;
             }
+            state->resident = true;
             if (isCompressed) {
                 Rect srcRect(0, 0, state->width, state->height);
                 CpoyCompressedPixelFromHost(&srcRect, level, layer, srcInternalFormat, state->data, state->size);
@@ -309,6 +542,11 @@ Texture::Allocate(void)
                                   Texture::GetDefaultInternalAlignment());
                 CopyPixelsFromHost(&srcRect, &dstRect, level, layer, srcInternalFormat, state->data);
             }
+
+            // the image holds the only copy from now on
+            if(releaseHostData) {
+                ReleaseState(state);
+            }
         }
     }
 
@@ -343,10 +581,8 @@ Texture::SetState(GLsizei width, GLsizei height, GLint level, GLint layer, GLenu
         UpdateNPOTAccessCompleted();
     }
 
-    if(mState[layer][level]->data) {
-        delete [] (uint8_t *)mState[layer][level]->data;
-        mState[layer][level]->data = nullptr;
-    }
+    ReleaseState(mState[layer][level]);
+    mState[layer][level]->resident = false;
 
     if(pixels) {
         // convert the pixel buffers to the internal alignment
@@ -377,6 +613,40 @@ Texture::SetSubState(ImageRect *srcRect, ImageRect *dstRect, GLint level, GLint
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    State_t *state = mState[layer][level];
+
+    // the host copy of a resident level is gone, so the subrectangle
+    // is converted to the image format and uploaded in place
+    if(state->resident && state->data == nullptr) {
+        if(srcData) {
+            ImageRect tmp_srcRect = *srcRect;
+            ImageRect tmp_dstRect(0, 0, dstRect->width, dstRect->height,
+                                  (int)(GlInternalFormatTypeToNumElements(mExplicitInternalFormat, mExplicitType)),
+                                  (int)(GlTypeToElementSize(mExplicitType)),
+                                  Texture::GetDefaultInternalAlignment());
+            tmp_srcRect.x = 0; tmp_srcRect.y = 0;
+
+            const size_t dstSize = tmp_dstRect.GetRectBufferSize();
+            uint8_t *dstData = new uint8_t[dstSize];
+            ConvertPixels(srcFormat, mExplicitInternalFormat,
+                          &tmp_srcRect, srcData,
+                          &tmp_dstRect, dstData);
+
+            if(mFboColorAttached) {
+                InvertImageYAxis(dstData, &tmp_dstRect);
+            }
+            mFboColorAttached = false;
+
+            tmp_dstRect.x = dstRect->x;
+            tmp_dstRect.y = dstRect->y;
+            UploadPixels(&tmp_dstRect, dstData, dstSize, level, layer, mExplicitInternalFormat);
+            delete[] dstData;
+        }
+
+        SetDataUpdated(true);
+        return;
+    }
+
     if(mState[layer][level]->data == nullptr) {
         ImageRect srcRect(0, 0, mState[layer][level]->width, mState[layer][level]->height,
                           (int)(GlInternalFormatTypeToNumElements(GetInternalFormat(), GetType())),
@@ -419,6 +689,16 @@ Texture::SetSubState(ImageRect *srcRect, ImageRect *dstRect, GLint level, GLint
 
         CopyPixelsNoConversion(&tmp_srcRect, dstData,
                               &tmp_dstRect, mState[layer][level]->data);
+
+        // a resident level that kept its host copy is patched on both sides
+        if(state->resident) {
+            ImageRect uploadSrcRect = *dstRect;
+            ImageRect uploadDstRect(dstRect->x, dstRect->y, dstRect->width, dstRect->height,
+                                    (int)(GlInternalFormatTypeToNumElements(mExplicitInternalFormat, mExplicitType)),
+                                    (int)(GlTypeToElementSize(mExplicitType)),
+                                    Texture::GetDefaultInternalAlignment());
+            CopyPixelsFromHost(&uploadSrcRect, &uploadDstRect, level, layer, dstFormat, dstData);
+        }
         delete[] dstData;
     }
 
@@ -454,10 +734,8 @@ Texture::SetCompressedState(GLsizei width, GLsizei height, GLint level, GLint la
         UpdateNPOTAccessCompleted();
     }
 
-    if (mState[layer][level]->data) {
-        delete[](uint8_t *)mState[layer][level]->data;
-        mState[layer][level]->data = nullptr;
-    }
+    ReleaseState(mState[layer][level]);
+    mState[layer][level]->resident = false;
 
     if (imageData) {
         uint8_t *data = new uint8_t[size];
@@ -475,6 +753,8 @@ Texture::CopyPixelsToHost(ImageRect *srcRect, ImageRect *dstRect, GLint miplevel
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    FlushQueuedUploads();
+
     const GLenum srcFormat = mExplicitInternalFormat;
 
     // create a buffer at the size of the requested subrectangle
@@ -526,13 +806,9 @@ Texture::CopyPixelsFromHost(ImageRect *srcRect, ImageRect *dstRect, GLint miplev
                   &tmp_srcRect, srcData,
                   &tmp_dstRect, dstData);
 
-    BufferObject *tbo = new TransferSrcBufferObject(mVkContext);
-    tbo->Allocate(dstSize, dstData);
-
     // use the global rect offsets for transfering the subpixels to Vulkan
-    SubmitCopyPixels(dstRect, tbo, miplevel, layer, dstFormat, true);
+    UploadPixels(dstRect, dstData, dstSize, miplevel, layer, dstFormat);
 
-    delete    tbo;
     delete[]  dstData;
 
 #if GLOVE_SAVE_TEXTURES_TO_FILE == true
@@ -559,11 +835,30 @@ Texture::CopyPixelsFromHost(ImageRect *srcRect, ImageRect *dstRect, GLint miplev
 void
 Texture::CpoyCompressedPixelFromHost(Rect *srcRect, GLint miplevel, GLint layer, GLenum format, const void *srcData, GLsizei dataSize)
 {
-    BufferObject *tbo = new TransferSrcBufferObject(mVkContext);
-    tbo->Allocate(dataSize, srcData);
+    FUN_ENTRY(GL_LOG_DEBUG);
 
     // use the global rect offsets for transfering the subpixels to Vulkan
-    SubmitCopyPixels(srcRect, tbo, miplevel, layer, format, true);
+    UploadPixels(srcRect, srcData, dataSize, miplevel, layer, format);
+}
+
+void
+Texture::UploadPixels(const Rect *rect, const void *srcData, size_t srcSize, GLint miplevel, GLint layer, GLenum format)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // srcData is already in the image format and covers exactly the rect
+    if(QueueUploadPixels(rect, srcData, srcSize, miplevel, layer)) {
+        return;
+    }
+
+    if(!SubmitUploadPixels(rect, srcData, srcSize, miplevel, layer)) {
+        BufferObject *tbo = new TransferSrcBufferObject(mVkContext);
+        tbo->Allocate(srcSize, srcData);
+
+        SubmitCopyPixels(rect, tbo, miplevel, layer, format, true);
+
+        delete tbo;
+    }
 }
 
 void 
@@ -571,6 +866,8 @@ Texture::SubmitCopyPixels(const Rect *rect, BufferObject *tbo, GLint miplevel, G
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    FlushQueuedUploads();
+
     mImage->CreateBufferImageCopy(rect->x, rect->y, rect->width, rect->height, miplevel, layer, 1);
     mImage->ModifyImageSubresourceRange(miplevel, 1, layer, 1);
 
@@ -595,24 +892,188 @@ Texture::SubmitCopyPixels(const Rect *rect, BufferObject *tbo, GLint miplevel, G
     mCommandBufferManager->WaitVkAuxCommandBuffer();
 }
 
-void
-Texture::PrepareVkImageLayout(VkImageLayout newImageLayout)
+bool
+Texture::SubmitUploadPixels(const Rect *rect, const void *srcData, size_t srcSize, GLint miplevel, GLint layer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // the image of a texture without a cache manager is released
+    // immediately, so it must not outlive a deferred upload
+    if(mCacheManager == nullptr) {
+        return false;
+    }
+
+    FlushQueuedUploads();
+
+    VkBuffer     stagingBuffer;
+    VkDeviceSize stagingOffset;
+    if(!mCommandBufferManager->AllocateStagingMemory(srcSize, GLOVE_STAGING_COPY_ALIGNMENT, srcData, &stagingBuffer, &stagingOffset)) {
+        return false;
+    }
+
+    VkCommandBuffer *uploadCmdBuffer = mCommandBufferManager->BeginVkUploadCommandBuffer();
+    if(uploadCmdBuffer == nullptr) {
+        return false;
+    }
+
+    mImage->CreateBufferImageCopy(rect->x, rect->y, rect->width, rect->height, miplevel, layer, 1);
+    mImage->GetBufferImageCopy()->bufferOffset = stagingOffset;
+    mImage->ModifyImageSubresourceRange(miplevel, 1, layer, 1);
+
+    VkImageLayout oldImageLayout = mImage->GetImageLayout();
+    oldImageLayout = (oldImageLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                      oldImageLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? oldImageLayout : VK_IMAGE_LAYOUT_GENERAL;
+
+    // the copy is executed ahead of the next draw or aux submission, without
+    // blocking here for its completion
+    mImage->ModifyImageLayout(uploadCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    mImage->CopyBufferToImage(uploadCmdBuffer, stagingBuffer);
+    mImage->ModifyImageLayout(uploadCmdBuffer, oldImageLayout);
+
+    return true;
+}
+
+bool
+Texture::QueueUploadPixels(const Rect *rect, const void *srcData, size_t srcSize, GLint miplevel, GLint layer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if (newImageLayout == mImage->GetImageLayout()) {
+    // the queue is recorded as a deferred upload, see SubmitUploadPixels
+    if(mCacheManager == nullptr || srcSize > GLOVE_QUEUED_UPLOAD_MAX_SIZE) {
+        return false;
+    }
+
+    if(mQueuedData.size() + GLOVE_STAGING_COPY_ALIGNMENT + srcSize > GLOVE_QUEUED_UPLOAD_QUEUE_SIZE) {
+        FlushQueuedUploads();
+    }
+
+    vulkanAPI::uploadStats_t *stats = mCommandBufferManager->GetUploadStats();
+    ++stats->queuedUpdates;
+
+    // a queued update entirely covered by this one would be overwritten anyway,
+    // while a partly covered one must be copied first, as the regions of a
+    // single copy must not overlap
+    bool overlaps = false;
+    for(size_t i = 0; i < mQueuedRegions.size();) {
+        const VkBufferImageCopy &region = mQueuedRegions[i];
+        const int32_t left   = region.imageOffset.x;
+        const int32_t top    = region.imageOffset.y;
+        const int32_t right  = left + static_cast<int32_t>(region.imageExtent.width);
+        const int32_t bottom = top  + static_cast<int32_t>(region.imageExtent.height);
+        if(region.imageSubresource.mipLevel       != static_cast<uint32_t>(miplevel) ||
+           region.imageSubresource.baseArrayLayer != static_cast<uint32_t>(layer)    ||
+           right <= rect->x || left >= rect->x + rect->width || bottom <= rect->y || top >= rect->y + rect->height) {
+            ++i;
+        } else if(left >= rect->x && right <= rect->x + rect->width && top >= rect->y && bottom <= rect->y + rect->height) {
+            mQueuedRegions.erase(mQueuedRegions.begin() + i);
+            mQueuedSizes.erase(mQueuedSizes.begin() + i);
+            ++stats->supersededUpdates;
+        } else {
+            overlaps = true;
+            ++i;
+        }
+    }
+
+    if(overlaps) {
+        FlushQueuedUploads();
+    }
+
+    const size_t offset = (mQueuedData.size() + GLOVE_STAGING_COPY_ALIGNMENT - 1) / GLOVE_STAGING_COPY_ALIGNMENT * GLOVE_STAGING_COPY_ALIGNMENT;
+    mQueuedData.resize(offset + srcSize);
+    memcpy(mQueuedData.data() + offset, srcData, srcSize);
+
+    mImage->CreateBufferImageCopy(rect->x, rect->y, rect->width, rect->height, miplevel, layer, 1);
+    mQueuedRegions.push_back(*mImage->GetBufferImageCopy());
+    mQueuedRegions.back().bufferOffset = offset;
+    mQueuedSizes.push_back(srcSize);
+
+    return true;
+}
+
+void
+Texture::FlushQueuedUploads(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mQueuedRegions.empty()) {
+        mQueuedData.clear();
         return;
     }
 
-    mCommandBufferManager->BeginVkAuxCommandBuffer();
-    VkCommandBuffer cmdBuffer = mCommandBufferManager->GetAuxCommandBuffer();
+    // taken out of the queue first, as the fallback path below flushes it too
+    std::vector<VkBufferImageCopy> regions;
+    std::vector<size_t>            sizes;
+    std::vector<uint8_t>           data;
+    regions.swap(mQueuedRegions);
+    sizes.swap(mQueuedSizes);
+    data.swap(mQueuedData);
+
+    VkBuffer         stagingBuffer;
+    VkDeviceSize     stagingOffset;
+    VkCommandBuffer *uploadCmdBuffer = nullptr;
+    if(mCommandBufferManager->AllocateStagingMemory(data.size(), GLOVE_STAGING_COPY_ALIGNMENT, data.data(), &stagingBuffer, &stagingOffset)) {
+        uploadCmdBuffer = mCommandBufferManager->BeginVkUploadCommandBuffer();
+    }
 
-    mImage->ModifyImageSubresourceRange(0, mMipLevelsCount, 0, mLayersCount);
-    mImage->ModifyImageLayout(&cmdBuffer, newImageLayout);
+    if(uploadCmdBuffer == nullptr) {
+        for(size_t i = 0; i < regions.size(); ++i) {
+            const VkBufferImageCopy &region = regions[i];
+            Rect rect(region.imageOffset.x, region.imageOffset.y, region.imageExtent.width, region.imageExtent.height);
 
-    mCommandBufferManager->EndVkAuxCommandBuffer();
-    mCommandBufferManager->SubmitVkAuxCommandBuffer();
-    mCommandBufferManager->WaitVkAuxCommandBuffer();
+            BufferObject *tbo = new TransferSrcBufferObject(mVkContext);
+            tbo->Allocate(sizes[i], data.data() + region.bufferOffset);
+
+            SubmitCopyPixels(&rect, tbo, region.imageSubresource.mipLevel, region.imageSubresource.baseArrayLayer, mExplicitInternalFormat, true);
+
+            delete tbo;
+        }
+        return;
+    }
+
+    // the layouts are restored per subresource after a single copy of all regions
+    std::vector<VkImageLayout> oldImageLayouts(regions.size());
+    for(size_t i = 0; i < regions.size(); ++i) {
+        mImage->ModifyImageSubresourceRange(regions[i].imageSubresource.mipLevel, 1, regions[i].imageSubresource.baseArrayLayer, 1);
+        VkImageLayout oldImageLayout = mImage->GetImageLayout();
+        oldImageLayouts[i] = (oldImageLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                              oldImageLayout != VK_IMAGE_LAYOUT_PREINITIALIZED) ? oldImageLayout : VK_IMAGE_LAYOUT_GENERAL;
+    }
+
+    vulkanAPI::PipelineBarrier dstBarrier;
+    for(auto &region : regions) {
+        mImage->ModifyImageSubresourceRange(region.imageSubresource.mipLevel, 1, region.imageSubresource.baseArrayLayer, 1);
+        mImage->ModifyImageLayout(&dstBarrier, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        region.bufferOffset += stagingOffset;
+    }
+    dstBarrier.Flush(uploadCmdBuffer);
+
+    mImage->CopyBufferToImage(uploadCmdBuffer, stagingBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              static_cast<uint32_t>(regions.size()), regions.data());
+
+    vulkanAPI::PipelineBarrier oldBarrier;
+    for(size_t i = 0; i < regions.size(); ++i) {
+        mImage->ModifyImageSubresourceRange(regions[i].imageSubresource.mipLevel, 1, regions[i].imageSubresource.baseArrayLayer, 1);
+        mImage->ModifyImageLayout(&oldBarrier, oldImageLayouts[i]);
+    }
+    oldBarrier.Flush(uploadCmdBuffer);
+
+    vulkanAPI::uploadStats_t *stats = mCommandBufferManager->GetUploadStats();
+    ++stats->copyCommands;
+    stats->copyRegions += static_cast<uint32_t>(regions.size());
+    stats->copyBytes   += data.size();
+}
+
+void
+Texture::PrepareVkImageLayout(VkImageLayout newImageLayout, vulkanAPI::cmdStream_t stream)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    FlushQueuedUploads();
+
+    // subresources already in the requested layout are skipped and the
+    // rest is batched with the other transitions of the same command stream
+    mImage->ModifyImageSubresourceRange(0, mMipLevelsCount, 0, mLayersCount);
+    mImage->ModifyImageLayout(mCommandBufferManager->GetPendingBarrier(stream), newImageLayout);
 }
 
 void
@@ -643,32 +1104,62 @@ Texture::GenerateMipmaps(GLenum hintMipmapMode)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    int numElements = (int)GlInternalFormatTypeToNumElements(GetExplicitInternalFormat(), GetExplicitType());
-    int sizeElement = (int)GlTypeToElementSize(GetExplicitType());
-    int alignment   = Texture::GetDefaultInternalAlignment();
-    ImageRect srcRect(0, 0, GetWidth(), GetHeight(), numElements, sizeElement, alignment);
-    ImageRect dstRect(0, 0, GetWidth(), GetHeight(), numElements, sizeElement, alignment);
+    FlushQueuedUploads();
 
-    const size_t     baseLevel  = 0;
-    const size_t     baseSize   = dstRect.GetRectBufferSize();
-          uint8_t  **basePixels = new uint8_t*[mLayersCount];
+    const GLint mipLevelsCount = (GLint)NUMBER_OF_MIP_LEVELS(GetWidth(), GetHeight());
+
+    // the levels below the base one are generated on the GPU and live in the image only
     for(GLint layer = 0; layer < mLayersCount; ++layer) {
-        basePixels[layer] = new uint8_t[baseSize];
-        CopyPixelsToHost(&srcRect, &dstRect, baseLevel, layer, GetExplicitInternalFormat(), basePixels[layer]);
+        const State_t *baseState = mState[layer][0];
+        for(GLint level = 1; level < mipLevelsCount; ++level) {
+            State_t *state = mState[layer][level];
+            ReleaseState(state);
+            state->width    = std::max(baseState->width  >> level, 1);
+            state->height   = std::max(baseState->height >> level, 1);
+            state->format   = baseState->format;
+            state->type     = baseState->type;
+            state->resident = false;
+        }
     }
 
-    // create Mipmapped Texture
-    mMipLevelsCount = (GLint)NUMBER_OF_MIP_LEVELS(GetWidth(), GetHeight());
-    CreateVkTexture();
-
-    // set back base mipLevel for all layers
+    bool baseOnHost = true;
     for(GLint layer = 0; layer < mLayersCount; ++layer) {
-        InvertImageYAxis(static_cast<uint8_t *>(basePixels[layer]), &srcRect);
-        CopyPixelsFromHost(&srcRect, &dstRect, baseLevel, layer, GetExplicitInternalFormat(), basePixels[layer]);
-        delete[] basePixels[layer];
+        baseOnHost = baseOnHost && mState[layer][0]->data != nullptr;
     }
 
-    delete [] basePixels;
+    // create Mipmapped Texture, with the base level either copied from the
+    // old image or uploaded from its host copy
+    if(baseOnHost || (CanReleaseHostData() && HasResidentLevels())) {
+        mMipLevelsCount = mipLevelsCount;
+        Allocate();
+    } else {
+        int numElements = (int)GlInternalFormatTypeToNumElements(GetExplicitInternalFormat(), GetExplicitType());
+        int sizeElement = (int)GlTypeToElementSize(GetExplicitType());
+        int alignment   = Texture::GetDefaultInternalAlignment();
+        ImageRect srcRect(0, 0, GetWidth(), GetHeight(), numElements, sizeElement, alignment);
+        ImageRect dstRect(0, 0, GetWidth(), GetHeight(), numElements, sizeElement, alignment);
+
+        const size_t     baseLevel  = 0;
+        const size_t     baseSize   = dstRect.GetRectBufferSize();
+              uint8_t  **basePixels = new uint8_t*[mLayersCount];
+        for(GLint layer = 0; layer < mLayersCount; ++layer) {
+            basePixels[layer] = new uint8_t[baseSize];
+            CopyPixelsToHost(&srcRect, &dstRect, baseLevel, layer, GetExplicitInternalFormat(), basePixels[layer]);
+        }
+
+        mMipLevelsCount = mipLevelsCount;
+        CreateVkTexture();
+
+        // set back base mipLevel for all layers
+        for(GLint layer = 0; layer < mLayersCount; ++layer) {
+            InvertImageYAxis(static_cast<uint8_t *>(basePixels[layer]), &srcRect);
+            CopyPixelsFromHost(&srcRect, &dstRect, baseLevel, layer, GetExplicitInternalFormat(), basePixels[layer]);
+            mState[layer][baseLevel]->resident = true;
+            delete[] basePixels[layer];
+        }
+
+        delete [] basePixels;
+    }
 
     // Blit LoD Level '0' to rest layers
     VkImageBlit imageBlit;
@@ -721,5 +1212,9 @@ Texture::GenerateMipmaps(GLenum hintMipmapMode)
     mCommandBufferManager->SubmitVkAuxCommandBuffer();
     mCommandBufferManager->WaitVkAuxCommandBuffer();
 
-    // TODO: Fill the 'State_t' with the rest mipLevels
+    for(GLint layer = 0; layer < mLayersCount; ++layer) {
+        for(GLint level = 1; level < mMipLevelsCount; ++level) {
+            mState[layer][level]->resident = true;
+        }
+    }
 }
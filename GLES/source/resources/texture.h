@@ -39,6 +39,8 @@ class CacheManager;
 
 class Texture {
 
+    /// data holds the pixels of a level until they are uploaded. Once the
+    /// level is resident, its contents are kept in the Vulkan image only.
     struct State {
         GLint                      width;
         GLint                      height;
@@ -46,9 +48,10 @@ class Texture {
         GLenum                     type;
         void                       *data;
         GLsizei                    size;
+        bool                       resident;
 
         State() : width(-1), height(-1), format(GL_INVALID_VALUE), type(GL_INVALID_VALUE),
-            data(nullptr), size(0){ FUN_ENTRY(GL_LOG_TRACE); }
+            data(nullptr), size(0), resident(false) { FUN_ENTRY(GL_LOG_TRACE); }
         ~State() { FUN_ENTRY(GL_LOG_TRACE); if(data) {delete [] (uint8_t *)data; data = nullptr;}}
     };
     typedef State                   State_t;
@@ -87,6 +90,14 @@ private:
     uint32_t                    mDepthStencilTextureRefCount;
 
     bool                        mDirty;
+    uint64_t                    mReadSerial;
+
+    VkFormat                    mAllocatedVkFormat;
+    VkImageUsageFlags           mAllocatedVkUsage;
+
+    std::vector<VkBufferImageCopy> mQueuedRegions;
+    std::vector<size_t>         mQueuedSizes;
+    std::vector<uint8_t>        mQueuedData;
 
     vulkanAPI::Image*           mImage;
     vulkanAPI::Memory*          mMemory;
@@ -97,6 +108,12 @@ private:
 
     bool                        AllocateVkMemory(void);
     void                        ReleaseVkResources(void);
+    bool                        IsVkTextureCompatible(void)             const;
+    bool                        CanReleaseHostData(void)                const;
+    bool                        HasResidentLevels(void)                 const;
+    bool                        CopyResidentLevels(vulkanAPI::Image *srcImage);
+    void                        ReleaseState(State_t *state);
+    bool                        QueueUploadPixels(const Rect *rect, const void *srcData, size_t srcSize, GLint miplevel, GLint layer);
 
 public:
     Texture(const vulkanAPI::vkContext_t  *vkContext = nullptr, vulkanAPI::CommandBufferManager *cbManager = nullptr,
@@ -117,7 +134,8 @@ public:
 // Helper Functions
     static int              GetDefaultInternalAlignment()                       { FUN_ENTRY(GL_LOG_TRACE); return mDefaultInternalAlignment; }
     inline int              GetInvertedYOrigin(const Rect* rect)                { FUN_ENTRY(GL_LOG_TRACE); return mDims.height - rect->height - rect->y; }
-    void                    PrepareVkImageLayout(VkImageLayout newImageLayout);
+    void                    PrepareVkImageLayout(VkImageLayout newImageLayout, vulkanAPI::cmdStream_t stream = vulkanAPI::CMD_STREAM_DRAW);
+    void                    SetReadSerial(void);
 
 // Create Functions
     bool                    CreateVkTexture(void);
@@ -131,6 +149,9 @@ public:
      void                   CpoyCompressedPixelFromHost(Rect *srcRect, GLint miplevel, GLint layer, GLenum format, const void *srcData, GLsizei dataSize);
      void                   CopyPixelsToHost   (ImageRect *srcRect, ImageRect *dstRect, GLint miplevel, GLint layer, GLenum dstFormat, void *dstData);
      void                   SubmitCopyPixels   (const Rect *rect, BufferObject *tbo, GLint miplevel, GLint layer, GLenum dstFormat, bool copyToImage);
+     bool                   SubmitUploadPixels (const Rect *rect, const void *srcData, size_t srcSize, GLint miplevel, GLint layer);
+     void                   UploadPixels       (const Rect *rect, const void *srcData, size_t srcSize, GLint miplevel, GLint layer, GLenum format);
+     void                   FlushQueuedUploads (void);
      void                   InvertPixels       (void);
 
 // Get Functions
@@ -230,6 +251,8 @@ public:
     inline bool             IsNPOTAccessCompleted(void)                 const   { FUN_ENTRY(GL_LOG_TRACE); return mIsNPOTAccessCompleted; }
            bool             IsCompleted(void);
            bool             IsValid(void);
+           bool             IsLevelResident(GLint level, GLint layer)   const;
+           bool             IsReadPending(void)                         const;
 };
 
 #endif // __TEXTURE_H__
@@ -25,153 +25,218 @@
 #include "resources/bufferObject.h"
 #include "resources/uniformBufferObject.h"
 #include "resources/texture.h"
+#include "vulkan/cbManager.h"
+#include "vulkan/deviceAllocator.h"
 
-CacheManager::CacheManager(const vulkanAPI::vkContext_t *vkContext) 
-: mVkContext(vkContext) 
+CacheManager::FrameCaches::FrameCaches()
+: serial(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uboCache.Reserve(DEFAULT_COUNT);
+    vboCache.Reserve(DEFAULT_COUNT);
+    textureCache.Reserve(DEFAULT_COUNT);
+    vkImageViewCache.Reserve(DEFAULT_COUNT);
+    vkFramebufferCache.Reserve(DEFAULT_COUNT);
+    vkImageCache.Reserve(DEFAULT_COUNT);
+    vkBufferCache.Reserve(DEFAULT_COUNT);
+    deviceMemoryCache.Reserve(DEFAULT_COUNT);
+}
+
+CacheManager::CacheManager(const vulkanAPI::vkContext_t *vkContext, vulkanAPI::CommandBufferManager *commandBufferManager)
+: mVkContext(vkContext), mCommandBufferManager(commandBufferManager)
 { 
     FUN_ENTRY(GL_LOG_TRACE);
+}
 
-    mUBOCache.Reserve(DEFAULT_COUNT);
-    for (uint32_t i = 0; i < UBO_ARRAY_COUNT; ++i) {
-        mUBOLists[i].Reserve(DEFAULT_COUNT);
+CacheManager::~CacheManager() 
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for (auto caches : mFrameCaches) {
+        delete caches;
+    }
+    mFrameCaches.clear();
+
+    for (auto caches : mFreeFrameCaches) {
+        delete caches;
     }
-    mVBOCache.Reserve(DEFAULT_COUNT);
-    mTextureCache.Reserve(DEFAULT_COUNT);
-    mVkImageViewCache.Reserve(DEFAULT_COUNT);
-    mVkImageCache.Reserve(DEFAULT_COUNT);
-    mVkBufferCache.Reserve(DEFAULT_COUNT);
-    mVkDeviceMemoryCache.Reserve(DEFAULT_COUNT);
+    mFreeFrameCaches.clear();
 }
 
-CacheManager::~CacheManager() 
+CacheManager::FrameCaches *
+CacheManager::GetActiveFrameCaches()
 {
     FUN_ENTRY(GL_LOG_TRACE);
+
+    uint64_t serial = mCommandBufferManager->GetActiveSerial();
+
+    if (mFrameCaches.empty() || mFrameCaches.back()->serial != serial) {
+        FrameCaches *caches = nullptr;
+        if (!mFreeFrameCaches.empty()) {
+            caches = mFreeFrameCaches.back();
+            mFreeFrameCaches.pop_back();
+        } else {
+            caches = new FrameCaches();
+        }
+        caches->serial = serial;
+        mFrameCaches.push_back(caches);
+    }
+
+    return mFrameCaches.back();
+}
+
+void
+CacheManager::CleanUpFrameCaches(FrameCaches *caches)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    CleanUpUBOCache(caches);
+    CleanUpVBOCache(caches);
+    CleanUpFramebufferCache(caches);
+    CleanUpImageViewCache(caches);
+    CleanUpImageCache(caches);
+    CleanUpBufferCache(caches);
+    CleanUpDeviceMemoryCache(caches);
+    CleanUpTextureCache(caches);
+
+    mFreeFrameCaches.push_back(caches);
 }
 
 void
-CacheManager::UncacheUBOs()
+CacheManager::CleanUpUBOCache(FrameCaches *caches)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if (!mUBOCache.Empty()) {
-        for (uint32_t i = 0; i < mUBOCache.Size(); ++i) {
-            auto &ubo = mUBOCache[i];
-            uint32_t index = ubo->GetCacheIndex();
-            if (index < UBO_ARRAY_COUNT) {
-                mUBOLists[index].PushBack(ubo);
-            } else {
-                delete ubo;
+    auto &uboCache = caches->uboCache;
+
+    if(!uboCache.Empty()) {
+        for(uint32_t i = 0; i < uboCache.Size(); ++i) {
+            if(uboCache[i] != nullptr) {
+                delete uboCache[i];
+                uboCache[i] = nullptr;
             }
         }
 
-        mUBOCache.Clear();
+        uboCache.Clear();
     }
 }
 
 void
-CacheManager::CleanUpUBOs()
+CacheManager::CleanUpVBOCache(FrameCaches *caches)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    for (uint32_t i = 0; i < UBO_ARRAY_COUNT; ++i) {
-        auto &ubos = mUBOLists[i];
-        for (uint32_t j = 0; j < ubos.Size(); ++j) {
-            auto &ubo = ubos[i];
-            if (ubo != nullptr) {
-                    delete ubo;
+    auto &vboCache = caches->vboCache;
+
+    if(!vboCache.Empty()) {
+        for(uint32_t i = 0; i < vboCache.Size(); ++i) {
+            if(vboCache[i] != nullptr) {
+                delete vboCache[i];
+                vboCache[i] = nullptr;
             }
         }
-        ubos.Clear();
+
+        vboCache.Clear();
     }
 }
 
 void
-CacheManager::CleanUpVBOCache()
+CacheManager::CleanUpTextureCache(FrameCaches *caches)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if(!mVBOCache.Empty()) {
-        for(uint32_t i = 0; i < mVBOCache.Size(); ++i) {
-            if(mVBOCache[i] != nullptr) {
-                delete mVBOCache[i];
-                mVBOCache[i] = nullptr;
+    auto &textureCache = caches->textureCache;
+
+    if(!textureCache.Empty()) {
+        for(uint32_t i = 0; i < textureCache.Size(); ++i) {
+            if(textureCache[i] != nullptr) {
+                delete textureCache[i];
+                textureCache[i] = nullptr;
             }
         }
 
-        mVBOCache.Clear();
+        textureCache.Clear();
     }
 }
 
 void
-CacheManager::CleanUpTextureCache()
+CacheManager::CleanUpImageViewCache(FrameCaches *caches)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if(!mTextureCache.Empty()) {
-        for(uint32_t i = 0; i < mTextureCache.Size(); ++i) {
-            if(mTextureCache[i] != nullptr) {
-                delete mTextureCache[i];
-                mTextureCache[i] = nullptr;
-            }
+    auto &vkImageViewCache = caches->vkImageViewCache;
+
+    if (!vkImageViewCache.Empty()) {
+        for (uint32_t i = 0; i < vkImageViewCache.Size(); ++i) {
+            vkDestroyImageView(mVkContext->vkDevice, vkImageViewCache[i], nullptr);
         }
 
-        mTextureCache.Clear();
+        vkImageViewCache.Clear();
     }
 }
 
 void
-CacheManager::CleanUpImageViewCache()
+CacheManager::CleanUpFramebufferCache(FrameCaches *caches)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if (!mVkImageViewCache.Empty()) {
-        for (uint32_t i = 0; i < mVkImageViewCache.Size(); ++i) {
-            vkDestroyImageView(mVkContext->vkDevice, mVkImageViewCache[i], nullptr);
+    auto &vkFramebufferCache = caches->vkFramebufferCache;
+
+    if (!vkFramebufferCache.Empty()) {
+        for (uint32_t i = 0; i < vkFramebufferCache.Size(); ++i) {
+            vkDestroyFramebuffer(mVkContext->vkDevice, vkFramebufferCache[i], nullptr);
         }
 
-        mVkImageViewCache.Clear();
+        vkFramebufferCache.Clear();
     }
 }
 
 void
-CacheManager::CleanUpImageCache()
+CacheManager::CleanUpImageCache(FrameCaches *caches)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if (!mVkImageCache.Empty()) {
-        for (uint32_t i = 0; i < mVkImageCache.Size(); ++i) {
-            vkDestroyImage(mVkContext->vkDevice, mVkImageCache[i], nullptr);
+    auto &vkImageCache = caches->vkImageCache;
+
+    if (!vkImageCache.Empty()) {
+        for (uint32_t i = 0; i < vkImageCache.Size(); ++i) {
+            vkDestroyImage(mVkContext->vkDevice, vkImageCache[i], nullptr);
         }
 
-        mVkImageCache.Clear();
+        vkImageCache.Clear();
     }
 }
 
 void
-CacheManager::CleanUpBufferCache()
+CacheManager::CleanUpBufferCache(FrameCaches *caches)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if (!mVkBufferCache.Empty()) {
-        for (uint32_t i = 0; i < mVkBufferCache.Size(); ++i) {
-            vkDestroyBuffer(mVkContext->vkDevice, mVkBufferCache[i], nullptr);
+    auto &vkBufferCache = caches->vkBufferCache;
+
+    if (!vkBufferCache.Empty()) {
+        for (uint32_t i = 0; i < vkBufferCache.Size(); ++i) {
+            vkDestroyBuffer(mVkContext->vkDevice, vkBufferCache[i], nullptr);
         }
 
-        mVkBufferCache.Clear();
+        vkBufferCache.Clear();
     }
 }
 
 void
-CacheManager::CleanUpDeviceMemoryCache()
+CacheManager::CleanUpDeviceMemoryCache(FrameCaches *caches)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    if (!mVkDeviceMemoryCache.Empty()) {
-        for (uint32_t i = 0; i < mVkDeviceMemoryCache.Size(); ++i) {
-            vkFreeMemory(mVkContext->vkDevice, mVkDeviceMemoryCache[i], nullptr);
+    auto &deviceMemoryCache = caches->deviceMemoryCache;
+
+    if (!deviceMemoryCache.Empty()) {
+        for (uint32_t i = 0; i < deviceMemoryCache.Size(); ++i) {
+            mVkContext->deviceAllocator->Free(deviceMemoryCache[i]);
         }
 
-        mVkDeviceMemoryCache.Clear();
+        deviceMemoryCache.Clear();
     }
 }
 
@@ -225,49 +290,39 @@ CacheManager::CacheUBO(UniformBufferObject *uniformBufferObject)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mUBOCache.PushBack(uniformBufferObject);
+    GetActiveFrameCaches()->uboCache.PushBack(uniformBufferObject);
 }
 
-UniformBufferObject * 
-CacheManager::GetUBO(uint32_t index)
+void
+CacheManager::CacheVBO(BufferObject *vbo)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    UniformBufferObject *ubo = nullptr;
-    
-    if (index < UBO_ARRAY_COUNT) {
-        auto &ubos = mUBOLists[index];
-        if (!ubos.Empty()) {
-            ubo = ubos.Back();
-            ubos.PopBack();
-        }
-    }
-
-    return ubo;
+    GetActiveFrameCaches()->vboCache.PushBack(vbo);
 }
 
 void
-CacheManager::CacheVBO(BufferObject *vbo)
+CacheManager::CacheTexture(Texture *tex)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mVBOCache.PushBack(vbo);
+    GetActiveFrameCaches()->textureCache.PushBack(tex);
 }
 
 void
-CacheManager::CacheTexture(Texture *tex)
+CacheManager::CacheVkImageView(VkImageView imageView)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mTextureCache.PushBack(tex);
+    GetActiveFrameCaches()->vkImageViewCache.PushBack(imageView);
 }
 
 void
-CacheManager::CacheVkImageView(VkImageView imageView)
+CacheManager::CacheVkFramebuffer(VkFramebuffer framebuffer)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mVkImageViewCache.PushBack(imageView);
+    GetActiveFrameCaches()->vkFramebufferCache.PushBack(framebuffer);
 }
 
 void
@@ -275,7 +330,7 @@ CacheManager::CacheVkImage(VkImage image)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mVkImageCache.PushBack(image);
+    GetActiveFrameCaches()->vkImageCache.PushBack(image);
 }
 
 void
@@ -283,15 +338,15 @@ CacheManager::CacheVkBuffer(VkBuffer buffer)
 {
     FUN_ENTRY(GL_LOG_TRACE);
     
-    mVkBufferCache.PushBack(buffer);
+    GetActiveFrameCaches()->vkBufferCache.PushBack(buffer);
 }
 
 void
-CacheManager::CacheDeviceMemory(VkDeviceMemory deviceMemory)
+CacheManager::CacheDeviceMemory(vulkanAPI::DeviceAllocation *allocation)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    mVkDeviceMemoryCache.PushBack(deviceMemory);
+    GetActiveFrameCaches()->deviceMemoryCache.PushBack(allocation);
 }
 
 void
@@ -360,19 +415,54 @@ CacheManager::GetPipeline(VkPipelineCache pipelineCache, uint64_t hash)
     return VK_NULL_HANDLE;
 }
 
+bool
+CacheManager::ReleaseMemory()
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // Called under memory pressure. Once the submitted work has completed,
+    // everything retired before the active submission can be destroyed.
+    if (mFrameCaches.empty() || !mCommandBufferManager->WaitLastSubmition()) {
+        return false;
+    }
+
+    size_t count = mFrameCaches.size();
+    CleanUpCompletedFrameCaches();
+
+    return mFrameCaches.size() != count;
+}
+
 void
-CacheManager::CleanUpFrameCaches()
+CacheManager::CleanUpCompletedFrameCaches()
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    UncacheUBOs();
+    if (!mCommandBufferManager->UpdateCompletedSerial()) {
+        return;
+    }
+
+    uint64_t completedSerial = mCommandBufferManager->GetCompletedSerial();
+
+    while (!mFrameCaches.empty() && mFrameCaches.front()->serial <= completedSerial) {
+        FrameCaches *caches = mFrameCaches.front();
+        mFrameCaches.pop_front();
+        CleanUpFrameCaches(caches);
+    }
+}
+
+void
+CacheManager::CleanUpFrameCaches()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
 
-    CleanUpVBOCache();
-    CleanUpImageViewCache();
-    CleanUpImageCache();
-    CleanUpBufferCache();
-    CleanUpDeviceMemoryCache();
-    CleanUpTextureCache();
+    // Called only when the GPU is idle. Objects released while cleaning up
+    // (e.g. the VkBuffer of a deleted VBO) are queued again and released
+    // by the following iterations.
+    while (!mFrameCaches.empty()) {
+        FrameCaches *caches = mFrameCaches.front();
+        mFrameCaches.pop_front();
+        CleanUpFrameCaches(caches);
+    }
 }
 
 void
@@ -381,7 +471,6 @@ CacheManager::CleanUpCaches()
     FUN_ENTRY(GL_LOG_TRACE);
 
     CleanUpFrameCaches();
-    CleanUpUBOs();
     CleanUpSampleCache();
     CleanUpRenderPassCache();
     CleanUpPipelineCache();
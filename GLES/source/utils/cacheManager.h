@@ -23,6 +23,8 @@
 #ifndef __CACHEMANAGER_H__
 #define __CACHEMANAGER_H__
 
+#include <deque>
+#include <vector>
 #include <unordered_map>
 #include "arrays.hpp"
 #include "vulkan/vulkan.h"
@@ -30,6 +32,8 @@
 
 namespace vulkanAPI {
     struct vkContext_t;
+    struct DeviceAllocation;
+    class CommandBufferManager;
 }
 
 class UniformBufferObject;
@@ -39,20 +43,30 @@ class Texture;
 class CacheManager {
 private:
     const static uint32_t DEFAULT_COUNT = 256;
-    const static uint32_t UBO_ARRAY_COUNT = 16;
+
+    /// Objects retired while recording the submission with the given serial.
+    /// They are destroyed once that submission has completed on the GPU.
+    typedef struct FrameCaches {
+        uint64_t                        serial;
+
+        PointArray<UniformBufferObject> uboCache;
+        PointArray<BufferObject>        vboCache;
+        PointArray<Texture>             textureCache;
+        PointArray<VkImageView_T>       vkImageViewCache;
+        PointArray<VkFramebuffer_T>     vkFramebufferCache;
+        PointArray<VkImage_T>           vkImageCache;
+        PointArray<VkBuffer_T>          vkBufferCache;
+        PointArray<vulkanAPI::DeviceAllocation> deviceMemoryCache;
+
+        FrameCaches();
+    } FrameCaches;
 
     const
     vulkanAPI::vkContext_t *            mVkContext;
+    vulkanAPI::CommandBufferManager *   mCommandBufferManager;
 
-    PointArray<UniformBufferObject>     mUBOCache;
-    PointArray<UniformBufferObject>     mUBOLists[UBO_ARRAY_COUNT];
-
-    PointArray<BufferObject>            mVBOCache;
-    PointArray<Texture>                 mTextureCache;
-    PointArray<VkImageView_T>           mVkImageViewCache;
-    PointArray<VkImage_T>               mVkImageCache;
-    PointArray<VkBuffer_T>              mVkBufferCache;
-    PointArray<VkDeviceMemory_T>        mVkDeviceMemoryCache;
+    std::deque<FrameCaches *>           mFrameCaches;
+    std::vector<FrameCaches *>          mFreeFrameCaches;
 
     typedef std::unordered_map<uint64_t, VkSampler> SamplerMap;
     SamplerMap                          mVkSamplerCache;
@@ -63,33 +77,35 @@ private:
     typedef std::unordered_map<VkPipelineCache, PipelineHashMap> PipelineMap;
     PipelineMap                         mVkPipelineCache;
 
-    void                                UncacheUBOs();
-    void                                CleanUpUBOs();
+    FrameCaches *                       GetActiveFrameCaches();
+    void                                CleanUpFrameCaches(FrameCaches *caches);
 
-    void                                CleanUpVBOCache();
-    void                                CleanUpTextureCache();
-    void                                CleanUpImageViewCache();
-    void                                CleanUpImageCache();
-    void                                CleanUpBufferCache();
-    void                                CleanUpDeviceMemoryCache();
+    void                                CleanUpUBOCache(FrameCaches *caches);
+    void                                CleanUpVBOCache(FrameCaches *caches);
+    void                                CleanUpTextureCache(FrameCaches *caches);
+    void                                CleanUpImageViewCache(FrameCaches *caches);
+    void                                CleanUpFramebufferCache(FrameCaches *caches);
+    void                                CleanUpImageCache(FrameCaches *caches);
+    void                                CleanUpBufferCache(FrameCaches *caches);
+    void                                CleanUpDeviceMemoryCache(FrameCaches *caches);
 
     void                                CleanUpSampleCache();
     void                                CleanUpRenderPassCache();
     void                                CleanUpPipelineCache();
 
 public:
-     CacheManager(const vulkanAPI::vkContext_t *vkContext);
+     CacheManager(const vulkanAPI::vkContext_t *vkContext, vulkanAPI::CommandBufferManager *commandBufferManager);
     ~CacheManager();
 
     void                                CacheUBO(UniformBufferObject *uniformBufferObject);
-    UniformBufferObject *               GetUBO(uint32_t index);
 
     void                                CacheVBO(BufferObject *vbo);
     void                                CacheTexture(Texture *tex);
     void                                CacheVkImageView(VkImageView imageView);
+    void                                CacheVkFramebuffer(VkFramebuffer framebuffer);
     void                                CacheVkImage(VkImage image);
     void                                CacheVkBuffer(VkBuffer buffer);
-    void                                CacheDeviceMemory(VkDeviceMemory deviceMemory);
+    void                                CacheDeviceMemory(vulkanAPI::DeviceAllocation *allocation);
 
     void                                CacheSampler(uint64_t hash, VkSampler sampler);
     VkSampler                           GetSampler(uint64_t hash);
@@ -100,6 +116,8 @@ public:
     void                                CachePipeline(VkPipelineCache pipelineCache, uint64_t hash, VkPipeline pipeline);
     VkPipeline                          GetPipeline(VkPipelineCache pipelineCache, uint64_t hash);
 
+    bool                                ReleaseMemory();
+    void                                CleanUpCompletedFrameCaches();
     void                                CleanUpFrameCaches();
     void                                CleanUpCaches();
 };
@@ -36,7 +36,7 @@ CLAMP(const T x, const T minVal, const T maxVal) {
 
 #define CLAMPF_01(x)                                    CLAMP(x, 0.0f, 1.0f)
 
-// TODO:: check and reimplement/optimize conversions for packed image formats if needed
+// NOTE: row conversions go through the kernels of pixelKernels.h, which must match these bit by bit
 struct Color {
     unsigned char r, g, b, a;
 
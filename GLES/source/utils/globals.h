@@ -87,6 +87,16 @@
 
 #define GLOVE_INVALID_OFFSET                            UINT32_MAX
 
+/// Uniform blocks bound with dynamic offsets, the minimum of maxDescriptorSetUniformBuffersDynamic
+#define GLOVE_MAX_DYNAMIC_UNIFORM_BUFFERS               8
+
 #define GLOVE_VULKAN_DEPTH_RANGE                        vulkan_DepthRange
 
+/// Loose uniforms of both shader stages are packed into this block
+#define GLOVE_DEFAULT_UNIFORM_BLOCK                     gl_DefaultUniformBlock
+
+/// Loose uniforms pushed as constants, within the minimum of maxPushConstantsSize
+#define GLOVE_PUSH_CONSTANT_BLOCK                       gl_PushConstantBlock
+#define GLOVE_MAX_PUSH_CONSTANTS_SIZE                   128
+
 #endif // __GLOBALS_H__
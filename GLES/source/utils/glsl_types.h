@@ -85,6 +85,56 @@ inline size_t GlslTypeToAllignment(GLenum type)
     }
 }
 
+inline size_t GlslTypeToBaseAlignment(GLenum type)
+{
+    switch(type) {
+    case GL_BOOL:
+    case GL_INT:
+    case GL_FLOAT:                          return 4;
+
+    case GL_BOOL_VEC2:
+    case GL_INT_VEC2:
+    case GL_FLOAT_VEC2:                     return 8;
+
+    case GL_BOOL_VEC3:
+    case GL_INT_VEC3:
+    case GL_FLOAT_VEC3:
+    case GL_BOOL_VEC4:
+    case GL_INT_VEC4:
+    case GL_FLOAT_VEC4:
+    case GL_FLOAT_MAT2:
+    case GL_FLOAT_MAT3:
+    case GL_FLOAT_MAT4:                     return 16;
+    default:                                return 0;
+    }
+}
+
+inline const char *GlslTypeToName(GLenum type)
+{
+    switch(type) {
+    case GL_BOOL:                           return "bool";
+    case GL_INT:                            return "int";
+    case GL_FLOAT:                          return "float";
+
+    case GL_BOOL_VEC2:                      return "bvec2";
+    case GL_INT_VEC2:                       return "ivec2";
+    case GL_FLOAT_VEC2:                     return "vec2";
+
+    case GL_BOOL_VEC3:                      return "bvec3";
+    case GL_INT_VEC3:                       return "ivec3";
+    case GL_FLOAT_VEC3:                     return "vec3";
+
+    case GL_BOOL_VEC4:                      return "bvec4";
+    case GL_INT_VEC4:                       return "ivec4";
+    case GL_FLOAT_VEC4:                     return "vec4";
+
+    case GL_FLOAT_MAT2:                     return "mat2";
+    case GL_FLOAT_MAT3:                     return "mat3";
+    case GL_FLOAT_MAT4:                     return "mat4";
+    default:                                return nullptr;
+    }
+}
+
 inline size_t GlslTypeToSize(GLenum type)
 {
     switch(type) {
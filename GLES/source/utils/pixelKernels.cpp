@@ -0,0 +1,940 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       pixelKernels.cpp
+ *  @author     Think Silicon
+ *  @date       25/07/2018
+ *  @version    1.0
+ *
+ *  @brief      Row Kernels for Pixel Format Conversions
+ *
+ *  @section
+ *
+ *  Each kernel converts a row of pixels between two formats. A scalar
+ *  version exists for every kernel, while the common pairs also come
+ *  with SSE4/AVX2 or NEON versions. The best version supported by the
+ *  running CPU is selected once, on first use.
+ *
+ *  Vector loops never touch memory past the given pixels; the leftover
+ *  pixels of a row go through the scalar version.
+ *
+ */
+
+#include "pixelKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#   define GLOVE_PIXEL_KERNELS_X86
+#   include <immintrin.h>
+#   ifdef _MSC_VER
+#       include <intrin.h>
+#       define GLOVE_TARGET_SSE4
+#       define GLOVE_TARGET_AVX2
+#   else
+#       define GLOVE_TARGET_SSE4                        __attribute__((target("sse4.1")))
+#       define GLOVE_TARGET_AVX2                        __attribute__((target("avx2")))
+#   endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#   define GLOVE_PIXEL_KERNELS_NEON
+#   include <arm_neon.h>
+#endif
+
+// expansion of 5 and 6 bit channels to 8 bits, as done by Color
+#define EXPAND5(x)                                      static_cast<uint8_t>(((x) << 3) | ((x) >> 2))
+#define EXPAND6(x)                                      static_cast<uint8_t>(((x) << 2) | ((x) >> 4))
+
+// Scalar Kernels
+static void
+BgraToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 4, dst += 4) {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+        dst[3] = src[3];
+    }
+}
+
+static void
+BgraToRgbScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 4, dst += 3) {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+    }
+}
+
+static void
+BgraToLuminanceAlphaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 4, dst += 2) {
+        dst[0] = src[2];
+        dst[1] = src[3];
+    }
+}
+
+static void
+BgraToLuminanceScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 4) {
+        dst[i] = src[2];
+    }
+}
+
+static void
+RgbaToAlphaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 4) {
+        dst[i] = src[3];
+    }
+}
+
+static void
+RgbaToRgbScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 4, dst += 3) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+    }
+}
+
+static void
+RgbToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 3, dst += 4) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[3] = 0xff;
+    }
+}
+
+static void
+LuminanceAlphaToLuminanceScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 2) {
+        dst[i] = src[0];
+    }
+}
+
+static void
+LuminanceAlphaToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 2, dst += 4) {
+        dst[0] = src[0];
+        dst[1] = src[0];
+        dst[2] = src[0];
+        dst[3] = src[1];
+    }
+}
+
+static void
+LuminanceToLuminanceAlphaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, dst += 2) {
+        dst[0] = src[i];
+        dst[1] = 0xff;
+    }
+}
+
+static void
+LuminanceToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, dst += 4) {
+        dst[0] = src[i];
+        dst[1] = src[i];
+        dst[2] = src[i];
+        dst[3] = 0xff;
+    }
+}
+
+static void
+AlphaToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, dst += 4) {
+        dst[0] = 0x0;
+        dst[1] = 0x0;
+        dst[2] = 0x0;
+        dst[3] = src[i];
+    }
+}
+
+static void
+Rgba4444ToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 2, dst += 4) {
+        const uint8_t r = src[1] >> 4;
+        const uint8_t g = src[1] & 0x0F;
+        const uint8_t b = src[0] >> 4;
+        const uint8_t a = src[0] & 0x0F;
+        dst[0] = static_cast<uint8_t>(r | (r << 4));
+        dst[1] = static_cast<uint8_t>(g | (g << 4));
+        dst[2] = static_cast<uint8_t>(b | (b << 4));
+        dst[3] = static_cast<uint8_t>(a | (a << 4));
+    }
+}
+
+static void
+Rgba5551ToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 2, dst += 4) {
+        const uint32_t u5551 = (src[1] << 8) | src[0];
+        dst[0] = EXPAND5(u5551 >> 11);
+        dst[1] = EXPAND5((u5551 >> 6) & 0x1F);
+        dst[2] = EXPAND5((u5551 >> 1) & 0x1F);
+        dst[3] = (u5551 & 0x1) ? 0xff : 0x0;
+    }
+}
+
+static void
+Rgb565ToRgbaScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 2, dst += 4) {
+        const uint32_t u565 = (src[1] << 8) | src[0];
+        dst[0] = EXPAND5(u565 >> 11);
+        dst[1] = EXPAND6((u565 >> 5) & 0x3F);
+        dst[2] = EXPAND5(u565 & 0x1F);
+        dst[3] = 0xff;
+    }
+}
+
+static void
+Rgb565ToLuminanceScalar(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(uint32_t i = 0; i < pixels; ++i, src += 2) {
+        dst[i] = EXPAND5(src[1] >> 3);
+    }
+}
+
+#ifdef GLOVE_PIXEL_KERNELS_X86
+
+// SSE4 Kernels
+// NOTE: pshufb clears the bytes selected by an index with the top bit set
+#define Z                                               -128
+
+// shuffles 4 pixels of 4 bytes per iteration, storing a full vector
+// as long as the valid bytes of the next iterations cover its tail
+#define SSE4_SHUFFLE_4X4(name, mask, dstBytes, minPixels)                                   \
+static GLOVE_TARGET_SSE4 void                                                               \
+name##Sse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)                               \
+{                                                                                           \
+    const __m128i shuffle = mask;                                                           \
+    for(; pixels >= minPixels; pixels -= 4, src += 16, dst += 4 * dstBytes) {               \
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));          \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(v, shuffle));   \
+    }                                                                                       \
+    name##Scalar(src, dst, pixels);                                                         \
+}
+
+SSE4_SHUFFLE_4X4(BgraToRgba, _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15), 4, 4)
+SSE4_SHUFFLE_4X4(BgraToRgb,  _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, Z, Z, Z, Z), 3, 6)
+SSE4_SHUFFLE_4X4(RgbaToRgb,  _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, Z, Z, Z, Z), 3, 6)
+
+static GLOVE_TARGET_SSE4 void
+BgraToLuminanceAlphaSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 3, 6, 7, 10, 11, 14, 15, Z, Z, Z, Z, Z, Z, Z, Z);
+    for(; pixels >= 8; pixels -= 8, src += 32, dst += 16) {
+        const __m128i v0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), shuffle);
+        const __m128i v1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16)), shuffle);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi64(v0, v1));
+    }
+    BgraToLuminanceAlphaScalar(src, dst, pixels);
+}
+
+// extracts a single byte channel out of 16 pixels of 4 bytes per iteration
+#define SSE4_EXTRACT_16X4(name, channel)                                                    \
+static GLOVE_TARGET_SSE4 void                                                               \
+name##Sse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)                               \
+{                                                                                           \
+    const __m128i shuffle = _mm_setr_epi8(channel, channel + 4, channel + 8, channel + 12,  \
+                                          Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z);              \
+    for(; pixels >= 16; pixels -= 16, src += 64, dst += 16) {                               \
+        const __m128i v0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), shuffle);      \
+        const __m128i v1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16)), shuffle); \
+        const __m128i v2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32)), shuffle); \
+        const __m128i v3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 48)), shuffle); \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),                                  \
+                         _mm_unpacklo_epi64(_mm_unpacklo_epi32(v0, v1), _mm_unpacklo_epi32(v2, v3)));               \
+    }                                                                                       \
+    name##Scalar(src, dst, pixels);                                                         \
+}
+
+SSE4_EXTRACT_16X4(BgraToLuminance, 2)
+SSE4_EXTRACT_16X4(RgbaToAlpha, 3)
+
+static GLOVE_TARGET_SSE4 void
+RgbToRgbaSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, Z, 9, 10, 11, Z);
+    const __m128i alpha   = _mm_set1_epi32(static_cast<int>(0xff000000));
+    // 16 bytes are loaded for 4 pixels, so 6 pixels must be left to read from
+    for(; pixels >= 6; pixels -= 4, src += 12, dst += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+    }
+    RgbToRgbaScalar(src, dst, pixels);
+}
+
+static GLOVE_TARGET_SSE4 void
+LuminanceAlphaToLuminanceSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    for(; pixels >= 16; pixels -= 16, src += 32, dst += 16) {
+        const __m128i v0 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), mask);
+        const __m128i v1 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16)), mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(v0, v1));
+    }
+    LuminanceAlphaToLuminanceScalar(src, dst, pixels);
+}
+
+static GLOVE_TARGET_SSE4 void
+LuminanceAlphaToRgbaSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m128i lo = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+    const __m128i hi = _mm_setr_epi8(8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+    for(; pixels >= 8; pixels -= 8, src += 16, dst += 32) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(v, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_shuffle_epi8(v, hi));
+    }
+    LuminanceAlphaToRgbaScalar(src, dst, pixels);
+}
+
+static GLOVE_TARGET_SSE4 void
+LuminanceToLuminanceAlphaSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xff));
+    for(; pixels >= 16; pixels -= 16, src += 16, dst += 32) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8(v, alpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi8(v, alpha));
+    }
+    LuminanceToLuminanceAlphaScalar(src, dst, pixels);
+}
+
+// expands 16 pixels of a single byte to 4 bytes per iteration
+#define SSE4_EXPAND_16X1(name, s, fill)                                                     \
+static GLOVE_TARGET_SSE4 void                                                               \
+name##Sse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)                               \
+{                                                                                           \
+    const __m128i shuffle0 = _mm_setr_epi8(s(0), s(1), s(2), s(3));                         \
+    const __m128i shuffle1 = _mm_setr_epi8(s(4), s(5), s(6), s(7));                         \
+    const __m128i shuffle2 = _mm_setr_epi8(s(8), s(9), s(10), s(11));                       \
+    const __m128i shuffle3 = _mm_setr_epi8(s(12), s(13), s(14), s(15));                     \
+    const __m128i alpha    = _mm_set1_epi32(static_cast<int>(fill));                        \
+    for(; pixels >= 16; pixels -= 16, src += 16, dst += 64) {                               \
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));          \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),      _mm_or_si128(_mm_shuffle_epi8(v, shuffle0), alpha)); \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_or_si128(_mm_shuffle_epi8(v, shuffle1), alpha)); \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32), _mm_or_si128(_mm_shuffle_epi8(v, shuffle2), alpha)); \
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 48), _mm_or_si128(_mm_shuffle_epi8(v, shuffle3), alpha)); \
+    }                                                                                       \
+    name##Scalar(src, dst, pixels);                                                         \
+}
+
+#define LUMINANCE_SHUFFLE(i)                            i, i, i, Z
+#define ALPHA_SHUFFLE(i)                                Z, Z, Z, i
+
+SSE4_EXPAND_16X1(LuminanceToRgba, LUMINANCE_SHUFFLE, 0xff000000)
+SSE4_EXPAND_16X1(AlphaToRgba, ALPHA_SHUFFLE, 0x0)
+
+static GLOVE_TARGET_SSE4 void
+Rgba4444ToRgbaSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m128i nibble  = _mm_set1_epi8(0x0F);
+    // unpacking gives b, a, r, g per pixel
+    const __m128i shuffle = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    for(; pixels >= 8; pixels -= 8, src += 16, dst += 32) {
+        const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        __m128i       hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+        __m128i       lo = _mm_and_si128(v, nibble);
+        hi = _mm_or_si128(hi, _mm_slli_epi16(hi, 4));
+        lo = _mm_or_si128(lo, _mm_slli_epi16(lo, 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),      _mm_shuffle_epi8(_mm_unpacklo_epi8(hi, lo), shuffle));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_shuffle_epi8(_mm_unpackhi_epi8(hi, lo), shuffle));
+    }
+    Rgba4444ToRgbaScalar(src, dst, pixels);
+}
+
+// expands 5 bit channels sitting in the low bits of 16 bit lanes
+static GLOVE_TARGET_SSE4 inline __m128i
+Expand5Sse4(__m128i x)
+{
+    return _mm_or_si128(_mm_slli_epi16(x, 3), _mm_srli_epi16(x, 2));
+}
+
+static GLOVE_TARGET_SSE4 void
+Rgba5551ToRgbaSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i one   = _mm_set1_epi16(0x1);
+    const __m128i high  = _mm_set1_epi16(static_cast<short>(0xff00));
+    for(; pixels >= 8; pixels -= 8, src += 16, dst += 32) {
+        const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i r  = Expand5Sse4(_mm_srli_epi16(v, 11));
+        const __m128i g  = Expand5Sse4(_mm_and_si128(_mm_srli_epi16(v, 6), mask5));
+        const __m128i b  = Expand5Sse4(_mm_and_si128(_mm_srli_epi16(v, 1), mask5));
+        const __m128i a  = _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(v, one)), high);
+        const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        const __m128i ba = _mm_or_si128(b, a);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),      _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi16(rg, ba));
+    }
+    Rgba5551ToRgbaScalar(src, dst, pixels);
+}
+
+static GLOVE_TARGET_SSE4 void
+Rgb565ToRgbaSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i high  = _mm_set1_epi16(static_cast<short>(0xff00));
+    for(; pixels >= 8; pixels -= 8, src += 16, dst += 32) {
+        const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i g6 = _mm_and_si128(_mm_srli_epi16(v, 5), mask6);
+        const __m128i r  = Expand5Sse4(_mm_srli_epi16(v, 11));
+        const __m128i g  = _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4));
+        const __m128i b  = Expand5Sse4(_mm_and_si128(v, mask5));
+        const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        const __m128i ba = _mm_or_si128(b, high);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),      _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi16(rg, ba));
+    }
+    Rgb565ToRgbaScalar(src, dst, pixels);
+}
+
+static GLOVE_TARGET_SSE4 void
+Rgb565ToLuminanceSse4(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 32, dst += 16) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                         _mm_packus_epi16(Expand5Sse4(_mm_srli_epi16(v0, 11)), Expand5Sse4(_mm_srli_epi16(v1, 11))));
+    }
+    Rgb565ToLuminanceScalar(src, dst, pixels);
+}
+
+// AVX2 Kernels
+// NOTE: shuffles operate within each 128 bit lane, so masks are repeated per lane.
+//       The upper halves are cleared before the tails, to avoid the penalty of
+//       mixing them with legacy SSE code.
+static GLOVE_TARGET_AVX2 void
+BgraToRgbaAvx2(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                             2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    for(; pixels >= 16; pixels -= 16, src += 64, dst += 64) {
+        const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),      _mm256_shuffle_epi8(v0, shuffle));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 32), _mm256_shuffle_epi8(v1, shuffle));
+    }
+    _mm256_zeroupper();
+    BgraToRgbaSse4(src, dst, pixels);
+}
+
+static GLOVE_TARGET_AVX2 void
+RgbToRgbaAvx2(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, Z, 9, 10, 11, Z,
+                                             0, 1, 2, Z, 3, 4, 5, Z, 6, 7, 8, Z, 9, 10, 11, Z);
+    const __m256i alpha   = _mm256_set1_epi32(static_cast<int>(0xff000000));
+    // each lane loads 16 bytes for 4 pixels, so 10 pixels must be left to read from
+    for(; pixels >= 10; pixels -= 8, src += 24, dst += 32) {
+        const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src))),
+                                                  _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 12)), 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), alpha));
+    }
+    _mm256_zeroupper();
+    RgbToRgbaSse4(src, dst, pixels);
+}
+
+static GLOVE_TARGET_AVX2 void
+LuminanceAlphaToRgbaAvx2(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    // widening gives l, a, 0, 0 per pixel
+    const __m256i shuffle = _mm256_setr_epi8(0, 0, 0, 1, 4, 4, 4, 5, 8, 8, 8, 9, 12, 12, 12, 13,
+                                             0, 0, 0, 1, 4, 4, 4, 5, 8, 8, 8, 9, 12, 12, 12, 13);
+    for(; pixels >= 8; pixels -= 8, src += 16, dst += 32) {
+        const __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_shuffle_epi8(v, shuffle));
+    }
+    _mm256_zeroupper();
+    LuminanceAlphaToRgbaScalar(src, dst, pixels);
+}
+
+static GLOVE_TARGET_AVX2 void
+LuminanceToRgbaAvx2(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m256i spread = _mm256_set1_epi32(0x010101);
+    const __m256i alpha  = _mm256_set1_epi32(static_cast<int>(0xff000000));
+    for(; pixels >= 8; pixels -= 8, src += 8, dst += 32) {
+        const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_or_si256(_mm256_mullo_epi32(v, spread), alpha));
+    }
+    _mm256_zeroupper();
+    LuminanceToRgbaScalar(src, dst, pixels);
+}
+
+static GLOVE_TARGET_AVX2 void
+AlphaToRgbaAvx2(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 8; pixels -= 8, src += 8, dst += 32) {
+        const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_slli_epi32(v, 24));
+    }
+    _mm256_zeroupper();
+    AlphaToRgbaScalar(src, dst, pixels);
+}
+
+static GLOVE_TARGET_AVX2 void
+Rgb565ToRgbaAvx2(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    const __m256i high  = _mm256_set1_epi16(static_cast<short>(0xff00));
+    for(; pixels >= 16; pixels -= 16, src += 32, dst += 64) {
+        const __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const __m256i r5 = _mm256_srli_epi16(v, 11);
+        const __m256i g6 = _mm256_and_si256(_mm256_srli_epi16(v, 5), mask6);
+        const __m256i b5 = _mm256_and_si256(v, mask5);
+        const __m256i r  = _mm256_or_si256(_mm256_slli_epi16(r5, 3), _mm256_srli_epi16(r5, 2));
+        const __m256i g  = _mm256_or_si256(_mm256_slli_epi16(g6, 2), _mm256_srli_epi16(g6, 4));
+        const __m256i b  = _mm256_or_si256(_mm256_slli_epi16(b5, 3), _mm256_srli_epi16(b5, 2));
+        const __m256i rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+        const __m256i ba = _mm256_or_si256(b, high);
+        // unpacking works per lane, giving pixels 0..3 | 8..11 and 4..7 | 12..15
+        const __m256i lo = _mm256_unpacklo_epi16(rg, ba);
+        const __m256i hi = _mm256_unpackhi_epi16(rg, ba);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),      _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    _mm256_zeroupper();
+    Rgb565ToRgbaSse4(src, dst, pixels);
+}
+
+#undef Z
+
+static bool
+DetectSse4(void)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) && (info[2] & (1 << 19));
+#else
+    return __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+static bool
+DetectAvx2(void)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7) {
+        return false;
+    }
+    // the OS must also save the ymm registers
+    __cpuid(info, 1);
+    if(!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // GLOVE_PIXEL_KERNELS_X86
+
+#ifdef GLOVE_PIXEL_KERNELS_NEON
+
+// NEON Kernels
+// NOTE: structure loads and stores de/interleave 16 pixels per iteration
+static void
+BgraToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 64, dst += 64) {
+        uint8x16x4_t v = vld4q_u8(src);
+        const uint8x16_t b = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = b;
+        vst4q_u8(dst, v);
+    }
+    BgraToRgbaScalar(src, dst, pixels);
+}
+
+static void
+BgraToRgbNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 64, dst += 48) {
+        const uint8x16x4_t v = vld4q_u8(src);
+        uint8x16x3_t rgb;
+        rgb.val[0] = v.val[2];
+        rgb.val[1] = v.val[1];
+        rgb.val[2] = v.val[0];
+        vst3q_u8(dst, rgb);
+    }
+    BgraToRgbScalar(src, dst, pixels);
+}
+
+static void
+BgraToLuminanceAlphaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 64, dst += 32) {
+        const uint8x16x4_t v = vld4q_u8(src);
+        uint8x16x2_t la;
+        la.val[0] = v.val[2];
+        la.val[1] = v.val[3];
+        vst2q_u8(dst, la);
+    }
+    BgraToLuminanceAlphaScalar(src, dst, pixels);
+}
+
+static void
+BgraToLuminanceNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 64, dst += 16) {
+        vst1q_u8(dst, vld4q_u8(src).val[2]);
+    }
+    BgraToLuminanceScalar(src, dst, pixels);
+}
+
+static void
+RgbaToAlphaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 64, dst += 16) {
+        vst1q_u8(dst, vld4q_u8(src).val[3]);
+    }
+    RgbaToAlphaScalar(src, dst, pixels);
+}
+
+static void
+RgbaToRgbNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 64, dst += 48) {
+        const uint8x16x4_t v = vld4q_u8(src);
+        uint8x16x3_t rgb;
+        rgb.val[0] = v.val[0];
+        rgb.val[1] = v.val[1];
+        rgb.val[2] = v.val[2];
+        vst3q_u8(dst, rgb);
+    }
+    RgbaToRgbScalar(src, dst, pixels);
+}
+
+static void
+RgbToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 48, dst += 64) {
+        const uint8x16x3_t v = vld3q_u8(src);
+        uint8x16x4_t rgba;
+        rgba.val[0] = v.val[0];
+        rgba.val[1] = v.val[1];
+        rgba.val[2] = v.val[2];
+        rgba.val[3] = vdupq_n_u8(0xff);
+        vst4q_u8(dst, rgba);
+    }
+    RgbToRgbaScalar(src, dst, pixels);
+}
+
+static void
+LuminanceAlphaToLuminanceNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 32, dst += 16) {
+        vst1q_u8(dst, vld2q_u8(src).val[0]);
+    }
+    LuminanceAlphaToLuminanceScalar(src, dst, pixels);
+}
+
+static void
+LuminanceAlphaToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 32, dst += 64) {
+        const uint8x16x2_t v = vld2q_u8(src);
+        uint8x16x4_t rgba;
+        rgba.val[0] = v.val[0];
+        rgba.val[1] = v.val[0];
+        rgba.val[2] = v.val[0];
+        rgba.val[3] = v.val[1];
+        vst4q_u8(dst, rgba);
+    }
+    LuminanceAlphaToRgbaScalar(src, dst, pixels);
+}
+
+static void
+LuminanceToLuminanceAlphaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 16, dst += 32) {
+        uint8x16x2_t la;
+        la.val[0] = vld1q_u8(src);
+        la.val[1] = vdupq_n_u8(0xff);
+        vst2q_u8(dst, la);
+    }
+    LuminanceToLuminanceAlphaScalar(src, dst, pixels);
+}
+
+static void
+LuminanceToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 16, dst += 64) {
+        const uint8x16_t l = vld1q_u8(src);
+        uint8x16x4_t rgba;
+        rgba.val[0] = l;
+        rgba.val[1] = l;
+        rgba.val[2] = l;
+        rgba.val[3] = vdupq_n_u8(0xff);
+        vst4q_u8(dst, rgba);
+    }
+    LuminanceToRgbaScalar(src, dst, pixels);
+}
+
+static void
+AlphaToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 16, dst += 64) {
+        uint8x16x4_t rgba;
+        rgba.val[0] = vdupq_n_u8(0x0);
+        rgba.val[1] = vdupq_n_u8(0x0);
+        rgba.val[2] = vdupq_n_u8(0x0);
+        rgba.val[3] = vld1q_u8(src);
+        vst4q_u8(dst, rgba);
+    }
+    AlphaToRgbaScalar(src, dst, pixels);
+}
+
+static void
+Rgba4444ToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const uint8x16_t nibble = vdupq_n_u8(0x0F);
+    for(; pixels >= 16; pixels -= 16, src += 32, dst += 64) {
+        const uint8x16x2_t v = vld2q_u8(src);
+        const uint8x16_t r = vshrq_n_u8(v.val[1], 4);
+        const uint8x16_t g = vandq_u8(v.val[1], nibble);
+        const uint8x16_t b = vshrq_n_u8(v.val[0], 4);
+        const uint8x16_t a = vandq_u8(v.val[0], nibble);
+        uint8x16x4_t rgba;
+        rgba.val[0] = vsliq_n_u8(r, r, 4);
+        rgba.val[1] = vsliq_n_u8(g, g, 4);
+        rgba.val[2] = vsliq_n_u8(b, b, 4);
+        rgba.val[3] = vsliq_n_u8(a, a, 4);
+        vst4q_u8(dst, rgba);
+    }
+    Rgba4444ToRgbaScalar(src, dst, pixels);
+}
+
+// expands 5 bit channels sitting in the low bits of 16 bit lanes and narrows them to bytes
+static inline uint8x8_t
+Expand5Neon(uint16x8_t x)
+{
+    return vmovn_u16(vorrq_u16(vshlq_n_u16(x, 3), vshrq_n_u16(x, 2)));
+}
+
+static void
+Rgba5551ToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t one   = vdupq_n_u16(0x1);
+    for(; pixels >= 8; pixels -= 8, src += 16, dst += 32) {
+        const uint16x8_t v = vreinterpretq_u16_u8(vld1q_u8(src));
+        uint8x8x4_t rgba;
+        rgba.val[0] = Expand5Neon(vshrq_n_u16(v, 11));
+        rgba.val[1] = Expand5Neon(vandq_u16(vshrq_n_u16(v, 6), mask5));
+        rgba.val[2] = Expand5Neon(vandq_u16(vshrq_n_u16(v, 1), mask5));
+        rgba.val[3] = vmovn_u16(vtstq_u16(v, one));
+        vst4_u8(dst, rgba);
+    }
+    Rgba5551ToRgbaScalar(src, dst, pixels);
+}
+
+static void
+Rgb565ToRgbaNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+    for(; pixels >= 8; pixels -= 8, src += 16, dst += 32) {
+        const uint16x8_t v  = vreinterpretq_u16_u8(vld1q_u8(src));
+        const uint16x8_t g6 = vandq_u16(vshrq_n_u16(v, 5), mask6);
+        uint8x8x4_t rgba;
+        rgba.val[0] = Expand5Neon(vshrq_n_u16(v, 11));
+        rgba.val[1] = vmovn_u16(vorrq_u16(vshlq_n_u16(g6, 2), vshrq_n_u16(g6, 4)));
+        rgba.val[2] = Expand5Neon(vandq_u16(v, mask5));
+        rgba.val[3] = vdup_n_u8(0xff);
+        vst4_u8(dst, rgba);
+    }
+    Rgb565ToRgbaScalar(src, dst, pixels);
+}
+
+static void
+Rgb565ToLuminanceNeon(const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    for(; pixels >= 16; pixels -= 16, src += 32, dst += 16) {
+        const uint8x16_t r = vshrq_n_u8(vld2q_u8(src).val[1], 3);
+        vst1q_u8(dst, vorrq_u8(vshlq_n_u8(r, 3), vshrq_n_u8(r, 2)));
+    }
+    Rgb565ToLuminanceScalar(src, dst, pixels);
+}
+
+#endif // GLOVE_PIXEL_KERNELS_NEON
+
+#ifdef GLOVE_PIXEL_KERNELS_X86
+#   define SSE4_KERNEL(name)                            name##Sse4
+#   define AVX2_KERNEL(name)                            name##Avx2
+#else
+#   define SSE4_KERNEL(name)                            nullptr
+#   define AVX2_KERNEL(name)                            nullptr
+#endif
+
+#ifdef GLOVE_PIXEL_KERNELS_NEON
+#   define NEON_KERNEL(name)                            name##Neon
+#else
+#   define NEON_KERNEL(name)                            nullptr
+#endif
+
+typedef struct {
+    const char *                    name;
+    uint32_t                        srcBytes;
+    uint32_t                        dstBytes;
+    pixelRowKernel_t                kernels[PIXEL_KERNEL_ISA_COUNT];
+} pixelKernelInfo_t;
+
+// indexed by pixelKernel_t
+static const pixelKernelInfo_t pixelKernelInfo[PIXEL_KERNEL_COUNT] = {
+    { "BGRA -> RGBA",  4, 4, { BgraToRgbaScalar,                SSE4_KERNEL(BgraToRgba),                AVX2_KERNEL(BgraToRgba),           NEON_KERNEL(BgraToRgba)                } },
+    { "BGRA -> RGB",   4, 3, { BgraToRgbScalar,                 SSE4_KERNEL(BgraToRgb),                 nullptr,                           NEON_KERNEL(BgraToRgb)                 } },
+    { "BGRA -> LA",    4, 2, { BgraToLuminanceAlphaScalar,      SSE4_KERNEL(BgraToLuminanceAlpha),      nullptr,                           NEON_KERNEL(BgraToLuminanceAlpha)      } },
+    { "BGRA -> L",     4, 1, { BgraToLuminanceScalar,           SSE4_KERNEL(BgraToLuminance),           nullptr,                           NEON_KERNEL(BgraToLuminance)           } },
+    { "BGRA -> A",     4, 1, { RgbaToAlphaScalar,               SSE4_KERNEL(RgbaToAlpha),               nullptr,                           NEON_KERNEL(RgbaToAlpha)               } },
+    { "RGBA -> RGB",   4, 3, { RgbaToRgbScalar,                 SSE4_KERNEL(RgbaToRgb),                 nullptr,                           NEON_KERNEL(RgbaToRgb)                 } },
+    { "RGBA -> A",     4, 1, { RgbaToAlphaScalar,               SSE4_KERNEL(RgbaToAlpha),               nullptr,                           NEON_KERNEL(RgbaToAlpha)               } },
+    { "RGB -> RGBA",   3, 4, { RgbToRgbaScalar,                 SSE4_KERNEL(RgbToRgba),                 AVX2_KERNEL(RgbToRgba),            NEON_KERNEL(RgbToRgba)                 } },
+    { "LA -> L",       2, 1, { LuminanceAlphaToLuminanceScalar, SSE4_KERNEL(LuminanceAlphaToLuminance), nullptr,                           NEON_KERNEL(LuminanceAlphaToLuminance) } },
+    { "LA -> RGBA",    2, 4, { LuminanceAlphaToRgbaScalar,      SSE4_KERNEL(LuminanceAlphaToRgba),      AVX2_KERNEL(LuminanceAlphaToRgba), NEON_KERNEL(LuminanceAlphaToRgba)      } },
+    { "L -> LA",       1, 2, { LuminanceToLuminanceAlphaScalar, SSE4_KERNEL(LuminanceToLuminanceAlpha), nullptr,                           NEON_KERNEL(LuminanceToLuminanceAlpha) } },
+    { "L -> RGBA",     1, 4, { LuminanceToRgbaScalar,           SSE4_KERNEL(LuminanceToRgba),           AVX2_KERNEL(LuminanceToRgba),      NEON_KERNEL(LuminanceToRgba)           } },
+    { "A -> RGBA",     1, 4, { AlphaToRgbaScalar,               SSE4_KERNEL(AlphaToRgba),               AVX2_KERNEL(AlphaToRgba),          NEON_KERNEL(AlphaToRgba)               } },
+    { "4444 -> RGBA",  2, 4, { Rgba4444ToRgbaScalar,            SSE4_KERNEL(Rgba4444ToRgba),            nullptr,                           NEON_KERNEL(Rgba4444ToRgba)            } },
+    { "5551 -> RGBA",  2, 4, { Rgba5551ToRgbaScalar,            SSE4_KERNEL(Rgba5551ToRgba),            nullptr,                           NEON_KERNEL(Rgba5551ToRgba)            } },
+    { "565 -> RGBA",   2, 4, { Rgb565ToRgbaScalar,              SSE4_KERNEL(Rgb565ToRgba),              AVX2_KERNEL(Rgb565ToRgba),         NEON_KERNEL(Rgb565ToRgba)              } },
+    { "565 -> L",      2, 1, { Rgb565ToLuminanceScalar,         SSE4_KERNEL(Rgb565ToLuminance),         nullptr,                           NEON_KERNEL(Rgb565ToLuminance)         } }
+};
+
+static pixelKernelIsa_t
+DetectPixelKernelIsa(void)
+{
+#if defined(GLOVE_PIXEL_KERNELS_X86)
+    if(DetectAvx2() && DetectSse4()) {
+        return PIXEL_KERNEL_ISA_AVX2;
+    }
+    if(DetectSse4()) {
+        return PIXEL_KERNEL_ISA_SSE4;
+    }
+#elif defined(GLOVE_PIXEL_KERNELS_NEON)
+    return PIXEL_KERNEL_ISA_NEON;
+#endif
+    return PIXEL_KERNEL_ISA_SCALAR;
+}
+
+/// The best kernels are resolved once, as the CPU does not change underneath
+struct PixelKernelTable {
+    pixelKernelIsa_t                isa;
+    pixelRowKernel_t                kernels[PIXEL_KERNEL_COUNT];
+
+    PixelKernelTable()
+    : isa(DetectPixelKernelIsa())
+    {
+        for(uint32_t i = 0; i < PIXEL_KERNEL_COUNT; ++i) {
+            // AVX2 kernels are not provided for every pair, so fall back to SSE4 (and then scalar)
+            kernels[i] = nullptr;
+            for(int level = isa; level >= PIXEL_KERNEL_ISA_SCALAR && !kernels[i]; --level) {
+                kernels[i] = pixelKernelInfo[i].kernels[level];
+            }
+        }
+    }
+};
+
+static const PixelKernelTable &
+GetPixelKernelTable(void)
+{
+    static const PixelKernelTable table;
+    return table;
+}
+
+const char *
+PixelKernelToString(pixelKernel_t kernel)
+{
+    return kernel < PIXEL_KERNEL_COUNT ? pixelKernelInfo[kernel].name : "UNKNOWN";
+}
+
+const char *
+PixelKernelIsaToString(pixelKernelIsa_t isa)
+{
+    switch(isa) {
+    case PIXEL_KERNEL_ISA_SCALAR: return "SCALAR";
+    case PIXEL_KERNEL_ISA_SSE4:   return "SSE4";
+    case PIXEL_KERNEL_ISA_AVX2:   return "AVX2";
+    case PIXEL_KERNEL_ISA_NEON:   return "NEON";
+    default:                      return "UNKNOWN";
+    }
+}
+
+uint32_t
+PixelKernelSrcBytes(pixelKernel_t kernel)
+{
+    return pixelKernelInfo[kernel].srcBytes;
+}
+
+uint32_t
+PixelKernelDstBytes(pixelKernel_t kernel)
+{
+    return pixelKernelInfo[kernel].dstBytes;
+}
+
+bool
+PixelKernelIsaSupported(pixelKernelIsa_t isa)
+{
+    const pixelKernelIsa_t best = GetPixelKernelTable().isa;
+
+    switch(isa) {
+    case PIXEL_KERNEL_ISA_SCALAR: return true;
+    case PIXEL_KERNEL_ISA_SSE4:   return best == PIXEL_KERNEL_ISA_SSE4 || best == PIXEL_KERNEL_ISA_AVX2;
+    case PIXEL_KERNEL_ISA_AVX2:   return best == PIXEL_KERNEL_ISA_AVX2;
+    case PIXEL_KERNEL_ISA_NEON:   return best == PIXEL_KERNEL_ISA_NEON;
+    default:                      return false;
+    }
+}
+
+pixelKernelIsa_t
+GetPixelKernelIsa(void)
+{
+    return GetPixelKernelTable().isa;
+}
+
+pixelRowKernel_t
+GetPixelKernel(pixelKernel_t kernel)
+{
+    return GetPixelKernelTable().kernels[kernel];
+}
+
+pixelRowKernel_t
+GetPixelKernel(pixelKernel_t kernel, pixelKernelIsa_t isa)
+{
+    return PixelKernelIsaSupported(isa) ? pixelKernelInfo[kernel].kernels[isa] : nullptr;
+}
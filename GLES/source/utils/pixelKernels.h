@@ -0,0 +1,71 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       pixelKernels.h
+ *  @author     Think Silicon
+ *  @date       25/07/2018
+ *  @version    1.0
+ *
+ *  @brief      Row Kernels for Pixel Format Conversions
+ *
+ */
+
+#ifndef __PIXELKERNELS_H__
+#define __PIXELKERNELS_H__
+
+#include <cstdint>
+
+/// Converts a row of pixels, producing exactly the same bytes as the
+/// respective Color::From* and Color::ConvertTo* pair
+typedef void (*pixelRowKernel_t)(const uint8_t *src, uint8_t *dst, uint32_t pixels);
+
+typedef enum {
+    PIXEL_KERNEL_BGRA_TO_RGBA = 0,
+    PIXEL_KERNEL_BGRA_TO_RGB,
+    PIXEL_KERNEL_BGRA_TO_LUMINANCE_ALPHA,
+    PIXEL_KERNEL_BGRA_TO_LUMINANCE,
+    PIXEL_KERNEL_BGRA_TO_ALPHA,
+    PIXEL_KERNEL_RGBA_TO_RGB,
+    PIXEL_KERNEL_RGBA_TO_ALPHA,
+    PIXEL_KERNEL_RGB_TO_RGBA,
+    PIXEL_KERNEL_LUMINANCE_ALPHA_TO_LUMINANCE,
+    PIXEL_KERNEL_LUMINANCE_ALPHA_TO_RGBA,
+    PIXEL_KERNEL_LUMINANCE_TO_LUMINANCE_ALPHA,
+    PIXEL_KERNEL_LUMINANCE_TO_RGBA,
+    PIXEL_KERNEL_ALPHA_TO_RGBA,
+    PIXEL_KERNEL_4444_TO_RGBA,
+    PIXEL_KERNEL_5551_TO_RGBA,
+    PIXEL_KERNEL_565_TO_RGBA,
+    PIXEL_KERNEL_565_TO_LUMINANCE,
+    PIXEL_KERNEL_COUNT
+} pixelKernel_t;
+
+typedef enum {
+    PIXEL_KERNEL_ISA_SCALAR = 0,
+    PIXEL_KERNEL_ISA_SSE4,
+    PIXEL_KERNEL_ISA_AVX2,
+    PIXEL_KERNEL_ISA_NEON,
+    PIXEL_KERNEL_ISA_COUNT
+} pixelKernelIsa_t;
+
+const char *            PixelKernelToString(pixelKernel_t kernel);
+const char *            PixelKernelIsaToString(pixelKernelIsa_t isa);
+uint32_t                PixelKernelSrcBytes(pixelKernel_t kernel);
+uint32_t                PixelKernelDstBytes(pixelKernel_t kernel);
+bool                    PixelKernelIsaSupported(pixelKernelIsa_t isa);
+pixelKernelIsa_t        GetPixelKernelIsa(void);
+pixelRowKernel_t        GetPixelKernel(pixelKernel_t kernel);
+pixelRowKernel_t        GetPixelKernel(pixelKernel_t kernel, pixelKernelIsa_t isa);
+
+#endif // __PIXELKERNELS_H__
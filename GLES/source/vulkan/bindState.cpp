@@ -0,0 +1,252 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       bindState.cpp
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Shadow of the state bound into a draw command buffer in Vulkan
+ *
+ *  @section
+ *
+ *  Consecutive draws usually share most of their pipeline, descriptor set,
+ *  vertex/index buffers and dynamic state. BindState remembers what has
+ *  already been recorded into the command buffer being built and emits only
+ *  the commands that actually change it. It must be reset whenever recording
+ *  starts into a new command buffer, as bound state is not inherited.
+ *
+ */
+
+#include <cstring>
+#include "bindState.h"
+
+namespace vulkanAPI {
+
+BindState::BindState()
+: mEmittedCount(0), mSkippedCount(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Reset();
+}
+
+BindState::~BindState()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+void
+BindState::Reset(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mVkPipeline          = VK_NULL_HANDLE;
+    mVkPipelineLayout    = VK_NULL_HANDLE;
+    mVkDescSet           = VK_NULL_HANDLE;
+    mDynamicOffsetCount  = 0;
+    mPushConstantsLayout = VK_NULL_HANDLE;
+    mPushConstantsStages = 0;
+    mPushConstantsSize   = 0;
+    mVertexBufferCount   = 0;
+    mIndexBuffer         = VK_NULL_HANDLE;
+    mIndexBufferOffset   = 0;
+    mIndexType           = VK_INDEX_TYPE_UINT16;
+    mViewportValid       = false;
+    mScissorValid        = false;
+    mLineWidthValid      = false;
+}
+
+void
+BindState::ResetCounters(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mEmittedCount = 0;
+    mSkippedCount = 0;
+}
+
+bool
+BindState::Skip(bool redundant)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(redundant) {
+        ++mSkippedCount;
+    } else {
+        ++mEmittedCount;
+    }
+
+    return redundant;
+}
+
+void
+BindState::BindPipeline(const VkCommandBuffer *cmdBuffer, VkPipeline pipeline, uint32_t dynamicStates)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(Skip(mVkPipeline == pipeline)) {
+        return;
+    }
+
+    vkCmdBindPipeline(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+    // State that is static in the new pipeline overwrites the dynamic one
+    // that was set before, so it has to be set again when it becomes dynamic
+    mViewportValid  = mViewportValid  && (dynamicStates & (1 << VK_DYNAMIC_STATE_VIEWPORT));
+    mScissorValid   = mScissorValid   && (dynamicStates & (1 << VK_DYNAMIC_STATE_SCISSOR));
+    mLineWidthValid = mLineWidthValid && (dynamicStates & (1 << VK_DYNAMIC_STATE_LINE_WIDTH));
+
+    mVkPipeline = pipeline;
+}
+
+void
+BindState::BindDescriptorSet(const VkCommandBuffer *cmdBuffer, VkPipelineLayout layout, VkDescriptorSet descSet, uint32_t dynamicOffsetCount, const uint32_t *dynamicOffsets)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(dynamicOffsetCount <= GLOVE_MAX_DYNAMIC_UNIFORM_BUFFERS);
+
+    // uniform data moves within the same set, so the offsets are part of the binding
+    if(Skip(mVkPipelineLayout == layout && mVkDescSet == descSet && mDynamicOffsetCount == dynamicOffsetCount &&
+            (!dynamicOffsetCount || !memcmp(mDynamicOffsets, dynamicOffsets, dynamicOffsetCount * sizeof(*dynamicOffsets))))) {
+        return;
+    }
+
+    vkCmdBindDescriptorSets(*cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descSet, dynamicOffsetCount, dynamicOffsets);
+
+    mVkPipelineLayout   = layout;
+    mVkDescSet          = descSet;
+    mDynamicOffsetCount = dynamicOffsetCount;
+    if(dynamicOffsetCount) {
+        memcpy(mDynamicOffsets, dynamicOffsets, dynamicOffsetCount * sizeof(*dynamicOffsets));
+    }
+}
+
+void
+BindState::BindVertexBuffers(const VkCommandBuffer *cmdBuffer, uint32_t count, const VkBuffer *buffers, const VkDeviceSize *offsets)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(count <= GLOVE_MAX_VERTEX_ATTRIBS);
+
+    // Bindings beyond count are left as they are, so only the changed range is rebound
+    uint32_t first = 0;
+    while(first < count && first < mVertexBufferCount &&
+          mVertexBuffers[first] == buffers[first] && mVertexBufferOffsets[first] == offsets[first]) {
+        ++first;
+    }
+
+    uint32_t last = count;
+    while(last > first && last <= mVertexBufferCount &&
+          mVertexBuffers[last - 1] == buffers[last - 1] && mVertexBufferOffsets[last - 1] == offsets[last - 1]) {
+        --last;
+    }
+
+    if(Skip(first == last)) {
+        return;
+    }
+
+    vkCmdBindVertexBuffers(*cmdBuffer, first, last - first, &buffers[first], &offsets[first]);
+
+    for(uint32_t i = first; i < last; ++i) {
+        mVertexBuffers[i]       = buffers[i];
+        mVertexBufferOffsets[i] = offsets[i];
+    }
+    if(last > mVertexBufferCount) {
+        mVertexBufferCount = last;
+    }
+}
+
+void
+BindState::BindIndexBuffer(const VkCommandBuffer *cmdBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType type)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(Skip(mIndexBuffer == buffer && mIndexBufferOffset == offset && mIndexType == type)) {
+        return;
+    }
+
+    vkCmdBindIndexBuffer(*cmdBuffer, buffer, offset, type);
+
+    mIndexBuffer       = buffer;
+    mIndexBufferOffset = offset;
+    mIndexType         = type;
+}
+
+void
+BindState::PushConstants(const VkCommandBuffer *cmdBuffer, VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t size, const void *data)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(size <= GLOVE_MAX_PUSH_CONSTANTS_SIZE);
+
+    if(Skip(mPushConstantsLayout == layout && mPushConstantsStages == stages && mPushConstantsSize == size && !memcmp(mPushConstants, data, size))) {
+        return;
+    }
+
+    vkCmdPushConstants(*cmdBuffer, layout, stages, 0, size, data);
+
+    mPushConstantsLayout = layout;
+    mPushConstantsStages = stages;
+    mPushConstantsSize   = size;
+    memcpy(mPushConstants, data, size);
+}
+
+void
+BindState::SetViewport(const VkCommandBuffer *cmdBuffer, const VkViewport *viewport)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(Skip(mViewportValid && !memcmp(&mViewport, viewport, sizeof(VkViewport)))) {
+        return;
+    }
+
+    vkCmdSetViewport(*cmdBuffer, 0, 1, viewport);
+
+    mViewport      = *viewport;
+    mViewportValid = true;
+}
+
+void
+BindState::SetScissor(const VkCommandBuffer *cmdBuffer, const VkRect2D *scissor)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(Skip(mScissorValid && !memcmp(&mScissor, scissor, sizeof(VkRect2D)))) {
+        return;
+    }
+
+    vkCmdSetScissor(*cmdBuffer, 0, 1, scissor);
+
+    mScissor      = *scissor;
+    mScissorValid = true;
+}
+
+void
+BindState::SetLineWidth(const VkCommandBuffer *cmdBuffer, float lineWidth)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(Skip(mLineWidthValid && mLineWidth == lineWidth)) {
+        return;
+    }
+
+    vkCmdSetLineWidth(*cmdBuffer, lineWidth);
+
+    mLineWidth      = lineWidth;
+    mLineWidthValid = true;
+}
+
+}
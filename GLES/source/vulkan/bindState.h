@@ -0,0 +1,98 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       bindState.h
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Shadow of the state bound into a draw command buffer in Vulkan
+ *
+ */
+
+#ifndef __VKBINDSTATE_H__
+#define __VKBINDSTATE_H__
+
+#include "context.h"
+#include "utils/globals.h"
+
+namespace vulkanAPI {
+
+class BindState {
+
+private:
+
+    VkPipeline                        mVkPipeline;
+
+    VkPipelineLayout                  mVkPipelineLayout;
+    VkDescriptorSet                   mVkDescSet;
+    uint32_t                          mDynamicOffsetCount;
+    uint32_t                          mDynamicOffsets[GLOVE_MAX_DYNAMIC_UNIFORM_BUFFERS];
+
+    VkPipelineLayout                  mPushConstantsLayout;
+    VkShaderStageFlags                mPushConstantsStages;
+    uint32_t                          mPushConstantsSize;
+    uint8_t                           mPushConstants[GLOVE_MAX_PUSH_CONSTANTS_SIZE];
+
+    uint32_t                          mVertexBufferCount;
+    VkBuffer                          mVertexBuffers[GLOVE_MAX_VERTEX_ATTRIBS];
+    VkDeviceSize                      mVertexBufferOffsets[GLOVE_MAX_VERTEX_ATTRIBS];
+
+    VkBuffer                          mIndexBuffer;
+    VkDeviceSize                      mIndexBufferOffset;
+    VkIndexType                       mIndexType;
+
+    bool                              mViewportValid;
+    VkViewport                        mViewport;
+    bool                              mScissorValid;
+    VkRect2D                          mScissor;
+    bool                              mLineWidthValid;
+    float                             mLineWidth;
+
+    uint64_t                          mEmittedCount;
+    uint64_t                          mSkippedCount;
+
+    bool                              Skip(bool redundant);
+
+public:
+// Constructor
+    BindState();
+
+// Destructor
+    ~BindState();
+
+// Reset Functions
+    void                              Reset(void);
+    void                              ResetCounters(void);
+
+// Bind Functions
+    void                              BindPipeline(const VkCommandBuffer *cmdBuffer, VkPipeline pipeline, uint32_t dynamicStates);
+    void                              BindDescriptorSet(const VkCommandBuffer *cmdBuffer, VkPipelineLayout layout, VkDescriptorSet descSet, uint32_t dynamicOffsetCount = 0, const uint32_t *dynamicOffsets = nullptr);
+    void                              BindVertexBuffers(const VkCommandBuffer *cmdBuffer, uint32_t count, const VkBuffer *buffers, const VkDeviceSize *offsets);
+    void                              BindIndexBuffer(const VkCommandBuffer *cmdBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType type);
+    void                              PushConstants(const VkCommandBuffer *cmdBuffer, VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t size, const void *data);
+
+// Set Functions
+    void                              SetViewport(const VkCommandBuffer *cmdBuffer, const VkViewport *viewport);
+    void                              SetScissor(const VkCommandBuffer *cmdBuffer, const VkRect2D *scissor);
+    void                              SetLineWidth(const VkCommandBuffer *cmdBuffer, float lineWidth);
+
+// Get Functions
+    inline uint64_t                   GetEmittedCount(void)               const { FUN_ENTRY(GL_LOG_TRACE); return mEmittedCount; }
+    inline uint64_t                   GetSkippedCount(void)               const { FUN_ENTRY(GL_LOG_TRACE); return mSkippedCount; }
+};
+
+}
+
+#endif // __VKBINDSTATE_H__
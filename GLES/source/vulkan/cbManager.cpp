@@ -32,27 +32,54 @@
  */
 
 #include "cbManager.h"
+#include "deviceAllocator.h"
 
 namespace vulkanAPI {
 
 #define GLOVE_NO_BUFFER_TO_WAIT                         0x7FFFFFFF
-#define GLOVE_NUM_COMMAND_BUFFERS                       2
+// Number of submission slots in the ring. The CPU only blocks on a slot's
+// fence when the ring wraps around to it. Set with NUM_COMMAND_BUFFERS in CMake
+#ifndef GLOVE_NUM_COMMAND_BUFFERS
+#   define GLOVE_NUM_COMMAND_BUFFERS                    3
+#endif
 #define GLOVE_FENCE_WAIT_TIMEOUT                        UINT64_MAX
 
+// Record draws straight into the active primary command buffer instead of
+// wrapping each of them into a secondary command buffer
+#define GLOVE_INLINE_DRAW_RECORDING                     true
+
+// Size of the host visible ring that texture and buffer uploads are staged in
+#define GLOVE_STAGING_RING_SIZE                         (4 * 1024 * 1024)
+
+// Size of the host visible ring that client vertex and index arrays are streamed in
+#define GLOVE_STREAMING_RING_SIZE                       (8 * 1024 * 1024)
+
+// Size of the host visible ring that uniform block data is written in
+#define GLOVE_UNIFORM_RING_SIZE                         (4 * 1024 * 1024)
+
 CommandBufferManager *CommandBufferManager::mInstance = nullptr;
 
 CommandBufferManager::CommandBufferManager(const vkContext_t *context)
-: mVkContext(context)
+: mVkContext(context), mStagingRing(context),
+  mStreamingRing(context, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT),
+  mUniformRing(context, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
     mActiveCmdBuffer    = 0;
     mLastSubmittedBuffer= GLOVE_NO_BUFFER_TO_WAIT;
+    mSubmittedSerial    = 0;
+    mCompletedSerial    = 0;
+    mInlineRecording    = GLOVE_INLINE_DRAW_RECORDING;
+    mRenderPassActive   = false;
 
     mVkCmdPool          = VK_NULL_HANDLE;
     mVkAuxCommandBuffer = VK_NULL_HANDLE;
     mVkAuxFence         = VK_NULL_HANDLE;
 
+    memset(static_cast<void *>(&mUploadStats), 0, sizeof(mUploadStats));
+    mPrintUploadStats   = getenv("GLOVE_UPLOAD_STATS") != nullptr;
+
     if(!AllocateVkCmdPool()) {
         assert(false);
         return ;
@@ -69,20 +96,26 @@ CommandBufferManager::~CommandBufferManager()
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    for(uint32_t i = 0; i < mReferencedResources.size(); ++i) {
-        mReferencedResources[i]->mRefCount = 0;
+    if(mPrintUploadStats) {
+        PrintUploadStats();
     }
 
-    FreeResources();
-
-    mReferencedResources.clear();
-
     if(mVkContext->vkDevice != VK_NULL_HANDLE ) {
 
         vkDeviceWaitIdle(mVkContext->vkDevice);
 
+        std::vector<resource_t> resources;
+        mReferencedResources.Release(&resources);
+        for(const auto &resource : resources) {
+            DestroyResource(resource);
+        }
+
         DestroyVkCmdBuffers();
 
+        mStagingRing.Release();
+        mStreamingRing.Release();
+        mUniformRing.Release();
+
         if(mVkCmdPool != VK_NULL_HANDLE) {
             vkDestroyCommandPool(mVkContext->vkDevice, mVkCmdPool, nullptr);
             mVkCmdPool = VK_NULL_HANDLE;
@@ -95,30 +128,53 @@ CommandBufferManager::DestroyVkCmdBuffers(void)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
+    for(uint32_t i = 0; i < mVkCommandBuffers.retiredResources.size(); ++i) {
+        FreeResources(i);
+    }
+
     for(uint32_t i = 0; i < mVkCommandBuffers.fence.size(); ++i) {
         mVkCommandBuffers.fence[i].Release();
     }
 
+    for(uint32_t i = 0; i < mVkCommandBuffers.secondaryCmdBufferPool.size(); ++i) {
+        CommandBufferPool &secondaryCmdBufferPool = mVkCommandBuffers.secondaryCmdBufferPool[i];
+        uint32_t secondaryBuffersPoolSize = secondaryCmdBufferPool.GetSize();
+
+        for(uint32_t j = 0; j < secondaryBuffersPoolSize; ++j) {
+            VkCommandBuffer *removingSecondaryBuffer = secondaryCmdBufferPool.RemoveBuffer();
+            if(removingSecondaryBuffer) {
+                vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPool, 1, removingSecondaryBuffer);
+                delete removingSecondaryBuffer;
+            }
+        }
+    }
+
+    // Uploads and barriers that were never submitted are dropped along with their command buffers
+    mStagingRing.Reclaim(UINT64_MAX);
+    mStreamingRing.Reclaim(UINT64_MAX);
+    mUniformRing.Reclaim(UINT64_MAX);
+    mDrawBarrier.Reset();
+    mUploadBarrier.Reset();
+    mRenderPassActive = false;
+
     vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPool, (uint32_t)mVkCommandBuffers.commandBuffer.size(), mVkCommandBuffers.commandBuffer.data());
+    vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPool, (uint32_t)mVkCommandBuffers.uploadCommandBuffer.size(), mVkCommandBuffers.uploadCommandBuffer.data());
     mVkCommandBuffers.commandBuffer.clear();
     mVkCommandBuffers.commandBufferState.clear();
     mVkCommandBuffers.fence.clear();
-    memset(static_cast<void *>(&mVkCommandBuffers), 0, mVkCommandBuffers.commandBuffer.size()*sizeof(State));
+    mVkCommandBuffers.serial.clear();
+    mVkCommandBuffers.retiredResources.clear();
+    mVkCommandBuffers.secondaryCmdBufferPool.clear();
+    mVkCommandBuffers.uploadCommandBuffer.clear();
+    mVkCommandBuffers.uploadCommandBufferState.clear();
+
+    mActiveCmdBuffer     = 0;
+    mLastSubmittedBuffer = GLOVE_NO_BUFFER_TO_WAIT;
 
     if(mVkAuxCommandBuffer != VK_NULL_HANDLE) {
         vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPool, 1, &mVkAuxCommandBuffer);
         mVkAuxCommandBuffer = VK_NULL_HANDLE;
     }
-
-    uint32_t secondaryBuffersPoolSize = mSecondaryCmdBufferPool.GetSize();
-
-    for(uint32_t i = 0; i < secondaryBuffersPoolSize; ++i) {
-        VkCommandBuffer *removingSecondaryBuffer = mSecondaryCmdBufferPool.RemoveBuffer();
-        if(removingSecondaryBuffer) {
-            vkFreeCommandBuffers(mVkContext->vkDevice, mVkCmdPool, 1, removingSecondaryBuffer);
-            delete removingSecondaryBuffer;
-        }
-    }
 }
 
 void
@@ -135,7 +191,8 @@ CommandBufferManager::AllocateVkSecondaryCmdBuffers(uint32_t numOfBuffers)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkCommandBuffer *reusedCommandBuffer = mSecondaryCmdBufferPool.BindNextAvailableBuffer();
+    CommandBufferPool &secondaryCmdBufferPool = mVkCommandBuffers.secondaryCmdBufferPool[mActiveCmdBuffer];
+    VkCommandBuffer *reusedCommandBuffer = secondaryCmdBufferPool.BindNextAvailableBuffer();
 
     if(nullptr != reusedCommandBuffer) {
         return reusedCommandBuffer;
@@ -159,48 +216,57 @@ CommandBufferManager::AllocateVkSecondaryCmdBuffers(uint32_t numOfBuffers)
     }
 
     for (uint32_t i = 0; i < numOfBuffers; ++i) {
-        mSecondaryCmdBufferPool.AddBuffer(commandBuffers + i);
+        secondaryCmdBufferPool.AddBuffer(commandBuffers + i);
     }
 
     return commandBuffers;
 }
 
 void
-CommandBufferManager::FreeResources(void)
+CommandBufferManager::DestroyResource(const resource_t &resource)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    for(std::vector<resourceBase_t *>::iterator it = mReferencedResources.begin(); it != mReferencedResources.end();) {
-        const resourceBase_t *resourceBase = *it;
-        if(!resourceBase->mRefCount) {
-            switch(resourceBase->mType) {
-            case RESOURCE_TYPE_SHADER: {
-                referencedResource_t<VkShaderModule> *resource = (referencedResource_t<VkShaderModule> *)resourceBase;
-                vkDestroyShaderModule(mVkContext->vkDevice, resource->mResourcePtr, nullptr);
-                } break;
-            case RESOURCE_TYPE_PIPELINE_LAYOUT: {
-                referencedResource_t<VkPipelineLayout> *resource = (referencedResource_t<VkPipelineLayout> *)resourceBase;
-                vkDestroyPipelineLayout(mVkContext->vkDevice, resource->mResourcePtr, nullptr);
-                } break;
-            case RESOURCE_TYPE_DESC_POOL: {
-                referencedResource_t<VkDescriptorPool> *resource = (referencedResource_t<VkDescriptorPool> *)resourceBase;
-                vkDestroyDescriptorPool(mVkContext->vkDevice, resource->mResourcePtr, nullptr);
-                } break;
-            case RESOURCE_TYPE_DESC_SET_LAYOUT: {
-                referencedResource_t<VkDescriptorSetLayout> *resource = (referencedResource_t<VkDescriptorSetLayout> *)resourceBase;
-                vkDestroyDescriptorSetLayout(mVkContext->vkDevice, resource->mResourcePtr, nullptr);
-                } break;
-            default: NOT_REACHED(); break;
-            }
+    switch(resource.type) {
+    case RESOURCE_TYPE_SHADER:
+        vkDestroyShaderModule(mVkContext->vkDevice, (VkShaderModule)resource.handle, nullptr);
+        break;
+    case RESOURCE_TYPE_PIPELINE_LAYOUT:
+        vkDestroyPipelineLayout(mVkContext->vkDevice, (VkPipelineLayout)resource.handle, nullptr);
+        break;
+    case RESOURCE_TYPE_DESC_POOL:
+        vkDestroyDescriptorPool(mVkContext->vkDevice, (VkDescriptorPool)resource.handle, nullptr);
+        break;
+    case RESOURCE_TYPE_DESC_SET_LAYOUT:
+        vkDestroyDescriptorSetLayout(mVkContext->vkDevice, (VkDescriptorSetLayout)resource.handle, nullptr);
+        break;
+    default: NOT_REACHED(); break;
+    }
+}
 
-            delete *it;
-            it = mReferencedResources.erase(it);
-        } else {
-            ++it;
-        }
+void
+CommandBufferManager::RetireResource(const resource_t &resource)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // The resource may still be referenced by the slot being recorded or by
+    // any slot submitted before it. As the queue completes in order, it can
+    // be destroyed once the fence of the active slot has been signaled.
+    mVkCommandBuffers.retiredResources[mActiveCmdBuffer].push_back(resource);
+}
+
+void
+CommandBufferManager::FreeResources(uint32_t slot)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::vector<resource_t> &retiredResources = mVkCommandBuffers.retiredResources[slot];
+    for(const auto &resource : retiredResources) {
+        DestroyResource(resource);
     }
+    retiredResources.clear();
 
-    mSecondaryCmdBufferPool.UnbindAllBuffers();
+    mVkCommandBuffers.secondaryCmdBufferPool[slot].UnbindAllBuffers();
 }
 
 bool
@@ -233,6 +299,11 @@ CommandBufferManager::AllocateVkCmdBuffers(void)
     mVkCommandBuffers.commandBuffer.resize(GLOVE_NUM_COMMAND_BUFFERS);
     mVkCommandBuffers.commandBufferState.resize(GLOVE_NUM_COMMAND_BUFFERS);
     mVkCommandBuffers.fence.resize(GLOVE_NUM_COMMAND_BUFFERS);
+    mVkCommandBuffers.serial.resize(GLOVE_NUM_COMMAND_BUFFERS, 0);
+    mVkCommandBuffers.retiredResources.resize(GLOVE_NUM_COMMAND_BUFFERS);
+    mVkCommandBuffers.secondaryCmdBufferPool.resize(GLOVE_NUM_COMMAND_BUFFERS);
+    mVkCommandBuffers.uploadCommandBuffer.resize(GLOVE_NUM_COMMAND_BUFFERS);
+    mVkCommandBuffers.uploadCommandBufferState.resize(GLOVE_NUM_COMMAND_BUFFERS);
 
     VkCommandBufferAllocateInfo cmdAllocInfo;
     cmdAllocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -248,6 +319,13 @@ CommandBufferManager::AllocateVkCmdBuffers(void)
         return false;
     }
 
+    err = vkAllocateCommandBuffers(mVkContext->vkDevice, &cmdAllocInfo, mVkCommandBuffers.uploadCommandBuffer.data());
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return false;
+    }
+
     cmdAllocInfo.commandBufferCount = 1;
     err = vkAllocateCommandBuffers(mVkContext->vkDevice, &cmdAllocInfo, &mVkAuxCommandBuffer);
     assert(!err);
@@ -257,7 +335,8 @@ CommandBufferManager::AllocateVkCmdBuffers(void)
     }
 
     for(uint32_t i = 0; i < GLOVE_NUM_COMMAND_BUFFERS; ++i) {
-        mVkCommandBuffers.commandBufferState[i] = CMD_BUFFER_INITIAL_STATE;
+        mVkCommandBuffers.commandBufferState[i]       = CMD_BUFFER_INITIAL_STATE;
+        mVkCommandBuffers.uploadCommandBufferState[i] = CMD_BUFFER_INITIAL_STATE;
 
         mVkCommandBuffers.fence[i].SetContext(mVkContext);
         if(!mVkCommandBuffers.fence[i].Create(false)) {
@@ -292,6 +371,8 @@ CommandBufferManager::BeginVkDrawCommandBuffer(void)
 
     mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_RECORDING_STATE;
 
+    mBindState.Reset();
+
     return true;
 }
 
@@ -325,6 +406,76 @@ CommandBufferManager::BeginVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBu
     return true;
 }
 
+VkCommandBuffer *
+CommandBufferManager::BeginVkDrawRecording(VkRenderPass renderPass, VkFramebuffer framebuffer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mInlineRecording) {
+        return &mVkCommandBuffers.commandBuffer[mActiveCmdBuffer];
+    }
+
+    VkCommandBuffer *secondaryCmdBuffer = AllocateVkSecondaryCmdBuffers(1);
+    if(secondaryCmdBuffer == nullptr || !BeginVkSecondaryCommandBuffer(secondaryCmdBuffer, renderPass, framebuffer)) {
+        return nullptr;
+    }
+
+    mBindState.Reset();
+
+    return secondaryCmdBuffer;
+}
+
+VkCommandBuffer *
+CommandBufferManager::BeginVkUploadCommandBuffer(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkCommandBuffer *uploadCmdBuffer = &mVkCommandBuffers.uploadCommandBuffer[mActiveCmdBuffer];
+
+    if(mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE) {
+        mUploadBarrier.Flush(uploadCmdBuffer);
+        return uploadCmdBuffer;
+    }
+
+    VkCommandBufferBeginInfo info;
+    info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    info.pNext            = nullptr;
+    info.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    info.pInheritanceInfo = nullptr;
+
+    VkResult err = vkBeginCommandBuffer(*uploadCmdBuffer, &info);
+    assert(!err);
+
+    if(err != VK_SUCCESS) {
+        return nullptr;
+    }
+
+    mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_RECORDING_STATE;
+
+    mUploadBarrier.Flush(uploadCmdBuffer);
+
+    return uploadCmdBuffer;
+}
+
+bool
+CommandBufferManager::EndVkUploadCommandBuffer(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // Transitions still pending for the upload stream need a command buffer to be recorded into
+    if(!mUploadBarrier.IsEmpty() && BeginVkUploadCommandBuffer() == nullptr) {
+        return false;
+    }
+
+    if(mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] != CMD_BUFFER_RECORDING_STATE) {
+        return false;
+    }
+
+    vkEndCommandBuffer(mVkCommandBuffers.uploadCommandBuffer[mActiveCmdBuffer]);
+    mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_SUBMITED_STATE;
+
+    return true;
+}
 
 void
 CommandBufferManager::EndVkDrawCommandBuffer(void)
@@ -336,6 +487,7 @@ CommandBufferManager::EndVkDrawCommandBuffer(void)
         return;
     }
 
+    FlushDrawBarrier();
     vkEndCommandBuffer(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]);
 
     mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_EXECUTABLE_STATE;
@@ -349,22 +501,48 @@ CommandBufferManager::EndVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuff
     vkEndCommandBuffer(*cmdBuffer);
 }
 
+void
+CommandBufferManager::EndVkDrawRecording(const VkCommandBuffer *cmdBuffer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mInlineRecording) {
+        return;
+    }
+
+    EndVkSecondaryCommandBuffer(cmdBuffer);
+    vkCmdExecuteCommands(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer], 1, cmdBuffer);
+}
+
 bool
 CommandBufferManager::SubmitVkDrawCommandBuffer(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] == CMD_BUFFER_INITIAL_STATE) {
+    const bool drawRecorded   = mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] != CMD_BUFFER_INITIAL_STATE;
+    const bool uploadRecorded = EndVkUploadCommandBuffer();
+
+    if(!drawRecorded && !uploadRecorded) {
         return true;
     }
 
+    // Pending uploads go first in the same batch, so that the draws of this
+    // submission see them without any extra synchronization with the CPU
+    std::vector<VkCommandBuffer> cmdBuffers;
+    if(uploadRecorded) {
+        cmdBuffers.push_back(mVkCommandBuffers.uploadCommandBuffer[mActiveCmdBuffer]);
+    }
+    if(drawRecorded) {
+        cmdBuffers.push_back(mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]);
+    }
+
     std::vector<VkSemaphore> pSems;
     std::vector<VkPipelineStageFlags> pFlags;
-    if(mVkContext->vkSyncItems->acquireSemaphoreFlag) {
+    if(drawRecorded && mVkContext->vkSyncItems->acquireSemaphoreFlag) {
         pSems.push_back(mVkContext->vkSyncItems->vkAcquireSemaphore);
         pFlags.push_back(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
     }
-    if(mVkContext->vkSyncItems->drawSemaphoreFlag) {
+    if(drawRecorded && mVkContext->vkSyncItems->drawSemaphoreFlag) {
         pSems.push_back(mVkContext->vkSyncItems->vkDrawSemaphore);
         pFlags.push_back(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
     }
@@ -372,16 +550,21 @@ CommandBufferManager::SubmitVkDrawCommandBuffer(void)
     VkSubmitInfo submitInfo;
     submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.pNext                = nullptr;
-    submitInfo.commandBufferCount   = 1;
-    submitInfo.pCommandBuffers      = &mVkCommandBuffers.commandBuffer[mActiveCmdBuffer];
+    submitInfo.commandBufferCount   = static_cast<uint32_t>(cmdBuffers.size());
+    submitInfo.pCommandBuffers      = cmdBuffers.data();
     submitInfo.waitSemaphoreCount   = static_cast<uint32_t>(pSems.size());
     submitInfo.pWaitSemaphores      = pSems.data();
     submitInfo.pWaitDstStageMask    = pFlags.data();
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores    = &mVkContext->vkSyncItems->vkDrawSemaphore;
+    submitInfo.signalSemaphoreCount = drawRecorded ? 1 : 0;
+    submitInfo.pSignalSemaphores    = drawRecorded ? &mVkContext->vkSyncItems->vkDrawSemaphore : nullptr;
 
-    mVkContext->vkSyncItems->drawSemaphoreFlag    = true;
-    mVkContext->vkSyncItems->acquireSemaphoreFlag = false;
+    if(drawRecorded) {
+        mVkContext->vkSyncItems->drawSemaphoreFlag    = true;
+        mVkContext->vkSyncItems->acquireSemaphoreFlag = false;
+    }
+
+    // host writes to non-coherent memory must reach the device before the commands execute
+    mVkContext->deviceAllocator->FlushMappedRanges();
 
     VkResult err = vkQueueSubmit(mVkContext->vkQueue, 1, &submitInfo, mVkCommandBuffers.fence[mActiveCmdBuffer].GetFence());
     assert(!err);
@@ -391,35 +574,260 @@ CommandBufferManager::SubmitVkDrawCommandBuffer(void)
     }
 
     mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_SUBMITED_STATE;
+    {
+        std::lock_guard<std::mutex> lock(mSerialMutex);
+        mVkCommandBuffers.serial[mActiveCmdBuffer] = ++mSubmittedSerial;
+    }
+
+    GLOVE_PRINT(GL_LOG_DEBUG, "Submission %llu: %llu binds recorded, %llu redundant binds skipped\n",
+                static_cast<unsigned long long>(mSubmittedSerial),
+                static_cast<unsigned long long>(mBindState.GetEmittedCount()),
+                static_cast<unsigned long long>(mBindState.GetSkippedCount()));
+    mBindState.ResetCounters();
 
     mLastSubmittedBuffer = mActiveCmdBuffer;
     mActiveCmdBuffer = (mActiveCmdBuffer + 1) % GLOVE_NUM_COMMAND_BUFFERS;
 
-    mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] = CMD_BUFFER_INITIAL_STATE;
+    // The ring wrapped around to a slot that may still be in flight
+    if(!WaitSlot(mActiveCmdBuffer)) {
+        return false;
+    }
 
     return true;
 }
 
 bool
-CommandBufferManager::WaitLastSubmition(void)
+CommandBufferManager::WaitSlot(uint32_t slot)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mVkCommandBuffers.commandBufferState[slot] == CMD_BUFFER_SUBMITED_STATE) {
+
+        if(!mVkCommandBuffers.fence[slot].Wait(VK_TRUE, GLOVE_FENCE_WAIT_TIMEOUT)) {
+            return false;
+        }
+
+        if(static_cast<int32_t>(slot) == mLastSubmittedBuffer) {
+            mLastSubmittedBuffer = GLOVE_NO_BUFFER_TO_WAIT;
+        }
+
+        // WaitSerial may be waiting on this fence from another thread
+        std::lock_guard<std::mutex> lock(mSerialMutex);
+
+        if(!mVkCommandBuffers.fence[slot].Reset()) {
+            return false;
+        }
+
+        if(mCompletedSerial < mVkCommandBuffers.serial[slot]) {
+            mCompletedSerial = mVkCommandBuffers.serial[slot];
+        }
+        mVkCommandBuffers.serial[slot] = 0;
+    }
+
+    FreeResources(slot);
+
+    mVkCommandBuffers.commandBufferState[slot] = CMD_BUFFER_INITIAL_STATE;
+    if(mVkCommandBuffers.uploadCommandBufferState[slot] == CMD_BUFFER_SUBMITED_STATE) {
+        mVkCommandBuffers.uploadCommandBufferState[slot] = CMD_BUFFER_INITIAL_STATE;
+    }
+
+    mStagingRing.Reclaim(mCompletedSerial);
+    mStreamingRing.Reclaim(mCompletedSerial);
+    mUniformRing.Reclaim(mCompletedSerial);
+
+    return true;
+}
+
+bool
+CommandBufferManager::FlushVkUploadCommandBuffer(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mLastSubmittedBuffer != GLOVE_NO_BUFFER_TO_WAIT) {
+    if(EndVkUploadCommandBuffer()) {
+        VkSubmitInfo info = {};
+        info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.pNext                  = nullptr;
+        info.commandBufferCount     = 1;
+        info.pCommandBuffers        = &mVkCommandBuffers.uploadCommandBuffer[mActiveCmdBuffer];
+
+        mVkContext->deviceAllocator->FlushMappedRanges();
+
+        VkResult err = vkQueueSubmit(mVkContext->vkQueue, 1, &info, VK_NULL_HANDLE);
+        assert(!err);
+
+        if(err != VK_SUCCESS) {
+            return false;
+        }
+    }
+
+    return WaitVkAuxCommandBuffer();
+}
+
+bool
+CommandBufferManager::AllocateStagingMemory(VkDeviceSize size, VkDeviceSize alignment, const void *data, VkBuffer *buffer, VkDeviceSize *offset)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mStagingRing.IsCreated() && !mStagingRing.Create(GLOVE_STAGING_RING_SIZE)) {
+        return false;
+    }
+
+    if(size > mStagingRing.GetSize()) {
+        return false;
+    }
 
-        if(!mVkCommandBuffers.fence[mLastSubmittedBuffer].Wait(VK_TRUE, GLOVE_FENCE_WAIT_TIMEOUT))
+    // The ring is full of in-flight uploads, so block until they are consumed
+    if(!mStagingRing.Allocate(size, alignment, GetActiveSerial(), offset)) {
+        if(!FlushVkUploadCommandBuffer() ||
+           !mStagingRing.Allocate(size, alignment, GetActiveSerial(), offset)) {
             return false;
+        }
+    }
+
+    if(!mStagingRing.SetData(size, *offset, data)) {
+        return false;
+    }
+
+    *buffer = mStagingRing.GetVkBuffer();
+
+    return true;
+}
+
+bool
+CommandBufferManager::AllocateStreamingMemory(VkDeviceSize size, VkDeviceSize alignment, const void *data, VkBuffer *buffer, VkDeviceSize *offset)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mStreamingRing.IsCreated() && !mStreamingRing.Create(GLOVE_STREAMING_RING_SIZE)) {
+        return false;
+    }
+
+    // Streamed data is consumed by the draws being recorded, so a full ring
+    // cannot be drained here and the caller falls back to a buffer of its own
+    if(!mStreamingRing.Allocate(size, alignment, GetActiveSerial(), offset) ||
+       !mStreamingRing.SetData(size, *offset, data)) {
+        return false;
+    }
+
+    *buffer = mStreamingRing.GetVkBuffer();
+
+    return true;
+}
+
+bool
+CommandBufferManager::AllocateUniformMemory(VkDeviceSize size, const void *data, VkBuffer *buffer, VkDeviceSize *offset)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mUniformRing.IsCreated() && !mUniformRing.Create(GLOVE_UNIFORM_RING_SIZE)) {
+        return false;
+    }
+
+    // Offsets are passed as dynamic offsets, so they must respect the device alignment.
+    // As with streamed arrays, a full ring cannot be drained while the draws are recorded
+    const VkDeviceSize alignment = mVkContext->vkDeviceProperties.limits.minUniformBufferOffsetAlignment;
+    if(!mUniformRing.Allocate(size, alignment, GetActiveSerial(), offset) ||
+       !mUniformRing.SetData(size, *offset, data)) {
+        return false;
+    }
+
+    *buffer = mUniformRing.GetVkBuffer();
+
+    return true;
+}
 
-        FreeResources();
+bool
+CommandBufferManager::WaitLastSubmition(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
-        if(!mVkCommandBuffers.fence[mLastSubmittedBuffer].Reset()) {
+    // Uploads not followed by any draw are not part of a slot submission
+    if((mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE || !mUploadBarrier.IsEmpty()) &&
+      !FlushVkUploadCommandBuffer()) {
+        return false;
+    }
+
+    // Fences are signaled in submission order, so once the most recent
+    // submission has completed, every other in-flight slot has too
+    if(mLastSubmittedBuffer != GLOVE_NO_BUFFER_TO_WAIT &&
+      !mVkCommandBuffers.fence[mLastSubmittedBuffer].Wait(VK_TRUE, GLOVE_FENCE_WAIT_TIMEOUT)) {
+        return false;
+    }
+
+    for(uint32_t i = 0; i < GLOVE_NUM_COMMAND_BUFFERS; ++i) {
+        if(mVkCommandBuffers.commandBufferState[i] == CMD_BUFFER_SUBMITED_STATE && !WaitSlot(i)) {
             return false;
         }
+    }
+
+    // Nothing has been recorded in the active slot yet, so the resources
+    // retired in it can only be referenced by the completed submissions
+    if(mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] == CMD_BUFFER_INITIAL_STATE) {
+        FreeResources(mActiveCmdBuffer);
+    }
+
+    return true;
+}
+
+bool
+CommandBufferManager::UpdateCompletedSerial(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // Non-blocking: retire every submitted slot whose fence has already
+    // been signaled, which advances the completed serial
+    for(uint32_t i = 0; i < GLOVE_NUM_COMMAND_BUFFERS; ++i) {
+        if(mVkCommandBuffers.commandBufferState[i] == CMD_BUFFER_SUBMITED_STATE &&
+           mVkCommandBuffers.fence[i].IsSignaled()) {
+            if(!WaitSlot(i)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+uint64_t
+CommandBufferManager::GetFenceSerial(void) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // A fence covers everything recorded so far. If anything is still
+    // pending, it goes with the next submission, else with the last one
+    const bool pending = mVkCommandBuffers.commandBufferState[mActiveCmdBuffer]       != CMD_BUFFER_INITIAL_STATE ||
+                         mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE;
 
-        mLastSubmittedBuffer = GLOVE_NO_BUFFER_TO_WAIT;
+    return pending ? GetActiveSerial() : mSubmittedSerial;
+}
+
+bool
+CommandBufferManager::WaitSerial(uint64_t serial, uint64_t timeout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // This may run on another thread than the one recording. The lock is
+    // held during the wait, so the owner cannot reset the fence or reuse
+    // its slot meanwhile. The slot is retired by the owner on its next update
+    std::lock_guard<std::mutex> lock(mSerialMutex);
+
+    if(serial <= mCompletedSerial) {
         return true;
     }
 
+    // Commands that have not been submitted yet can never complete
+    if(serial > mSubmittedSerial) {
+        return false;
+    }
+
+    // The serial of a slot is cleared when its fence is reset
+    for(uint32_t i = 0; i < GLOVE_NUM_COMMAND_BUFFERS; ++i) {
+        if(mVkCommandBuffers.serial[i] == serial) {
+            return mVkCommandBuffers.fence[i].IsSignaled(timeout);
+        }
+    }
+
+    // The slot of the submission has already been retired
     return true;
 }
 
@@ -456,11 +864,21 @@ CommandBufferManager::SubmitVkAuxCommandBuffer(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    // Pending uploads are executed ahead of the aux commands, which may read
+    // back or transition the very images they write
+    std::vector<VkCommandBuffer> cmdBuffers;
+    if(EndVkUploadCommandBuffer()) {
+        cmdBuffers.push_back(mVkCommandBuffers.uploadCommandBuffer[mActiveCmdBuffer]);
+    }
+    cmdBuffers.push_back(mVkAuxCommandBuffer);
+
     VkSubmitInfo info = {};
     info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     info.pNext                  = nullptr;
-    info.commandBufferCount     = 1;
-    info.pCommandBuffers        = &mVkAuxCommandBuffer;
+    info.commandBufferCount     = static_cast<uint32_t>(cmdBuffers.size());
+    info.pCommandBuffers        = cmdBuffers.data();
+
+    mVkContext->deviceAllocator->FlushMappedRanges();
 
     VkResult err = vkQueueSubmit(mVkContext->vkQueue, 1, &info, mVkAuxFence);
     assert(!err);
@@ -476,7 +894,72 @@ CommandBufferManager::WaitVkAuxCommandBuffer(void)
     VkResult err = vkQueueWaitIdle(mVkContext->vkQueue);
     assert(!err);
 
+    if(err == VK_SUCCESS) {
+        {
+            std::lock_guard<std::mutex> lock(mSerialMutex);
+            mCompletedSerial = mSubmittedSerial;
+        }
+
+        // The queue is idle, so the uploads flushed with the aux command
+        // buffer and every staging allocation of past submissions are done
+        if(mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_SUBMITED_STATE) {
+            mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] = CMD_BUFFER_INITIAL_STATE;
+        }
+        if(mVkCommandBuffers.uploadCommandBufferState[mActiveCmdBuffer] == CMD_BUFFER_INITIAL_STATE) {
+            mStagingRing.Reclaim(UINT64_MAX);
+        }
+
+        // streamed arrays and uniforms of the draws being recorded are still in use
+        mStreamingRing.Reclaim(mCompletedSerial);
+        mUniformRing.Reclaim(mCompletedSerial);
+    }
+
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY && err != VK_ERROR_DEVICE_LOST);
 }
 
+void
+CommandBufferManager::PrintUploadStats(void) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    GLOVE_PRINT(GL_LOG_DEBUG, "GLOVE texture uploads: %u sub-image updates queued, %u superseded\n",
+                mUploadStats.queuedUpdates, mUploadStats.supersededUpdates);
+    GLOVE_PRINT(GL_LOG_DEBUG, "  %u copies with %u regions (%.1f regions per copy), %llu KB staged\n",
+                mUploadStats.copyCommands, mUploadStats.copyRegions,
+                mUploadStats.copyCommands ? static_cast<double>(mUploadStats.copyRegions) / mUploadStats.copyCommands : 0.0,
+                static_cast<unsigned long long>(mUploadStats.copyBytes >> 10));
+}
+
+PipelineBarrier *
+CommandBufferManager::GetPendingBarrier(cmdStream_t stream)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // The upload command buffer runs ahead of the draws of its slot, so a
+    // transition for a copy recorded there must precede it in that stream
+    if(stream == CMD_STREAM_UPLOAD) {
+        return &mUploadBarrier;
+    }
+
+    // Between render passes a transition is recorded into the draw command
+    // buffer, right before the commands that follow it. Otherwise it cannot
+    // be recorded there, so it is moved ahead of the draws of the active
+    // slot, into the upload stream
+    if(mVkCommandBuffers.commandBufferState[mActiveCmdBuffer] == CMD_BUFFER_RECORDING_STATE && !mRenderPassActive) {
+        return &mDrawBarrier;
+    }
+
+    return &mUploadBarrier;
+}
+
+void
+CommandBufferManager::FlushDrawBarrier(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!mDrawBarrier.IsEmpty()) {
+        mDrawBarrier.Flush(&mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]);
+    }
+}
+
 }
@@ -24,10 +24,15 @@
 #ifndef __VKCBMANAGER_H__
 #define __VKCBMANAGER_H__
 
+#include <mutex>
 #include <vector>
 #include "context.h"
 #include "fence.h"
 #include "commandBufferPool.h"
+#include "stagingRing.h"
+#include "pipelineBarrier.h"
+#include "resourceTable.h"
+#include "bindState.h"
 
 namespace vulkanAPI {
 
@@ -38,42 +43,32 @@ typedef enum {
     CMD_BUFFER_SUBMITED_STATE
 } cmdBufferState_t;
 
+/// The command stream that uses an image after a layout transition
 typedef enum {
-    RESOURCE_TYPE_SHADER = 0,
-    RESOURCE_TYPE_PIPELINE_LAYOUT,
-    RESOURCE_TYPE_DESC_POOL,
-    RESOURCE_TYPE_DESC_SET_LAYOUT,
-    RESOURCE_TYPE_DESC_SET,
-    RESOURCE_TYPE_LAST
-} resourceType_t;
-
-class resourceBase_t {
-public:
-
-    uint32_t                        mRefCount;
-    resourceType_t                  mType;
-
-    resourceBase_t(resourceType_t type) : mRefCount(1), mType(type)             { FUN_ENTRY(GL_LOG_TRACE); }
-    virtual ~resourceBase_t()                                                   { FUN_ENTRY(GL_LOG_TRACE); }
-};
-
-template<typename T>
-class referencedResource_t : public resourceBase_t {
-public:
-
-    T                               mResourcePtr;
-
-    referencedResource_t(T resourcePtr, resourceType_t type)
-    : resourceBase_t(type), mResourcePtr(resourcePtr)                           { FUN_ENTRY(GL_LOG_TRACE); }
-};
+    CMD_STREAM_DRAW = 0,
+    CMD_STREAM_UPLOAD
+} cmdStream_t;
+
+typedef struct uploadStats_t {
+    uint32_t                                        queuedUpdates;      /// sub-image updates queued for merging
+    uint32_t                                        supersededUpdates;  /// queued updates dropped, as a later one covered them
+    uint32_t                                        copyCommands;       /// vkCmdCopyBufferToImage recorded for the queued updates
+    uint32_t                                        copyRegions;        /// regions of these copies
+    VkDeviceSize                                    copyBytes;          /// data staged for these copies
+} uploadStats_t;
 
 class CommandBufferManager {
 private:
 
     typedef struct State {
-        std::vector<VkCommandBuffer>         commandBuffer;
-        std::vector<cmdBufferState_t>        commandBufferState;
-        std::vector<Fence>                   fence;
+        std::vector<VkCommandBuffer>                commandBuffer;
+        std::vector<cmdBufferState_t>               commandBufferState;
+        std::vector<Fence>                          fence;
+        std::vector<uint64_t>                       serial;
+        std::vector<std::vector<resource_t> >       retiredResources;
+        std::vector<CommandBufferPool>              secondaryCmdBufferPool;
+        std::vector<VkCommandBuffer>                uploadCommandBuffer;
+        std::vector<cmdBufferState_t>               uploadCommandBufferState;
 
         State()  { FUN_ENTRY(GL_LOG_TRACE); }
         ~State() { FUN_ENTRY(GL_LOG_TRACE); }
@@ -85,16 +80,37 @@ private:
 
     uint32_t                        mActiveCmdBuffer;
     int32_t                         mLastSubmittedBuffer;
+    uint64_t                        mSubmittedSerial;
+    uint64_t                        mCompletedSerial;
+    std::mutex                      mSerialMutex;       /// guards the slot serials and fence resets against WaitSerial
+    bool                            mInlineRecording;
+    bool                            mRenderPassActive;
 
     State                           mVkCommandBuffers;
 
     VkCommandBuffer                 mVkAuxCommandBuffer;
     VkFence                         mVkAuxFence;
-    CommandBufferPool               mSecondaryCmdBufferPool;
 
-    std::vector<resourceBase_t *>   mReferencedResources;
+    StagingRing                     mStagingRing;
+    StagingRing                     mStreamingRing;
+    StagingRing                     mUniformRing;
+
+    PipelineBarrier                 mDrawBarrier;
+    PipelineBarrier                 mUploadBarrier;
+
+    ResourceTable                   mReferencedResources;
+
+    BindState                       mBindState;
 
-    void FreeResources(void);
+    uploadStats_t                   mUploadStats;
+    bool                            mPrintUploadStats;
+
+    void DestroyResource(const resource_t &resource);
+    void RetireResource(const resource_t &resource);
+    void FreeResources(uint32_t slot);
+    bool WaitSlot(uint32_t slot);
+    bool FlushVkUploadCommandBuffer(void);
+    bool EndVkUploadCommandBuffer(void);
 
 public:
 // Constructor
@@ -109,6 +125,9 @@ public:
 // Allocate Functions
     bool AllocateVkCmdPool(void);
     bool AllocateVkCmdBuffers(void);
+    bool AllocateStagingMemory(VkDeviceSize size, VkDeviceSize alignment, const void *data, VkBuffer *buffer, VkDeviceSize *offset);
+    bool AllocateStreamingMemory(VkDeviceSize size, VkDeviceSize alignment, const void *data, VkBuffer *buffer, VkDeviceSize *offset);
+    bool AllocateUniformMemory(VkDeviceSize size, const void *data, VkBuffer *buffer, VkDeviceSize *offset);
 
 // Destroy Functions
     void DestroyVkCmdBuffers(void);
@@ -118,11 +137,14 @@ public:
     bool BeginVkAuxCommandBuffer(void);
     bool BeginVkDrawCommandBuffer(void);
     bool BeginVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuffer, VkRenderPass renderPass, VkFramebuffer framebuffer);
+    VkCommandBuffer *BeginVkDrawRecording(VkRenderPass renderPass, VkFramebuffer framebuffer);
+    VkCommandBuffer *BeginVkUploadCommandBuffer(void);
 
 // End Functions
     bool EndVkAuxCommandBuffer(void);
     void EndVkDrawCommandBuffer(void);
     void EndVkSecondaryCommandBuffer(const VkCommandBuffer *cmdBuffer);
+    void EndVkDrawRecording(const VkCommandBuffer *cmdBuffer);
 
 // Submit Functions
     bool SubmitVkDrawCommandBuffer(void);
@@ -132,9 +154,33 @@ public:
     bool WaitLastSubmition(void);
     bool WaitVkAuxCommandBuffer(void);
 
+// Update Functions
+    bool UpdateCompletedSerial(void);
+
+// Fence Functions
+    uint64_t GetFenceSerial(void) const;
+    bool WaitSerial(uint64_t serial, uint64_t timeout);
+
+// Stats Functions
+    void PrintUploadStats(void) const;
+
+// Barrier Functions
+    PipelineBarrier *GetPendingBarrier(cmdStream_t stream);
+    void FlushDrawBarrier(void);
+
+// Set Functions
+    inline void            SetRenderPassActive(bool active)                     { FUN_ENTRY(GL_LOG_TRACE); mRenderPassActive = active; }
+
 // Get Functions
     inline VkCommandBuffer GetActiveCommandBuffer(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mVkCommandBuffers.commandBuffer[mActiveCmdBuffer]; }
     inline VkCommandBuffer GetAuxCommandBuffer(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mVkAuxCommandBuffer; }
+    inline uint64_t        GetActiveSerial(void)                          const { FUN_ENTRY(GL_LOG_TRACE); return mSubmittedSerial + 1; }
+    inline uint64_t        GetCompletedSerial(void)                       const { FUN_ENTRY(GL_LOG_TRACE); return mCompletedSerial; }
+    inline BindState      *GetBindState(void)                                   { FUN_ENTRY(GL_LOG_TRACE); return &mBindState; }
+    inline uploadStats_t  *GetUploadStats(void)                                 { FUN_ENTRY(GL_LOG_TRACE); return &mUploadStats; }
+
+// Is Functions
+    inline bool            IsInlineRecording(void)                        const { FUN_ENTRY(GL_LOG_TRACE); return mInlineRecording; }
 
 // Resource Functions
     template<typename T>
@@ -142,12 +188,7 @@ public:
     {
         FUN_ENTRY(GL_LOG_TRACE);
 
-        int index = LocateResource(resource);
-        if(index == -1) {
-            mReferencedResources.push_back(new referencedResource_t<T>(resource, type));
-        } else {
-            ++mReferencedResources[index]->mRefCount;
-        }
+        mReferencedResources.Ref((uint64_t)resource, type);
     }
 
     template<typename T>
@@ -155,29 +196,10 @@ public:
     {
         FUN_ENTRY(GL_LOG_TRACE);
 
-        int index = LocateResource(resource);
-        if(index != -1) {
-            assert(mReferencedResources[index]->mRefCount);
-            --mReferencedResources[index]->mRefCount;
-        }
-    }
-
-    template<typename T>
-    int LocateResource(T resource)
-    {
-        FUN_ENTRY(GL_LOG_TRACE);
-
-        assert(resource);
-
-        for(uint32_t i = 0; i < mReferencedResources.size(); ++i) {
-            referencedResource_t<T> *res = (referencedResource_t<T> *)mReferencedResources[i];
-            assert(res);
-            if(res->mResourcePtr == resource) {
-                return i;
-            }
+        resource_t retired;
+        if(mReferencedResources.Unref((uint64_t)resource, &retired)) {
+            RetireResource(retired);
         }
-
-        return -1;
     }
 };
 
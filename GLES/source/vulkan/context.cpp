@@ -28,6 +28,7 @@
  */
 
 #include "context.h"
+#include "deviceAllocator.h"
 #include "memoryAllocator.h"
 #include "cbManager.h"
 
@@ -82,9 +83,14 @@ static const std::vector<const char*> requiredInstanceExtensions = {VK_KHR_SURFA
 
 #endif //ENABLE_VK_DEBUG_REPORTER
 
+static const std::vector<const char*> usefulInstanceExtensions   = {VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME};
+
 static const std::vector<const char*> requiredDeviceExtensions   = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
 static const std::vector<const char*> usefulDeviceExtensions     = {VK_KHR_MAINTENANCE1_EXTENSION_NAME,
+#ifdef VK_EXT_memory_budget
+                                                                    VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+#endif
                                                                     VK_IMG_FORMAT_PVRTC_EXTENSION_NAME};
 
 static const std::vector<const char*> validationLayerNames       = {"VK_LAYER_LUNARG_standard_validation"};
@@ -196,6 +202,16 @@ CheckVkInstanceExtensions(void)
         }
     }
 
+    std::vector<const char*> usefulExtensionsAvailable;
+    for(uint32_t i = 0; i < extensionCount; ++i) {
+        for(uint32_t j = 0; j < usefulInstanceExtensions.size(); ++j) {
+            if(!strcmp(usefulInstanceExtensions[j], vkExtensionProperties[i].extensionName)) {
+                usefulExtensionsAvailable.push_back(usefulInstanceExtensions[j]);
+                break;
+            }
+        }
+    }
+
     if(vkExtensionProperties) {
         free(vkExtensionProperties);
         vkExtensionProperties = nullptr;
@@ -208,6 +224,8 @@ CheckVkInstanceExtensions(void)
     }
 
     GloveVkContext.enabledInstanceExtensions = requiredInstanceExtensions;
+    GloveVkContext.enabledInstanceExtensions.insert(GloveVkContext.enabledInstanceExtensions.end(),
+                                                    usefulExtensionsAvailable.begin(), usefulExtensionsAvailable.end());
     
     return true;
 }
@@ -248,9 +266,20 @@ CheckVkDeviceExtensions(void)
     }
 
     GetContext()->mIsMaintenanceExtSupported = false;
+    GetContext()->mIsMemoryBudgetExtSupported = false;
     for(uint32_t i = 0; i < extensionCount; ++i) {
         for(uint32_t j = 0; j < usefulDeviceExtensions.size(); ++j) {
             if(!strcmp(usefulDeviceExtensions[j], vkExtensionProperties[i].extensionName)) {
+#ifdef VK_EXT_memory_budget
+                // the budget is queried through VK_KHR_get_physical_device_properties2,
+                // so the extension is of no use and must not be enabled without it
+                if (!strcmp(usefulDeviceExtensions[j], VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+                    if (!InstanceExtensionEnabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
+                        break;
+                    }
+                    GetContext()->mIsMemoryBudgetExtSupported = true;
+                }
+#endif
                 GloveVkContext.enabledDeviceExtensions.push_back(usefulDeviceExtensions[j]);
                 if (!strcmp(usefulDeviceExtensions[j], VK_KHR_MAINTENANCE1_EXTENSION_NAME)) {
                     GetContext()->mIsMaintenanceExtSupported = true;
@@ -343,6 +372,7 @@ EnumerateVkGpus(void)
         return false;
     }
 
+    vkGetPhysicalDeviceProperties(GloveVkContext.vkGpus[0], &GloveVkContext.vkDeviceProperties);
     vkGetPhysicalDeviceMemoryProperties(GloveVkContext.vkGpus[0], &GloveVkContext.vkDeviceMemoryProperties);
 
     return true;
@@ -465,7 +495,8 @@ CreateMemoryAllocator(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    GloveVkContext.memoryAllocator = new MemoryAllocator(GloveVkContext.vkDevice);
+    GloveVkContext.deviceAllocator = new DeviceAllocator(&GloveVkContext);
+    GloveVkContext.memoryAllocator = new MemoryAllocator(GloveVkContext.deviceAllocator);
 }
 
 vkContext_t *
@@ -488,11 +519,15 @@ ResetContextResources()
     GloveVkContext.vkGraphicsQueueNodeIndex     = 0;
     GloveVkContext.vkDevice                     = VK_NULL_HANDLE;
     GloveVkContext.vkSyncItems                  = nullptr;
+    GloveVkContext.deviceAllocator              = nullptr;
     GloveVkContext.memoryAllocator              = nullptr;
     GloveVkContext.mIsMaintenanceExtSupported   = false;
+    GloveVkContext.mIsMemoryBudgetExtSupported  = false;
     GloveVkContext.mInitialized                 = false;
     GloveVkContext.enabledInstanceExtensions.clear();
     GloveVkContext.enabledDeviceExtensions.clear();
+    memset(static_cast<void*>(&GloveVkContext.vkDeviceProperties), 0,
+           sizeof(VkPhysicalDeviceProperties));
     memset(static_cast<void*>(&GloveVkContext.vkDeviceMemoryProperties), 0,
            sizeof(VkPhysicalDeviceMemoryProperties));
 }
@@ -542,6 +577,11 @@ TerminateContext()
         GloveVkContext.memoryAllocator = nullptr;
     }
 
+    if (GloveVkContext.deviceAllocator != nullptr) {
+        delete GloveVkContext.deviceAllocator;
+        GloveVkContext.deviceAllocator = nullptr;
+    }
+
     if(GloveVkContext.vkSyncItems->vkAcquireSemaphore != VK_NULL_HANDLE) {
         vkDestroySemaphore(GloveVkContext.vkDevice, GloveVkContext.vkSyncItems->vkAcquireSemaphore, nullptr);
         GloveVkContext.vkSyncItems->vkAcquireSemaphore = VK_NULL_HANDLE;
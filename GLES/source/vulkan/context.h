@@ -41,6 +41,7 @@
 
 namespace vulkanAPI {
 
+    class DeviceAllocator;
     class MemoryAllocator;
 
     typedef struct vkContext_t {
@@ -51,10 +52,14 @@ namespace vulkanAPI {
             vkGraphicsQueueNodeIndex    = 0;
             vkDevice                    = VK_NULL_HANDLE;
             vkSyncItems                 = nullptr;
+            deviceAllocator             = nullptr;
             memoryAllocator             = nullptr;
             mIsMaintenanceExtSupported  = false;
+            mIsMemoryBudgetExtSupported = false;
             mInitialized                = false;
             
+            memset(static_cast<void*>(&vkDeviceProperties), 0,
+                   sizeof(VkPhysicalDeviceProperties));
             memset(static_cast<void*>(&vkDeviceMemoryProperties), 0,
                    sizeof(VkPhysicalDeviceMemoryProperties));
             memset(static_cast<void*>(&vkDeviceFeatures), 0,
@@ -69,13 +74,16 @@ namespace vulkanAPI {
         VkQueue                                             vkQueue;
         uint32_t                                            vkGraphicsQueueNodeIndex;
         VkDevice                                            vkDevice;
+        VkPhysicalDeviceProperties                          vkDeviceProperties;
         VkPhysicalDeviceMemoryProperties                    vkDeviceMemoryProperties;
         VkPhysicalDeviceFeatures                            vkDeviceFeatures;
         vkSyncItems_t                                       *vkSyncItems;
         std::vector<const char*>                            enabledInstanceExtensions;
         std::vector<const char*>                            enabledDeviceExtensions;
+        DeviceAllocator                                     *deviceAllocator;
         MemoryAllocator                                     *memoryAllocator;
         bool                                                mIsMaintenanceExtSupported;
+        bool                                                mIsMemoryBudgetExtSupported;
         bool                                                mInitialized;
     } vkContext_t;
 
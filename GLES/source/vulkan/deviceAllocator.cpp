@@ -0,0 +1,798 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       deviceAllocator.cpp
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Sub-allocation of device memory from large per memory type heaps
+ *
+ *  @section
+ *
+ *  Drivers limit the number of live device memory allocations and each
+ *  vkAllocateMemory call is expensive, so buffers and images are not given
+ *  memory objects of their own. Instead, large heaps are allocated per memory
+ *  type and are split with a two level segregated fit (TLSF) allocator, which
+ *  finds and frees ranges in constant time and merges adjacent free ranges.
+ *  Linear (buffer) and optimal (image) resources are kept in separate pools,
+ *  so that they never share a bufferImageGranularity page. Requests larger
+ *  than half a heap get a dedicated memory object, released with them.
+ *
+ *  Host visible heaps are mapped once, when they are created, and stay
+ *  mapped for their whole lifetime. Writes to non-coherent memory record the
+ *  range they touched, and the ranges are merged and flushed at once before
+ *  the next queue submission.
+ *
+ *  Memory is accounted per memory heap and per category of resource. Heaps
+ *  are only created within the budget of their memory heap, which is a share
+ *  of its size, optionally capped through the GLOVE_MEMORY_BUDGET_MB
+ *  environment variable and narrowed by VK_EXT_memory_budget, when present.
+ *  When an allocation does not fit, the memory of deleted resources still
+ *  waiting for the GPU and the empty chunks and heaps kept for reuse are
+ *  released, before the allocation is given up. Setting GLOVE_MEMORY_STATS
+ *  logs the statistics on failed allocations and at exit, in trace builds.
+ *
+ */
+
+#include "deviceAllocator.h"
+#include "memoryAllocator.h"
+#include "utils/cacheManager.h"
+#include <algorithm>
+#include <cstdlib>
+
+#define GLOVE_DEVICE_ALLOCATOR_HEAP_SIZE        (32 * 1024 * 1024)
+#define GLOVE_DEVICE_ALLOCATOR_GRANULARITY      256
+#define GLOVE_DEVICE_MEMORY_BUDGET_PERCENT      90
+
+static const char *deviceMemoryCategoryNames[vulkanAPI::DEVICE_MEMORY_CATEGORY_COUNT] = {"textures", "vertex/index", "uniforms", "staging", "transient"};
+
+namespace vulkanAPI {
+
+static inline VkDeviceSize
+AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline uint32_t
+FindLastSet(uint64_t value)
+{
+    uint32_t bit = 0;
+    for(uint32_t shift = 32; shift; shift >>= 1) {
+        if(value >> shift) {
+            value >>= shift;
+            bit    += shift;
+        }
+    }
+    return bit;
+}
+
+static inline uint32_t
+FindFirstSet(uint64_t value)
+{
+    return FindLastSet(value & (~value + 1));
+}
+
+DeviceAllocator::DeviceAllocator(const vkContext_t *vkContext)
+: mVkContext(vkContext), mVkAllocationCount(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mNonCoherentAtomSize = mVkContext->vkDeviceProperties.limits.nonCoherentAtomSize;
+    if(!mNonCoherentAtomSize) {
+        mNonCoherentAtomSize = 1;
+    }
+
+    const VkPhysicalDeviceMemoryProperties &properties = mVkContext->vkDeviceMemoryProperties;
+
+    // keep heaps small enough to not exhaust small memory heaps with slack
+    for(uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+        VkDeviceSize size = properties.memoryHeaps[properties.memoryTypes[i].heapIndex].size / 8;
+        if(size > GLOVE_DEVICE_ALLOCATOR_HEAP_SIZE || size < GLOVE_DEVICE_ALLOCATOR_GRANULARITY) {
+            size = GLOVE_DEVICE_ALLOCATOR_HEAP_SIZE;
+        }
+        mHeapSizes[i] = size & ~static_cast<VkDeviceSize>(GLOVE_DEVICE_ALLOCATOR_GRANULARITY - 1);
+    }
+
+    mPools.resize(2 * properties.memoryTypeCount);
+    for(uint32_t i = 0; i < mPools.size(); ++i) {
+        mPools[i].memoryTypeIndex = i / 2;
+    }
+
+    memset(static_cast<void *>(&mStats), 0, sizeof(mStats));
+    mStats.heapCount = properties.memoryHeapCount;
+
+    // leave some room for the driver and the window system
+    const char  *budget = getenv("GLOVE_MEMORY_BUDGET_MB");
+    VkDeviceSize limit  = budget ? static_cast<VkDeviceSize>(strtoull(budget, nullptr, 10)) << 20 : 0;
+    for(uint32_t i = 0; i < properties.memoryHeapCount; ++i) {
+        mHeapLimits[i] = properties.memoryHeaps[i].size / 100 * GLOVE_DEVICE_MEMORY_BUDGET_PERCENT;
+        if(limit && limit < mHeapLimits[i]) {
+            mHeapLimits[i] = limit;
+        }
+    }
+#ifdef VK_EXT_memory_budget
+    mVkGetPhysicalDeviceMemoryProperties2 = nullptr;
+    if(mVkContext->mIsMemoryBudgetExtSupported) {
+        mVkGetPhysicalDeviceMemoryProperties2 = (PFN_vkGetPhysicalDeviceMemoryProperties2KHR)
+            vkGetInstanceProcAddr(mVkContext->vkInstance, "vkGetPhysicalDeviceMemoryProperties2KHR");
+    }
+#endif
+    UpdateBudget();
+
+    mPrintStats = getenv("GLOVE_MEMORY_STATS") != nullptr;
+}
+
+DeviceAllocator::~DeviceAllocator()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(mPrintStats) {
+        PrintStats();
+    }
+
+    for(auto &pool : mPools) {
+        for(auto heap : pool.heaps) {
+            DestroyHeap(heap);
+        }
+        pool.heaps.clear();
+    }
+}
+
+void
+DeviceAllocator::Mapping(VkDeviceSize size, uint32_t *fl, uint32_t *sl) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const uint64_t units = size / GLOVE_DEVICE_ALLOCATOR_GRANULARITY;
+
+    if(units < SL_COUNT) {
+        *fl = 0;
+        *sl = static_cast<uint32_t>(units);
+    } else {
+        const uint32_t last = FindLastSet(units);
+        *fl = last - SL_LOG2 + 1;
+        *sl = static_cast<uint32_t>(units >> (last - SL_LOG2)) ^ SL_COUNT;
+    }
+
+    assert(*fl < FL_COUNT);
+}
+
+void
+DeviceAllocator::InsertFreeRange(Heap *heap, Range *range)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint32_t fl, sl;
+    Mapping(range->size, &fl, &sl);
+
+    range->isFree   = true;
+    range->prevFree = nullptr;
+    range->nextFree = heap->freeLists[fl][sl];
+    if(range->nextFree) {
+        range->nextFree->prevFree = range;
+    }
+    heap->freeLists[fl][sl] = range;
+
+    heap->flBitmap    |= 1ULL << fl;
+    heap->slBitmap[fl] |= 1U << sl;
+}
+
+void
+DeviceAllocator::RemoveFreeRange(Heap *heap, Range *range)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    uint32_t fl, sl;
+    Mapping(range->size, &fl, &sl);
+
+    if(range->prevFree) {
+        range->prevFree->nextFree = range->nextFree;
+    } else {
+        heap->freeLists[fl][sl] = range->nextFree;
+    }
+    if(range->nextFree) {
+        range->nextFree->prevFree = range->prevFree;
+    }
+
+    if(!heap->freeLists[fl][sl]) {
+        heap->slBitmap[fl] &= ~(1U << sl);
+        if(!heap->slBitmap[fl]) {
+            heap->flBitmap &= ~(1ULL << fl);
+        }
+    }
+
+    range->isFree   = false;
+    range->prevFree = nullptr;
+    range->nextFree = nullptr;
+}
+
+DeviceAllocator::Range *
+DeviceAllocator::FindFreeRange(Heap *heap, VkDeviceSize size) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // round up to the next list, so that any range found is large enough
+    uint64_t units = size / GLOVE_DEVICE_ALLOCATOR_GRANULARITY;
+    if(units >= SL_COUNT) {
+        units += (1ULL << (FindLastSet(units) - SL_LOG2)) - 1;
+    }
+
+    uint32_t fl, sl;
+    Mapping(units * GLOVE_DEVICE_ALLOCATOR_GRANULARITY, &fl, &sl);
+
+    uint32_t slMap = heap->slBitmap[fl] & (~0U << sl);
+    if(!slMap) {
+        const uint64_t flMap = (fl + 1 < FL_COUNT) ? heap->flBitmap & (~0ULL << (fl + 1)) : 0;
+        if(!flMap) {
+            return nullptr;
+        }
+        fl    = FindFirstSet(flMap);
+        slMap = heap->slBitmap[fl];
+    }
+    sl = FindFirstSet(slMap);
+
+    return heap->freeLists[fl][sl];
+}
+
+DeviceAllocator::Heap *
+DeviceAllocator::CreateHeap(uint32_t poolIndex, VkDeviceSize size, bool dedicated)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const uint32_t memoryTypeIndex = mPools[poolIndex].memoryTypeIndex;
+    const uint32_t heapIndex       = mVkContext->vkDeviceMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+
+    UpdateBudget();
+    if(!IsWithinBudget(heapIndex, size)) {
+        GLOVE_PRINT(GL_LOG_DEBUG, "Device memory heap of %llu bytes exceeds the budget of memory heap %u\n",
+                    static_cast<unsigned long long>(size), heapIndex);
+        return nullptr;
+    }
+
+    VkMemoryAllocateInfo allocInfo;
+    allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.pNext           = nullptr;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+    allocInfo.allocationSize  = size;
+
+    // running out of memory is not fatal, the caller releases memory and retries
+    VkDeviceMemory vkMemory = VK_NULL_HANDLE;
+    VkResult err = vkAllocateMemory(mVkContext->vkDevice, &allocInfo, nullptr, &vkMemory);
+    if(err != VK_SUCCESS) {
+        return nullptr;
+    }
+
+    Heap *heap = new Heap;
+    memset(static_cast<void *>(heap), 0, sizeof(Heap));
+    heap->vkMemory  = vkMemory;
+    heap->size      = size;
+    heap->poolIndex = poolIndex;
+    heap->heapIndex = heapIndex;
+    heap->dedicated = dedicated;
+
+    const VkMemoryPropertyFlags flags = mVkContext->vkDeviceMemoryProperties.memoryTypes[allocInfo.memoryTypeIndex].propertyFlags;
+    heap->coherent = (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+    if(flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        err = vkMapMemory(mVkContext->vkDevice, vkMemory, 0, VK_WHOLE_SIZE, 0, &heap->mappedData);
+        assert(!err);
+
+        if(err != VK_SUCCESS) {
+            vkFreeMemory(mVkContext->vkDevice, vkMemory, nullptr);
+            delete heap;
+            return nullptr;
+        }
+    }
+
+    Range *range = new Range;
+    range->vkMemory     = vkMemory;
+    range->offset       = 0;
+    range->size         = size;
+    range->heap         = heap;
+    range->prevPhysical = nullptr;
+    range->nextPhysical = nullptr;
+    heap->ranges        = range;
+    InsertFreeRange(heap, range);
+
+    mPools[poolIndex].heaps.push_back(heap);
+    ++mVkAllocationCount;
+    mStats.heapAllocated[heapIndex] += size;
+
+    GLOVE_PRINT(GL_LOG_DEBUG, "Device memory heap of %llu bytes for memory type %u (%u live allocations)\n",
+                static_cast<unsigned long long>(size), allocInfo.memoryTypeIndex, mVkAllocationCount);
+
+    return heap;
+}
+
+void
+DeviceAllocator::DestroyHeap(Heap *heap)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Range *range = heap->ranges;
+    while(range) {
+        Range *next = range->nextPhysical;
+        delete range;
+        range = next;
+    }
+
+    // writes to memory that is about to be freed need not reach the device
+    for(auto it = mPendingFlushes.begin(); it != mPendingFlushes.end();) {
+        it = (it->memory == heap->vkMemory) ? mPendingFlushes.erase(it) : it + 1;
+    }
+
+    // freeing the memory object also unmaps it
+    vkFreeMemory(mVkContext->vkDevice, heap->vkMemory, nullptr);
+    --mVkAllocationCount;
+    mStats.heapAllocated[heap->heapIndex] -= heap->size;
+
+    delete heap;
+}
+
+DeviceAllocator::Range *
+DeviceAllocator::AllocateFromHeap(Heap *heap, VkDeviceSize size, VkDeviceSize alignment)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // ranges always start at the granularity, so larger alignments may need padding
+    Range *range = FindFreeRange(heap, size + alignment - GLOVE_DEVICE_ALLOCATOR_GRANULARITY);
+    if(!range) {
+        return nullptr;
+    }
+    RemoveFreeRange(heap, range);
+
+    const VkDeviceSize padding = AlignUp(range->offset, alignment) - range->offset;
+    if(padding) {
+        Range *front = new Range;
+        front->vkMemory     = range->vkMemory;
+        front->offset       = range->offset;
+        front->size         = padding;
+        front->heap         = heap;
+        front->prevPhysical = range->prevPhysical;
+        front->nextPhysical = range;
+        if(front->prevPhysical) {
+            front->prevPhysical->nextPhysical = front;
+        } else {
+            heap->ranges = front;
+        }
+        range->prevPhysical = front;
+        range->offset      += padding;
+        range->size        -= padding;
+        InsertFreeRange(heap, front);
+    }
+
+    if(range->size > size) {
+        Range *back = new Range;
+        back->vkMemory     = range->vkMemory;
+        back->offset       = range->offset + size;
+        back->size         = range->size - size;
+        back->heap         = heap;
+        back->prevPhysical = range;
+        back->nextPhysical = range->nextPhysical;
+        if(back->nextPhysical) {
+            back->nextPhysical->prevPhysical = back;
+        }
+        range->nextPhysical = back;
+        range->size         = size;
+        InsertFreeRange(heap, back);
+    }
+
+    ++heap->allocationCount;
+
+    return range;
+}
+
+DeviceAllocation *
+DeviceAllocator::AllocateRange(const VkMemoryRequirements *requirements, uint32_t memoryTypeIndex, bool linear)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const VkDeviceSize size      = AlignUp(requirements->size ? requirements->size : 1, GLOVE_DEVICE_ALLOCATOR_GRANULARITY);
+    const VkDeviceSize alignment = requirements->alignment > GLOVE_DEVICE_ALLOCATOR_GRANULARITY ?
+                                   requirements->alignment : GLOVE_DEVICE_ALLOCATOR_GRANULARITY;
+    const uint32_t     poolIndex = 2 * memoryTypeIndex + (linear ? 0 : 1);
+    const VkDeviceSize heapSize  = mHeapSizes[memoryTypeIndex];
+
+    if(size + alignment > heapSize / 2) {
+        Heap *heap = CreateHeap(poolIndex, size, true);
+        if(!heap) {
+            return nullptr;
+        }
+
+        // memory objects are aligned for any resource, so take the whole heap
+        RemoveFreeRange(heap, heap->ranges);
+        heap->allocationCount = 1;
+        return heap->ranges;
+    }
+
+    Pool &pool = mPools[poolIndex];
+    for(auto heap : pool.heaps) {
+        if(!heap->dedicated) {
+            Range *range = AllocateFromHeap(heap, size, alignment);
+            if(range) {
+                return range;
+            }
+        }
+    }
+
+    Heap *heap = CreateHeap(poolIndex, heapSize, false);
+    return heap ? AllocateFromHeap(heap, size, alignment) : nullptr;
+}
+
+DeviceAllocation *
+DeviceAllocator::Allocate(const VkMemoryRequirements *requirements, uint32_t memoryTypeIndex, bool linear, deviceMemoryCategory_t category, CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    assert(memoryTypeIndex < mVkContext->vkDeviceMemoryProperties.memoryTypeCount);
+    assert(!(requirements->alignment & (requirements->alignment - 1)));
+    assert(category < DEVICE_MEMORY_CATEGORY_COUNT);
+
+    DeviceAllocation *allocation = AllocateRange(requirements, memoryTypeIndex, linear);
+
+    // over budget or out of memory, give back what is no longer needed and retry
+    if(!allocation && ReleaseMemory(cacheManager)) {
+        allocation = AllocateRange(requirements, memoryTypeIndex, linear);
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if(!allocation) {
+        ++mStats.failedAllocationCount;
+        lock.unlock();
+
+        GLOVE_PRINT_ERR("Failed to allocate %llu bytes of %s device memory\n",
+                        static_cast<unsigned long long>(requirements->size), deviceMemoryCategoryNames[category]);
+        if(mPrintStats) {
+            PrintStats();
+        }
+        return nullptr;
+    }
+
+    const uint32_t heapIndex = static_cast<Range *>(allocation)->heap->heapIndex;
+    allocation->category = category;
+    mStats.heapUsed[heapIndex]      += allocation->size;
+    mStats.categoryUsed[category]   += allocation->size;
+    ++mStats.categoryCount[category];
+
+    return allocation;
+}
+
+void
+DeviceAllocator::Free(DeviceAllocation *allocation)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!allocation) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    Range *range = static_cast<Range *>(allocation);
+    Heap  *heap  = range->heap;
+    assert(!range->isFree && heap->allocationCount);
+
+    mStats.heapUsed[heap->heapIndex]          -= range->size;
+    mStats.categoryUsed[range->category]      -= range->size;
+    --mStats.categoryCount[range->category];
+
+    Range *prev = range->prevPhysical;
+    if(prev && prev->isFree) {
+        RemoveFreeRange(heap, prev);
+        prev->size        += range->size;
+        prev->nextPhysical = range->nextPhysical;
+        if(prev->nextPhysical) {
+            prev->nextPhysical->prevPhysical = prev;
+        }
+        delete range;
+        range = prev;
+    }
+
+    Range *next = range->nextPhysical;
+    if(next && next->isFree) {
+        RemoveFreeRange(heap, next);
+        range->size        += next->size;
+        range->nextPhysical = next->nextPhysical;
+        if(range->nextPhysical) {
+            range->nextPhysical->prevPhysical = range;
+        }
+        delete next;
+    }
+
+    InsertFreeRange(heap, range);
+
+    if(--heap->allocationCount) {
+        return;
+    }
+
+    // keep one empty shared heap per pool around, to not thrash on allocate/free
+    // cycles. Dedicated heaps do not count, as they serve a single allocation only
+    std::vector<Heap *> &heaps = mPools[heap->poolIndex].heaps;
+    uint32_t sharedHeaps = 0;
+    for(auto poolHeap : heaps) {
+        if(!poolHeap->dedicated) {
+            ++sharedHeaps;
+        }
+    }
+
+    if(heap->dedicated || sharedHeaps > 1) {
+        for(auto it = heaps.begin(); it != heaps.end(); ++it) {
+            if(*it == heap) {
+                heaps.erase(it);
+                break;
+            }
+        }
+        DestroyHeap(heap);
+    }
+}
+
+void
+DeviceAllocator::UpdateBudget(void)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    for(uint32_t i = 0; i < mStats.heapCount; ++i) {
+        mStats.heapBudget[i] = mHeapLimits[i];
+    }
+
+#ifdef VK_EXT_memory_budget
+    if(!mVkGetPhysicalDeviceMemoryProperties2) {
+        return;
+    }
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties;
+    memset(static_cast<void *>(&budgetProperties), 0, sizeof(budgetProperties));
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2KHR properties;
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR;
+    properties.pNext = &budgetProperties;
+    mVkGetPhysicalDeviceMemoryProperties2(mVkContext->vkGpus[0], &properties);
+
+    // the usage reported covers the whole process, so what is not ours is taken off the budget
+    for(uint32_t i = 0; i < mStats.heapCount; ++i) {
+        const VkDeviceSize others = budgetProperties.heapUsage[i] > mStats.heapAllocated[i] ?
+                                    budgetProperties.heapUsage[i] - mStats.heapAllocated[i] : 0;
+        const VkDeviceSize budget = budgetProperties.heapBudget[i] > others ? budgetProperties.heapBudget[i] - others : 0;
+        if(budgetProperties.heapBudget[i] && budget < mStats.heapBudget[i]) {
+            mStats.heapBudget[i] = budget;
+        }
+    }
+#endif
+}
+
+bool
+DeviceAllocator::IsWithinBudget(uint32_t heapIndex, VkDeviceSize size) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return mStats.heapAllocated[heapIndex] + size <= mStats.heapBudget[heapIndex];
+}
+
+bool
+DeviceAllocator::ReleaseMemory(CacheManager *cacheManager)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    bool released = false;
+
+    // deleted resources keep their memory until the GPU is done with them. Only
+    // the caller's own context is waited on, as the others may be recording
+    // on other threads
+    if(cacheManager && cacheManager->ReleaseMemory()) {
+        released = true;
+    }
+
+    if(mVkContext->memoryAllocator && mVkContext->memoryAllocator->Trim()) {
+        released = true;
+    }
+
+    if(ReleaseEmptyHeaps()) {
+        released = true;
+    }
+
+    return released;
+}
+
+uint32_t
+DeviceAllocator::ReleaseEmptyHeaps(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    uint32_t released = 0;
+    for(auto &pool : mPools) {
+        for(auto it = pool.heaps.begin(); it != pool.heaps.end();) {
+            if(!(*it)->allocationCount) {
+                DestroyHeap(*it);
+                it = pool.heaps.erase(it);
+                ++released;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    return released;
+}
+
+void
+DeviceAllocator::SetHeapLimit(uint32_t heapIndex, VkDeviceSize limit)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    assert(heapIndex < mStats.heapCount);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mHeapLimits[heapIndex] = limit;
+    UpdateBudget();
+}
+
+void
+DeviceAllocator::GetStats(deviceMemoryStats_t *stats)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    UpdateBudget();
+    *stats                   = mStats;
+    stats->vkAllocationCount = mVkAllocationCount;
+}
+
+void
+DeviceAllocator::PrintStats(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    deviceMemoryStats_t stats;
+    GetStats(&stats);
+
+    GLOVE_PRINT(GL_LOG_DEBUG, "GLOVE device memory: %u memory objects, %u failed allocations\n", stats.vkAllocationCount, stats.failedAllocationCount);
+    for(uint32_t i = 0; i < stats.heapCount; ++i) {
+        GLOVE_PRINT(GL_LOG_DEBUG, "  heap %u: %llu KB used, %llu KB allocated, %llu KB budget\n", i,
+                    static_cast<unsigned long long>(stats.heapUsed[i] >> 10),
+                    static_cast<unsigned long long>(stats.heapAllocated[i] >> 10),
+                    static_cast<unsigned long long>(stats.heapBudget[i] >> 10));
+    }
+    for(uint32_t i = 0; i < DEVICE_MEMORY_CATEGORY_COUNT; ++i) {
+        GLOVE_PRINT(GL_LOG_DEBUG, "  %-12s: %llu KB in %u allocations\n", deviceMemoryCategoryNames[i],
+                    static_cast<unsigned long long>(stats.categoryUsed[i] >> 10), stats.categoryCount[i]);
+    }
+}
+
+void
+DeviceAllocator::GetAlignedRange(const DeviceAllocation *allocation, VkDeviceSize offset, VkDeviceSize size, VkMappedMemoryRange *range) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const Heap *heap = static_cast<const Range *>(allocation)->heap;
+
+    // ranges must be multiples of the atom size, or end at the end of the memory object
+    VkDeviceSize begin = allocation->offset + offset;
+    VkDeviceSize end   = AlignUp(begin + (size ? size : allocation->size - offset), mNonCoherentAtomSize);
+    begin             &= ~(mNonCoherentAtomSize - 1);
+
+    range->sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range->pNext  = nullptr;
+    range->memory = heap->vkMemory;
+    range->offset = begin;
+    range->size   = (end < heap->size ? end : heap->size) - begin;
+}
+
+bool
+DeviceAllocator::GetMappedData(const DeviceAllocation *allocation, VkDeviceSize offset, void **data) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const Heap *heap = static_cast<const Range *>(allocation)->heap;
+    if(!heap->mappedData) {
+        return false;
+    }
+
+    *data = static_cast<uint8_t *>(heap->mappedData) + allocation->offset + offset;
+
+    return true;
+}
+
+void
+DeviceAllocator::Flush(const DeviceAllocation *allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(static_cast<const Range *>(allocation)->heap->coherent) {
+        return;
+    }
+
+    VkMappedMemoryRange range;
+    GetAlignedRange(allocation, offset, size, &range);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // consecutive writes to the same allocation are merged right away
+    if(!mPendingFlushes.empty()) {
+        VkMappedMemoryRange &last = mPendingFlushes.back();
+        if(last.memory == range.memory && range.offset <= last.offset + last.size && last.offset <= range.offset + range.size) {
+            const VkDeviceSize end = std::max(last.offset + last.size, range.offset + range.size);
+            last.offset = std::min(last.offset, range.offset);
+            last.size   = end - last.offset;
+            return;
+        }
+    }
+
+    mPendingFlushes.push_back(range);
+}
+
+bool
+DeviceAllocator::Invalidate(const DeviceAllocation *allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(static_cast<const Range *>(allocation)->heap->coherent) {
+        return true;
+    }
+
+    VkMappedMemoryRange range;
+    GetAlignedRange(allocation, offset, size, &range);
+
+    VkResult err = vkInvalidateMappedMemoryRanges(mVkContext->vkDevice, 1, &range);
+    assert(!err);
+
+    return (err == VK_SUCCESS);
+}
+
+bool
+DeviceAllocator::FlushMappedRanges(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if(mPendingFlushes.empty()) {
+        return true;
+    }
+
+    std::sort(mPendingFlushes.begin(), mPendingFlushes.end(),
+              [](const VkMappedMemoryRange &a, const VkMappedMemoryRange &b) {
+                  return (uint64_t)a.memory != (uint64_t)b.memory ? (uint64_t)a.memory < (uint64_t)b.memory : a.offset < b.offset;
+              });
+
+    // merge overlapping and adjacent ranges of the same memory object
+    size_t count = 0;
+    for(size_t i = 1; i < mPendingFlushes.size(); ++i) {
+        VkMappedMemoryRange &last  = mPendingFlushes[count];
+        const VkMappedMemoryRange &range = mPendingFlushes[i];
+        if(last.memory == range.memory && range.offset <= last.offset + last.size) {
+            last.size = std::max(last.offset + last.size, range.offset + range.size) - last.offset;
+        } else {
+            mPendingFlushes[++count] = range;
+        }
+    }
+    ++count;
+
+    VkResult err = vkFlushMappedMemoryRanges(mVkContext->vkDevice, static_cast<uint32_t>(count), mPendingFlushes.data());
+    assert(!err);
+
+    mPendingFlushes.clear();
+
+    return (err == VK_SUCCESS);
+}
+
+}
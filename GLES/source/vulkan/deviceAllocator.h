@@ -0,0 +1,175 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       deviceAllocator.h
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Sub-allocation of device memory from large per memory type heaps
+ *
+ */
+
+#ifndef __VKDEVICEALLOCATOR_H__
+#define __VKDEVICEALLOCATOR_H__
+
+#include <mutex>
+#include <vector>
+#include "context.h"
+
+class CacheManager;
+
+namespace vulkanAPI {
+
+/// What the memory of an allocation holds, for accounting purposes.
+typedef enum {
+    DEVICE_MEMORY_CATEGORY_TEXTURE = 0,
+    DEVICE_MEMORY_CATEGORY_VERTEX_INDEX,
+    DEVICE_MEMORY_CATEGORY_UNIFORM,
+    DEVICE_MEMORY_CATEGORY_STAGING,
+    DEVICE_MEMORY_CATEGORY_TRANSIENT,
+    DEVICE_MEMORY_CATEGORY_COUNT
+} deviceMemoryCategory_t;
+
+/// Device memory usage. Heap figures are indexed by memory heap.
+/// Allocated memory is the size of the memory objects, used memory the
+/// part of it handed out to resources.
+typedef struct deviceMemoryStats_t {
+    uint32_t                          heapCount;
+    VkDeviceSize                      heapBudget[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize                      heapAllocated[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize                      heapUsed[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize                      categoryUsed[DEVICE_MEMORY_CATEGORY_COUNT];
+    uint32_t                          categoryCount[DEVICE_MEMORY_CATEGORY_COUNT];
+    uint32_t                          vkAllocationCount;
+    uint32_t                          failedAllocationCount;
+} deviceMemoryStats_t;
+
+/// A range of device memory handed out by the DeviceAllocator.
+/// Objects are bound to vkMemory at offset.
+struct DeviceAllocation {
+    VkDeviceMemory                    vkMemory;
+    VkDeviceSize                      offset;
+    VkDeviceSize                      size;
+    deviceMemoryCategory_t            category;
+};
+
+class DeviceAllocator {
+
+private:
+    const static uint32_t             SL_LOG2  = 4;
+    const static uint32_t             SL_COUNT = 1 << SL_LOG2;
+    const static uint32_t             FL_COUNT = 40;
+
+    struct Heap;
+
+    /// Heaps are split into ranges kept in offset order. Free ranges are
+    /// additionally linked in the segregated free list matching their size.
+    struct Range : public DeviceAllocation {
+        Heap *                        heap;
+        Range *                       prevPhysical;
+        Range *                       nextPhysical;
+        Range *                       prevFree;
+        Range *                       nextFree;
+        bool                          isFree;
+    };
+
+    struct Heap {
+        VkDeviceMemory                vkMemory;
+        VkDeviceSize                  size;
+        uint32_t                      poolIndex;
+        uint32_t                      heapIndex;
+        bool                          dedicated;
+        uint32_t                      allocationCount;
+        Range *                       ranges;
+
+        void *                        mappedData;
+        bool                          coherent;
+
+        uint64_t                      flBitmap;
+        uint32_t                      slBitmap[FL_COUNT];
+        Range *                       freeLists[FL_COUNT][SL_COUNT];
+    };
+
+    struct Pool {
+        uint32_t                      memoryTypeIndex;
+        std::vector<Heap *>           heaps;
+    };
+
+    const
+    vkContext_t *                     mVkContext;
+    std::mutex                        mMutex;
+
+    std::vector<Pool>                 mPools;
+    VkDeviceSize                      mHeapSizes[VK_MAX_MEMORY_TYPES];
+    uint32_t                          mVkAllocationCount;
+    VkDeviceSize                      mNonCoherentAtomSize;
+    std::vector<VkMappedMemoryRange>  mPendingFlushes;
+
+    deviceMemoryStats_t               mStats;
+    VkDeviceSize                      mHeapLimits[VK_MAX_MEMORY_HEAPS];
+    bool                              mPrintStats;
+#ifdef VK_EXT_memory_budget
+    PFN_vkGetPhysicalDeviceMemoryProperties2KHR mVkGetPhysicalDeviceMemoryProperties2;
+#endif
+
+    void                              Mapping(VkDeviceSize size, uint32_t *fl, uint32_t *sl)      const;
+    void                              InsertFreeRange(Heap *heap, Range *range);
+    void                              RemoveFreeRange(Heap *heap, Range *range);
+    Range *                           FindFreeRange(Heap *heap, VkDeviceSize size)                const;
+
+    Heap *                            CreateHeap(uint32_t poolIndex, VkDeviceSize size, bool dedicated);
+    void                              DestroyHeap(Heap *heap);
+    Range *                           AllocateFromHeap(Heap *heap, VkDeviceSize size, VkDeviceSize alignment);
+    DeviceAllocation *                AllocateRange(const VkMemoryRequirements *requirements, uint32_t memoryTypeIndex, bool linear);
+
+    void                              UpdateBudget(void);
+    bool                              IsWithinBudget(uint32_t heapIndex, VkDeviceSize size)       const;
+    bool                              ReleaseMemory(CacheManager *cacheManager);
+    uint32_t                          ReleaseEmptyHeaps(void);
+    void                              GetAlignedRange(const DeviceAllocation *allocation, VkDeviceSize offset, VkDeviceSize size, VkMappedMemoryRange *range) const;
+
+public:
+// Constructor
+    DeviceAllocator(const vkContext_t *vkContext);
+
+// Destructor
+    ~DeviceAllocator();
+
+// Allocate Functions
+    DeviceAllocation *                Allocate(const VkMemoryRequirements *requirements, uint32_t memoryTypeIndex, bool linear, deviceMemoryCategory_t category, CacheManager *cacheManager);
+
+// Release Functions
+    void                              Free(DeviceAllocation *allocation);
+
+// Map Functions
+    bool                              GetMappedData(const DeviceAllocation *allocation, VkDeviceSize offset, void **data) const;
+    void                              Flush(const DeviceAllocation *allocation, VkDeviceSize offset, VkDeviceSize size);
+    bool                              Invalidate(const DeviceAllocation *allocation, VkDeviceSize offset, VkDeviceSize size);
+    bool                              FlushMappedRanges(void);
+
+// Stats Functions
+    void                              GetStats(deviceMemoryStats_t *stats);
+    void                              PrintStats(void);
+
+// Get Functions
+    inline uint32_t                   GetVkAllocationCount(void)          const { FUN_ENTRY(GL_LOG_TRACE); return mVkAllocationCount; }
+
+// Set Functions
+    void                              SetHeapLimit(uint32_t heapIndex, VkDeviceSize limit);
+};
+
+}
+
+#endif // __VKDEVICEALLOCATOR_H__
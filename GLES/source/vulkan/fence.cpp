@@ -81,6 +81,32 @@ Fence::Wait(VkBool32 waitAll, uint64_t timeout)
     return true;
 }
 
+bool
+Fence::IsSignaled(void) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    VkResult err = vkGetFenceStatus(mVkContext->vkDevice, mVkFence);
+    assert(err == VK_SUCCESS || err == VK_NOT_READY);
+
+    return (err == VK_SUCCESS);
+}
+
+bool
+Fence::IsSignaled(uint64_t timeout) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(!timeout) {
+        return IsSignaled();
+    }
+
+    VkResult err = vkWaitForFences(mVkContext->vkDevice, 1, &mVkFence, VK_TRUE, timeout);
+    assert(err == VK_SUCCESS || err == VK_TIMEOUT);
+
+    return (err == VK_SUCCESS);
+}
+
 bool
 Fence::Create(bool signaled)
 {
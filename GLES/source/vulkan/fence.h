@@ -56,6 +56,10 @@ public:
 // Wait Functions
     bool                              Wait(VkBool32  waitAll, uint64_t timeout);
 
+// Is Functions
+    bool                              IsSignaled(void) const;
+    bool                              IsSignaled(uint64_t timeout) const;
+
 // Get Functions
     inline VkFence                    GetFence(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mVkFence; }
 
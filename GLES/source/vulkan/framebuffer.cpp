@@ -27,12 +27,14 @@
  */
 
 #include "framebuffer.h"
+#include "utils/cacheManager.h"
 
 namespace vulkanAPI {
 
 Framebuffer::Framebuffer(const vkContext_t *vkContext)
 : mVkContext(vkContext),
-  mVkFramebuffer(VK_NULL_HANDLE)
+  mVkFramebuffer(VK_NULL_HANDLE),
+  mCacheManager(nullptr)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -50,7 +52,12 @@ Framebuffer::Release(void)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     if(mVkFramebuffer != VK_NULL_HANDLE) {
-        vkDestroyFramebuffer(mVkContext->vkDevice, mVkFramebuffer, nullptr);
+        // it may still be referenced by a command buffer that has not completed
+        if(mCacheManager) {
+            mCacheManager->CacheVkFramebuffer(mVkFramebuffer);
+        } else {
+            vkDestroyFramebuffer(mVkContext->vkDevice, mVkFramebuffer, nullptr);
+        }
         mVkFramebuffer = VK_NULL_HANDLE;
     }
 }
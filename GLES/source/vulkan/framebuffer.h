@@ -26,6 +26,8 @@
 
 #include "context.h"
 
+class CacheManager;
+
 namespace vulkanAPI {
 
 class Framebuffer {
@@ -36,6 +38,7 @@ private:
     vkContext_t *           mVkContext;
 
     VkFramebuffer           mVkFramebuffer;
+    CacheManager *          mCacheManager;
 
 public:
 // Constructor
@@ -52,6 +55,9 @@ public:
 
 // Get functions
     inline VkFramebuffer*   GetFramebuffer(void)                                { FUN_ENTRY(GL_LOG_TRACE); return &mVkFramebuffer; }
+
+// Set Functions
+    inline void             SetCacheManager(CacheManager *manager)              { FUN_ENTRY(GL_LOG_TRACE); mCacheManager = manager; }
 };
 
 }
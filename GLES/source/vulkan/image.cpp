@@ -70,6 +70,7 @@ Image::Release(void)
 
         mVkImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         mVkPipelineStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        mSubresourceStates.clear();
     }
 
     mWidth      = 0;
@@ -136,6 +137,7 @@ Image::Create(void)
 
     mDelete = VK_TRUE;
     mLayers = info.arrayLayers;
+    mSubresourceStates.clear();
 
     CreateImageSubresourceRange();
 
@@ -179,7 +181,16 @@ Image::CopyBufferToImage(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkCmdCopyBufferToImage(*activeCmdBuffer, srcBuffer, mVkImage, mVkImageLayout, 1, &mVkBufferImageCopy);
+    const VkImageLayout imageLayout = GetSubresourceLayout(mVkBufferImageCopy.imageSubresource.mipLevel, mVkBufferImageCopy.imageSubresource.baseArrayLayer);
+    vkCmdCopyBufferToImage(*activeCmdBuffer, srcBuffer, mVkImage, imageLayout, 1, &mVkBufferImageCopy);
+}
+
+void
+Image::CopyBufferToImage(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer, VkImageLayout imageLayout, uint32_t regionCount, const VkBufferImageCopy *regions)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    vkCmdCopyBufferToImage(*activeCmdBuffer, srcBuffer, mVkImage, imageLayout, regionCount, regions);
 }
 
 void
@@ -187,7 +198,16 @@ Image::CopyImageToBuffer(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkCmdCopyImageToBuffer(*activeCmdBuffer, mVkImage, mVkImageLayout, srcBuffer, 1, &mVkBufferImageCopy);
+    const VkImageLayout imageLayout = GetSubresourceLayout(mVkBufferImageCopy.imageSubresource.mipLevel, mVkBufferImageCopy.imageSubresource.baseArrayLayer);
+    vkCmdCopyImageToBuffer(*activeCmdBuffer, mVkImage, imageLayout, srcBuffer, 1, &mVkBufferImageCopy);
+}
+
+void
+Image::CopyImage(VkCommandBuffer *activeCmdBuffer, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageCopy *regions)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    vkCmdCopyImage(*activeCmdBuffer, GetImage(), srcImageLayout, dstImage, dstImageLayout, regionCount, regions);
 }
 
 void
@@ -233,13 +253,111 @@ Image::ModifyImageSubresourceRange(uint32_t baseMipLevel, uint32_t levelCount, u
     mVkImageSubresourceRange.layerCount      = layerCount;
 }
 
+VkImageLayout
+Image::GetSubresourceLayout(uint32_t mipLevel, uint32_t arrayLayer) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const uint32_t index = arrayLayer * mMipLevels + mipLevel;
+    if(mSubresourceStates.size() != mMipLevels * mLayers || index >= mSubresourceStates.size()) {
+        return mVkImageLayout;
+    }
+
+    return mSubresourceStates[index].layout;
+}
+
 void
 Image::ModifyImageLayout(VkCommandBuffer *activeCmdBuffer, VkImageLayout newImageLayout)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkImageLayout oldImageLayout = mVkImageLayout;
-    VkPipelineStageFlags srcStages = mVkPipelineStage;
+    PipelineBarrier pipelineBarrier;
+    ModifyImageLayout(&pipelineBarrier, newImageLayout);
+    pipelineBarrier.Flush(activeCmdBuffer);
+}
+
+void
+Image::ModifyImageLayout(PipelineBarrier *pipelineBarrier, VkImageLayout newImageLayout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    // subresources start in the layout the image was created or set with
+    if(mSubresourceStates.size() != mMipLevels * mLayers) {
+        subresourceState_t initialState;
+        initialState.layout = mVkImageLayout;
+        initialState.stage  = mVkPipelineStage;
+        mSubresourceStates.assign(mMipLevels * mLayers, initialState);
+    }
+
+    const VkImageSubresourceRange &range = mVkImageSubresourceRange;
+    const uint32_t lastMipLevel   = std::min(range.baseMipLevel   + range.levelCount, mMipLevels);
+    const uint32_t lastArrayLayer = std::min(range.baseArrayLayer + range.layerCount, mLayers);
+    if(range.baseMipLevel >= lastMipLevel || range.baseArrayLayer >= lastArrayLayer) {
+        return;
+    }
+
+    // the common case is a range in a single state, which needs a single barrier
+    const subresourceState_t baseState = mSubresourceStates[range.baseArrayLayer * mMipLevels + range.baseMipLevel];
+    bool uniformRange = true;
+    for(uint32_t level = range.baseMipLevel; level < lastMipLevel && uniformRange; ++level) {
+        for(uint32_t layer = range.baseArrayLayer; layer < lastArrayLayer; ++layer) {
+            const subresourceState_t &state = mSubresourceStates[layer * mMipLevels + level];
+            if(state.layout != baseState.layout || state.stage != baseState.stage) {
+                uniformRange = false;
+                break;
+            }
+        }
+    }
+
+    VkPipelineStageFlags destStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    if(uniformRange) {
+        if(baseState.layout == newImageLayout) {
+            return;
+        }
+        destStages = AddImageMemoryBarrier(pipelineBarrier, &range, baseState.layout, baseState.stage, newImageLayout);
+    } else {
+        // otherwise a barrier is added for every run of layers of a level in the same state
+        for(uint32_t level = range.baseMipLevel; level < lastMipLevel; ++level) {
+            uint32_t layer = range.baseArrayLayer;
+            while(layer < lastArrayLayer) {
+                const subresourceState_t runState = mSubresourceStates[layer * mMipLevels + level];
+                uint32_t runEnd = layer + 1;
+                while(runEnd < lastArrayLayer &&
+                      mSubresourceStates[runEnd * mMipLevels + level].layout == runState.layout &&
+                      mSubresourceStates[runEnd * mMipLevels + level].stage  == runState.stage) {
+                    ++runEnd;
+                }
+
+                if(runState.layout != newImageLayout) {
+                    VkImageSubresourceRange runRange = range;
+                    runRange.baseMipLevel   = level;
+                    runRange.levelCount     = 1;
+                    runRange.baseArrayLayer = layer;
+                    runRange.layerCount     = runEnd - layer;
+                    destStages = AddImageMemoryBarrier(pipelineBarrier, &runRange, runState.layout, runState.stage, newImageLayout);
+                }
+
+                layer = runEnd;
+            }
+        }
+    }
+
+    for(uint32_t level = range.baseMipLevel; level < lastMipLevel; ++level) {
+        for(uint32_t layer = range.baseArrayLayer; layer < lastArrayLayer; ++layer) {
+            subresourceState_t &state = mSubresourceStates[layer * mMipLevels + level];
+            if(state.layout != newImageLayout) {
+                state.layout = newImageLayout;
+                state.stage  = destStages;
+            }
+        }
+    }
+}
+
+VkPipelineStageFlags
+Image::AddImageMemoryBarrier(PipelineBarrier *pipelineBarrier, const VkImageSubresourceRange *subresourceRange,
+                             VkImageLayout oldImageLayout, VkPipelineStageFlags srcStages, VkImageLayout newImageLayout)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
 
     // Put barrier on top
     VkPipelineStageFlags destStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
@@ -254,7 +372,7 @@ Image::ModifyImageLayout(VkCommandBuffer *activeCmdBuffer, VkImageLayout newImag
     imageMemoryBarrier.srcQueueFamilyIndex  = VK_QUEUE_FAMILY_IGNORED;
     imageMemoryBarrier.dstQueueFamilyIndex  = VK_QUEUE_FAMILY_IGNORED;
     imageMemoryBarrier.image                = mVkImage;
-    imageMemoryBarrier.subresourceRange     = mVkImageSubresourceRange;
+    imageMemoryBarrier.subresourceRange     = *subresourceRange;
 
     // Source layouts (old)
     // Source access mask controls actions that have to be finished on the old layout
@@ -362,10 +480,9 @@ Image::ModifyImageLayout(VkCommandBuffer *activeCmdBuffer, VkImageLayout newImag
         break;
     }
 
-    vkCmdPipelineBarrier(*activeCmdBuffer, srcStages, destStages, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+    pipelineBarrier->AddImageMemoryBarrier(srcStages, destStages, &imageMemoryBarrier);
 
-    mVkImageLayout = newImageLayout;
-    mVkPipelineStage = destStages;
+    return destStages;
 }
 
 VkFormat
@@ -24,8 +24,10 @@
 #ifndef __VKIMAGE_H__
 #define __VKIMAGE_H__
 
+#include <vector>
 #include "utils.h"
 #include "context.h"
+#include "pipelineBarrier.h"
 
 #define TEXTURE_2D_LAYERS         1
 #define TEXTURE_CUBE_MAP_LAYERS   6
@@ -45,6 +47,11 @@ public:
 
 private:
 
+    typedef struct subresourceState_t {
+        VkImageLayout                 layout;
+        VkPipelineStageFlags          stage;
+    } subresourceState_t;
+
     const
     vkContext_t *                     mVkContext;
 
@@ -60,6 +67,7 @@ private:
     VkSampleCountFlagBits             mVkSampleCount;
     VkSharingMode                     mVkSharingMode;
     VkBufferImageCopy                 mVkBufferImageCopy;
+    std::vector<subresourceState_t>   mSubresourceStates;
 
     uint32_t                          mWidth;
     uint32_t                          mHeight;
@@ -71,6 +79,9 @@ private:
 
     CacheManager *                    mCacheManager;
 
+    VkPipelineStageFlags              AddImageMemoryBarrier(PipelineBarrier *pipelineBarrier, const VkImageSubresourceRange *subresourceRange,
+                                                            VkImageLayout oldImageLayout, VkPipelineStageFlags srcStages, VkImageLayout newImageLayout);
+
 public:
 // Constructor
     Image(const vkContext_t *vkContext = nullptr);
@@ -90,11 +101,17 @@ public:
 
 // Copy Functions
     void                              CopyBufferToImage(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer);
+    void                              CopyBufferToImage(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer, VkImageLayout imageLayout,
+                                                        uint32_t regionCount, const VkBufferImageCopy *regions);
     void                              CopyImageToBuffer(VkCommandBuffer *activeCmdBuffer, VkBuffer srcBuffer);
+    void                              CopyImage(        VkCommandBuffer *activeCmdBuffer, VkImageLayout srcImageLayout,
+                                                        VkImage          dstImage,        VkImageLayout dstImageLayout,
+                                                        uint32_t         regionCount,     const VkImageCopy *regions);
 
 // Modify Functions
     void                              ModifyImageSubresourceRange(uint32_t baseMipLevel, uint32_t levelCount, uint32_t baseArrayLayer, uint32_t layerCount);
     void                              ModifyImageLayout(VkCommandBuffer *activeCmdBuffer, VkImageLayout newImageLayout);
+    void                              ModifyImageLayout(PipelineBarrier *pipelineBarrier, VkImageLayout newImageLayout);
 
 // Release Functions
     void                              Release(void);
@@ -104,9 +121,14 @@ public:
     inline VkFormat                   GetFormat(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mVkFormat;         }
     inline VkImageTarget              GetImageTarget(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageTarget;    }
     inline VkImageUsageFlags          GetImageUsage(void)                 const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageUsage;     }
-    inline VkImageLayout              GetImageLayout(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageLayout;    }
+    inline VkImageTiling              GetImageTiling(void)                const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageTiling;    }
+    inline VkImageLayout              GetImageLayout(void)                const { FUN_ENTRY(GL_LOG_TRACE); return GetSubresourceLayout(mVkImageSubresourceRange.baseMipLevel,
+                                                                                                                       mVkImageSubresourceRange.baseArrayLayer); }
+           VkImageLayout              GetSubresourceLayout(uint32_t mipLevel, uint32_t arrayLayer) const;
     inline VkBufferImageCopy *        GetBufferImageCopy(void)                  { FUN_ENTRY(GL_LOG_TRACE); return &mVkBufferImageCopy;      }
     inline VkImageSubresourceRange    GetImageSubresourceRange(void)      const { FUN_ENTRY(GL_LOG_TRACE); return mVkImageSubresourceRange; }
+    inline uint32_t                   GetWidth(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mWidth;            }
+    inline uint32_t                   GetHeight(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mHeight;           }
     inline uint32_t                   GetMipLevels(void)                  const { FUN_ENTRY(GL_LOG_TRACE); return mMipLevels;        }
     inline uint32_t                   GetLayers(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mLayers;           }
 
@@ -120,7 +142,8 @@ public:
            void                       SetImageTiling();
     inline void                       SetImageTiling(VkImageTiling tiling)      { FUN_ENTRY(GL_LOG_TRACE); mVkImageTiling = tiling;    }
     inline void                       SetImageTarget(VkImageTarget target)      { FUN_ENTRY(GL_LOG_TRACE); mVkImageTarget = target;    }
-    inline void                       SetImageLayout(VkImageLayout layout)      { FUN_ENTRY(GL_LOG_TRACE); mVkImageLayout = layout;    }
+    inline void                       SetImageLayout(VkImageLayout layout)      { FUN_ENTRY(GL_LOG_TRACE); mVkImageLayout = layout;
+                                                                                                           mSubresourceStates.clear();  }
     inline void                       SetWidth(uint32_t width)                  { FUN_ENTRY(GL_LOG_TRACE); mWidth         = width;     }
     inline void                       SetHeight(uint32_t height)                { FUN_ENTRY(GL_LOG_TRACE); mHeight        = height;    }
     inline void                       SetMipLevels(uint32_t levels)             { FUN_ENTRY(GL_LOG_TRACE); mMipLevels     = levels;    }
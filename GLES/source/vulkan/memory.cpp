@@ -24,7 +24,9 @@
  *  Device memory is memory that is visible to the device — for example the
  *  contents of the image or buffer objects, which can be natively used by
  *  the device. Memory properties of a physical device describe the memory
- *  heaps and memory types available.
+ *  heaps and memory types available. Memory is sub-allocated from the heaps
+ *  of the DeviceAllocator, so resources are bound at an offset. Host visible
+ *  memory stays mapped, so updates and readbacks are plain copies.
  *
  */
 
@@ -34,7 +36,8 @@
 namespace vulkanAPI {
 
 Memory::Memory(const vkContext_t *vkContext, VkFlags flags)
-: mVkContext(vkContext), mVkMemory (VK_NULL_HANDLE), mVkMemoryFlags(0), mVkFlags(flags), mCacheManager(nullptr)
+: mVkContext(vkContext), mAllocation(nullptr), mVkFlags(flags), mMemoryTypeIndex(0), mLinear(true),
+  mCategory(DEVICE_MEMORY_CATEGORY_TRANSIENT), mCacheManager(nullptr)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 }
@@ -51,19 +54,13 @@ Memory::Create()
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkMemoryAllocateInfo allocInfo;
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.pNext = nullptr;
-    allocInfo.memoryTypeIndex = 0;
-    allocInfo.allocationSize = mVkRequirements.size;
-
-    VkResult err = GetMemoryTypeIndexFromProperties(&allocInfo.memoryTypeIndex);
+    VkResult err = GetMemoryTypeIndexFromProperties(&mMemoryTypeIndex);
     assert(!err);
 
-    err = vkAllocateMemory(mVkContext->vkDevice, &allocInfo, nullptr, &mVkMemory);
-    assert(!err);
+    // the allocator releases what it can under memory pressure, so failing here means out of memory
+    mAllocation = mVkContext->deviceAllocator->Allocate(&mVkRequirements, mMemoryTypeIndex, mLinear, mCategory, mCacheManager);
 
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY && err != VK_ERROR_TOO_MANY_OBJECTS);
+    return (mAllocation != nullptr);
 }
 
 void
@@ -71,13 +68,13 @@ Memory::Release(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    if(mVkMemory != VK_NULL_HANDLE) {
+    if(mAllocation != nullptr) {
         if (mCacheManager) {
-            mCacheManager->CacheDeviceMemory(mVkMemory);
+            mCacheManager->CacheDeviceMemory(mAllocation);
         } else {
-            vkFreeMemory(mVkContext->vkDevice, mVkMemory, nullptr);
+            mVkContext->deviceAllocator->Free(mAllocation);
         }
-        mVkMemory = VK_NULL_HANDLE;
+        mAllocation = nullptr;
     }
 }
 
@@ -87,19 +84,34 @@ Memory::GetData(VkDeviceSize size, VkDeviceSize offset, void *data) const
     FUN_ENTRY(GL_LOG_DEBUG);
 
     void *pData;
-    VkResult err = vkMapMemory(mVkContext->vkDevice, mVkMemory, offset, size, mVkMemoryFlags, &pData);
-    assert(!err);
-
-    if(err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY && err != VK_ERROR_MEMORY_MAP_FAILED)
-    {
+    if(mVkContext->deviceAllocator->GetMappedData(mAllocation, offset, &pData) &&
+       mVkContext->deviceAllocator->Invalidate(mAllocation, offset, size)) {
         memcpy(data, pData, size);
-        vkUnmapMemory(mVkContext->vkDevice, mVkMemory);
 
         return true;
     }
     return false;
 }
 
+bool
+Memory::GetMappedData(VkDeviceSize offset, void **data) const
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return mVkContext->deviceAllocator->GetMappedData(mAllocation, offset, data);
+}
+
+bool
+Memory::IsHostVisible(void) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // the requested properties are a lower bound, e.g., device local memory
+    // of integrated GPUs is also host visible and can be written in place
+    return mAllocation != nullptr &&
+           (mVkContext->vkDeviceMemoryProperties.memoryTypes[mMemoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+}
+
 void
 Memory::UpdateData(VkDeviceSize size, VkDeviceSize offset, const void *data)
 {
@@ -114,9 +126,9 @@ Memory::SetData(VkDeviceSize size, VkDeviceSize offset, const void *data)
     FUN_ENTRY(GL_LOG_DEBUG);
 
     void *pData = nullptr;
-
-    VkResult err = vkMapMemory(mVkContext->vkDevice, mVkMemory, offset, size ? size : mVkRequirements.size, mVkMemoryFlags, &pData);
-    assert(!err);
+    if(!mVkContext->deviceAllocator->GetMappedData(mAllocation, offset, &pData)) {
+        return false;
+    }
 
     if(data) {
         memcpy(pData, data, size);
@@ -124,9 +136,9 @@ Memory::SetData(VkDeviceSize size, VkDeviceSize offset, const void *data)
         memset(pData, 0x0, size);
     }
 
-    vkUnmapMemory(mVkContext->vkDevice, mVkMemory);
+    mVkContext->deviceAllocator->Flush(mAllocation, offset, size);
 
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
+    return true;
 }
 
 bool
@@ -136,17 +148,21 @@ Memory::GetBufferMemoryRequirements(VkBuffer &buffer)
 
     memset(static_cast<void *>(&mVkRequirements), 0, sizeof(mVkRequirements));
     vkGetBufferMemoryRequirements(mVkContext->vkDevice, buffer, &mVkRequirements);
+    mLinear = true;
 
     return true;
 }
 
 void
-Memory::GetImageMemoryRequirements(VkImage &image)
+Memory::GetImageMemoryRequirements(VkImage &image, VkImageTiling tiling)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
     memset(static_cast<void *>(&mVkRequirements), 0, sizeof(mVkRequirements));
     vkGetImageMemoryRequirements(mVkContext->vkDevice, image, &mVkRequirements);
+
+    // linear and optimal resources must not share a bufferImageGranularity page
+    mLinear = (tiling == VK_IMAGE_TILING_LINEAR);
 }
 
 VkResult
@@ -191,7 +207,7 @@ Memory::BindBufferMemory(VkBuffer &buffer)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = vkBindBufferMemory(mVkContext->vkDevice, buffer, mVkMemory, 0);
+    VkResult err = vkBindBufferMemory(mVkContext->vkDevice, buffer, mAllocation->vkMemory, mAllocation->offset);
     assert(!err);
 
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
@@ -202,7 +218,7 @@ Memory::BindImageMemory(VkImage &image)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = vkBindImageMemory(mVkContext->vkDevice, image, mVkMemory, 0);
+    VkResult err = vkBindImageMemory(mVkContext->vkDevice, image, mAllocation->vkMemory, mAllocation->offset);
     assert(!err);
 
     return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
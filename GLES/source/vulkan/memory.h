@@ -26,6 +26,7 @@
 
 #include "utils.h"
 #include "context.h"
+#include "deviceAllocator.h"
 
 class CacheManager;
 
@@ -38,11 +39,12 @@ private:
     const
     vkContext_t *                   mVkContext;
 
-    VkDeviceMemory                  mVkMemory;
-    const
-    VkMemoryMapFlags                mVkMemoryFlags;
+    DeviceAllocation *              mAllocation;
     VkFlags                         mVkFlags;
+    uint32_t                        mMemoryTypeIndex;
     VkMemoryRequirements            mVkRequirements;
+    bool                            mLinear;
+    deviceMemoryCategory_t          mCategory;
 
     CacheManager *                  mCacheManager;
 
@@ -65,15 +67,22 @@ public:
 
 // Get Functions
     inline VkFlags                  GetFlags(void)                            { FUN_ENTRY(GL_LOG_DEBUG); return mVkFlags; }
-    void                            GetImageMemoryRequirements(VkImage &image);
+    inline deviceMemoryCategory_t   GetCategory(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mCategory; }
+    void                            GetImageMemoryRequirements(VkImage &image, VkImageTiling tiling);
     bool                            GetBufferMemoryRequirements(VkBuffer &buffer);
     VkResult                        GetMemoryTypeIndexFromProperties(uint32_t *typeIndex);
     bool                            GetData(VkDeviceSize size, VkDeviceSize offset, void *data) const;
+    bool                            GetMappedData(VkDeviceSize offset, void **data) const;
+
+// Is Functions
+    bool                            IsHostVisible(void)                 const;
 
 // Set/Update Functions
     bool                            SetData(VkDeviceSize size, VkDeviceSize offset, const void *data);
     void                            UpdateData(VkDeviceSize size, VkDeviceSize offset, const void *data);
 
+    inline void                     SetFlags(VkFlags flags)                   { FUN_ENTRY(GL_LOG_TRACE); mVkFlags = flags; }
+    inline void                     SetCategory(deviceMemoryCategory_t category) { FUN_ENTRY(GL_LOG_TRACE); mCategory = category; }
     inline void                     SetContext(const vkContext_t *vkContext)  { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext; }
     inline void                     SetCacheManager(CacheManager *manager)    { FUN_ENTRY(GL_LOG_TRACE); mCacheManager = manager; }
 };
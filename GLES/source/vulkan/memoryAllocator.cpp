@@ -2,10 +2,41 @@
 
 namespace vulkanAPI {
 
-MemoryAllocator::MemoryAllocator(VkDevice vkDevice)
-: mVkDevice(vkDevice)
+static inline uint32_t
+FindLastSet(uint64_t value)
+{
+    uint32_t bit = 0;
+    for(uint32_t shift = 32; shift; shift >>= 1) {
+        if(value >> shift) {
+            value >>= shift;
+            bit    += shift;
+        }
+    }
+    return bit;
+}
+
+static inline uint32_t
+FindFirstSet(uint64_t value)
+{
+    return FindLastSet(value & (~value + 1));
+}
+
+MemoryAllocator::MemoryAllocator(DeviceAllocator *deviceAllocator, ChunkAllocator *chunkAllocator)
+: mDeviceChunkAllocator(deviceAllocator), mChunkAllocator(chunkAllocator ? chunkAllocator : &mDeviceChunkAllocator), mChunkCount(0)
 {
     FUN_ENTRY(GL_LOG_TRACE);
+
+    for(uint32_t i = 0; i < VK_MAX_MEMORY_TYPES * SIZE_CLASS_COUNT; ++i) {
+        Pool &pool = mPools[i];
+        pool.blockSize       = BASE_BLOCK_SIZE << (i % SIZE_CLASS_COUNT);
+        pool.blockCount      = static_cast<uint32_t>(CHUNK_SIZE / pool.blockSize);
+        pool.blockCount      = pool.blockCount < MAX_BLOCK_COUNT ? pool.blockCount : MAX_BLOCK_COUNT;
+        pool.emptyMask       = pool.blockCount == 64 ? ~0ull : (1ull << pool.blockCount) - 1;
+        pool.emptyChunkCount = 0;
+        pool.partialChunks   = nullptr;
+        pool.emptyChunks     = nullptr;
+        pool.fullChunks      = nullptr;
+    }
 }
 
 MemoryAllocator::~MemoryAllocator()
@@ -15,44 +46,99 @@ MemoryAllocator::~MemoryAllocator()
     CleanUp();
 }
 
-MemoryAllocator::Chunk *
-MemoryAllocator::CreateChunk(VkDeviceSize size, uint32_t memoryTypeIndex)
+DeviceAllocation *
+ChunkAllocator::Allocate(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeIndex)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    Chunk *chunk = new Chunk;
+    VkMemoryRequirements requirements;
+    requirements.size           = size;
+    requirements.alignment      = alignment;
+    requirements.memoryTypeBits = 1 << memoryTypeIndex;
 
-    VkMemoryAllocateInfo allocInfo;
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.pNext = nullptr;
-    allocInfo.memoryTypeIndex = memoryTypeIndex;
-    allocInfo.allocationSize = BLOCK_COUNT * size;
+    // the block allocator only serves uniform buffers. It is shared by all
+    // contexts, so none of them is asked to release memory for it
+    return mDeviceAllocator->Allocate(&requirements, memoryTypeIndex, true, DEVICE_MEMORY_CATEGORY_UNIFORM, nullptr);
+}
 
-    VkResult err = vkAllocateMemory(mVkDevice, &allocInfo, nullptr, &(chunk->vkMemory));
-    assert(!err);
+void
+ChunkAllocator::Free(DeviceAllocation *allocation)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
 
-    if (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY && err != VK_ERROR_TOO_MANY_OBJECTS) {
-        for (uint32_t i = 0; i < BLOCK_COUNT; ++i) {
-            chunk->freeBlocks.push(i * size);
-        }
+    mDeviceAllocator->Free(allocation);
+}
+
+void
+MemoryAllocator::LinkChunk(MemoryChunk **list, MemoryChunk *chunk)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    chunk->prev = nullptr;
+    chunk->next = *list;
+    if(*list) {
+        (*list)->prev = chunk;
+    }
+    *list = chunk;
+}
+
+void
+MemoryAllocator::UnlinkChunk(MemoryChunk **list, MemoryChunk *chunk)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    if(chunk->prev) {
+        chunk->prev->next = chunk->next;
     } else {
-        delete chunk;
-        chunk = nullptr;
+        *list = chunk->next;
+    }
+    if(chunk->next) {
+        chunk->next->prev = chunk->prev;
     }
+    chunk->prev = nullptr;
+    chunk->next = nullptr;
+}
+
+MemoryChunk *
+MemoryAllocator::CreateChunk(uint32_t poolIndex, uint32_t memoryTypeIndex)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const Pool &pool = mPools[poolIndex];
+
+    // blocks are aligned to their size, as the chunk is
+    DeviceAllocation *allocation = mChunkAllocator->Allocate(pool.blockCount * pool.blockSize, pool.blockSize, memoryTypeIndex);
+
+    // under memory pressure, give the empty chunks of every pool back and retry
+    if(!allocation && Trim()) {
+        allocation = mChunkAllocator->Allocate(pool.blockCount * pool.blockSize, pool.blockSize, memoryTypeIndex);
+    }
+
+    if(!allocation) {
+        return nullptr;
+    }
+
+    MemoryChunk *chunk = new MemoryChunk;
+    chunk->allocation = allocation;
+    chunk->prev       = nullptr;
+    chunk->next       = nullptr;
+    chunk->freeMask   = pool.emptyMask;
+    chunk->poolIndex  = poolIndex;
+
+    ++mChunkCount;
 
     return chunk;
 }
 
 void
-MemoryAllocator::FillBlock(MemoryBlock &block, MemoryAllocator::Chunk &chunk)
+MemoryAllocator::DestroyChunk(MemoryChunk *chunk)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    VkDeviceSize offset = chunk.freeBlocks.front();
-    chunk.freeBlocks.pop();
+    mChunkAllocator->Free(chunk->allocation);
+    delete chunk;
 
-    block.vkMemory = chunk.vkMemory;
-    block.offset = offset;
+    --mChunkCount;
 }
 
 void
@@ -60,16 +146,38 @@ MemoryAllocator::CleanUp(void)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
-    for (auto chunkListPair : mChunkLists) {
-        ChunkList *chunkList = chunkListPair.second;
-        for (auto chunk : chunkList->chunks) {
-            vkFreeMemory(mVkDevice, chunk->vkMemory, nullptr);
-            delete chunk;
+    // blocks still allocated are released together with their chunks
+    for(uint32_t i = 0; i < VK_MAX_MEMORY_TYPES * SIZE_CLASS_COUNT; ++i) {
+        Pool &pool = mPools[i];
+        for(MemoryChunk **list : {&pool.partialChunks, &pool.emptyChunks, &pool.fullChunks}) {
+            while(*list) {
+                MemoryChunk *chunk = *list;
+                UnlinkChunk(list, chunk);
+                DestroyChunk(chunk);
+            }
+        }
+        pool.emptyChunkCount = 0;
+    }
+}
+
+uint32_t
+MemoryAllocator::Trim(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    uint32_t trimmed = 0;
+    for(uint32_t i = 0; i < VK_MAX_MEMORY_TYPES * SIZE_CLASS_COUNT; ++i) {
+        Pool &pool = mPools[i];
+        while(pool.emptyChunks) {
+            MemoryChunk *chunk = pool.emptyChunks;
+            UnlinkChunk(&pool.emptyChunks, chunk);
+            DestroyChunk(chunk);
+            ++trimmed;
         }
-        chunkList->chunks.clear();
-        delete chunkList;
+        pool.emptyChunkCount = 0;
     }
-    mChunkLists.clear();
+
+    return trimmed;
 }
 
 void
@@ -79,61 +187,83 @@ MemoryAllocator::Allocate(VkDeviceSize size, VkDeviceSize alignment, uint32_t me
 
     // detect alignment is POT
     assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
-    size = (size + (alignment - 1)) & ~(alignment - 1);
+    assert(memoryTypeIndex < VK_MAX_MEMORY_TYPES);
 
-    uint64_t chunkId = (size << 32) + (alignment << 16) + memoryTypeIndex;
+    block = MemoryBlock();
 
-    ChunkList *chunkList = nullptr;
-    std::map<uint64_t, ChunkList *>::iterator it = mChunkLists.find(chunkId);
-    if (it != mChunkLists.end()) {
-        chunkList = it->second;
-    } else {
-        chunkList = new ChunkList;
-        chunkList->size = size;
-        chunkList->alignment = alignment;
-        chunkList->memoryTypeIndex = memoryTypeIndex;
-        mChunkLists[chunkId] = chunkList;
+    // blocks are aligned to their power of two size, so the size class
+    // is the smallest one covering both the size and the alignment
+    VkDeviceSize classSize = size > alignment ? size : alignment;
+    classSize = classSize > BASE_BLOCK_SIZE ? classSize : BASE_BLOCK_SIZE;
+    if(classSize > MAX_BLOCK_SIZE) {
+        return;
     }
+    const uint32_t sizeClass = FindLastSet(classSize - 1) + 1 - BASE_BLOCK_SIZE_LOG2;
+    const uint32_t poolIndex = memoryTypeIndex * SIZE_CLASS_COUNT + sizeClass;
+    Pool &pool = mPools[poolIndex];
 
-    block.chunkId = chunkId;
-    block.vkMemory = VK_NULL_HANDLE;
-    for (auto chunk : chunkList->chunks) {
-        if (chunk->freeBlocks.size() > 0) {
-            FillBlock(block, *chunk);
-            break;
+    MemoryChunk *chunk = pool.partialChunks;
+    if(!chunk) {
+        chunk = pool.emptyChunks;
+        if(chunk) {
+            UnlinkChunk(&pool.emptyChunks, chunk);
+            --pool.emptyChunkCount;
+        } else {
+            chunk = CreateChunk(poolIndex, memoryTypeIndex);
+            if(!chunk) {
+                return;
+            }
         }
+        LinkChunk(&pool.partialChunks, chunk);
     }
 
-    if (block.vkMemory == VK_NULL_HANDLE) {
-        Chunk *chunk = CreateChunk(size, memoryTypeIndex);
-        if (chunk) {
-            chunkList->chunks.push_back(chunk);
-            FillBlock(block, *chunk);
-        }
+    const uint32_t index = FindFirstSet(chunk->freeMask);
+    chunk->freeMask &= ~(1ull << index);
+
+    // full chunks move to their own list until a block of theirs is deallocated
+    if(!chunk->freeMask) {
+        UnlinkChunk(&pool.partialChunks, chunk);
+        LinkChunk(&pool.fullChunks, chunk);
     }
+
+    block.chunk      = chunk;
+    block.index      = index;
+    block.offset     = chunk->allocation->offset + index * pool.blockSize;
+    block.vkMemory   = chunk->allocation->vkMemory;
+    block.allocation = chunk->allocation;
 }
 
 bool
 MemoryAllocator::Deallocate(MemoryBlock &block)
 {
-    if (block.vkMemory == VK_NULL_HANDLE) {
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    MemoryChunk *chunk = block.chunk;
+    if(!chunk || (chunk->freeMask & (1ull << block.index))) {
         return false;
     }
 
-    std::map<uint64_t, ChunkList *>::iterator it = mChunkLists.find(block.chunkId);
-    if (it == mChunkLists.end()) {
-        return false;
+    Pool &pool = mPools[chunk->poolIndex];
+
+    if(!chunk->freeMask) {
+        UnlinkChunk(&pool.fullChunks, chunk);
+        LinkChunk(&pool.partialChunks, chunk);
     }
+    chunk->freeMask |= 1ull << block.index;
+    block = MemoryBlock();
 
-    for (auto chunk : it->second->chunks) {
-        if (chunk->vkMemory == block.vkMemory) {
-            chunk->freeBlocks.push(block.offset);
-            return true;
+    // a few empty chunks are kept around for reuse until trimmed, the rest is released
+    if(chunk->freeMask == pool.emptyMask) {
+        UnlinkChunk(&pool.partialChunks, chunk);
+        if(pool.emptyChunkCount < MAX_EMPTY_CHUNKS) {
+            LinkChunk(&pool.emptyChunks, chunk);
+            ++pool.emptyChunkCount;
+        } else {
+            DestroyChunk(chunk);
         }
     }
 
-    return false;
+    return true;
 }
 
-
 }
@@ -3,60 +3,102 @@
 
 #include "vulkan/vulkan.h"
 #include "utils/glLogger.h"
-#include <queue>
-#include <vector>
-#include <map>
+#include "deviceAllocator.h"
 
 namespace vulkanAPI {
 
+/// A chunk of device memory split into equally sized blocks.
+/// Bit i of freeMask is set while block i is free.
+struct MemoryChunk {
+    DeviceAllocation *              allocation;
+    MemoryChunk *                   prev;
+    MemoryChunk *                   next;
+    uint64_t                        freeMask;
+    uint32_t                        poolIndex;
+};
+
+/// The chunk and index of a block travel with it, so it is freed without any lookup.
 struct MemoryBlock {
-    MemoryBlock():chunkId(0), offset(0), vkMemory(VK_NULL_HANDLE) { }
-    uint64_t                        chunkId;
+    MemoryBlock():chunk(nullptr), index(0), offset(0), vkMemory(VK_NULL_HANDLE), allocation(nullptr) { }
+    MemoryChunk *                   chunk;
+    uint32_t                        index;
     VkDeviceSize                    offset;
     VkDeviceMemory                  vkMemory;
+    DeviceAllocation *              allocation;
+};
+
+/// Allocates the device memory that backs the chunks of a MemoryAllocator
+class ChunkAllocator {
+private:
+    DeviceAllocator *               mDeviceAllocator;
+
+public:
+// Constructor
+    ChunkAllocator(DeviceAllocator *deviceAllocator = nullptr) : mDeviceAllocator(deviceAllocator) { FUN_ENTRY(GL_LOG_TRACE); }
+
+// Destructor
+    virtual ~ChunkAllocator()                                       { FUN_ENTRY(GL_LOG_TRACE); }
+
+// Allocate Functions
+    virtual DeviceAllocation *      Allocate(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeIndex);
+
+// Free Functions
+    virtual void                    Free(DeviceAllocation *allocation);
 };
 
 class MemoryAllocator {
 
 private:
-    struct Chunk {
-        VkDeviceMemory              vkMemory;
-        std::queue<VkDeviceSize>    freeBlocks;
+    /// Chunks with free blocks are kept apart from the empty and the full ones,
+    /// so that allocations fill the former and the empty ones can be trimmed.
+    struct Pool {
+        VkDeviceSize                blockSize;
+        uint32_t                    blockCount;
+        uint64_t                    emptyMask;
+        uint32_t                    emptyChunkCount;
+        MemoryChunk *               partialChunks;
+        MemoryChunk *               emptyChunks;
+        MemoryChunk *               fullChunks;
     };
 
-    struct ChunkList {
-        VkDeviceSize                size;
-        VkDeviceSize                alignment;
-        uint32_t                    memoryTypeIndex;
-        std::vector<Chunk *>        chunks;
-    };
-
-    const static VkDeviceSize       BASE_ALIGNMENT = 256;
-    const static VkDeviceSize       MAX_BLOCK_SIZE = 4096;
-    const static uint32_t           BLOCK_COUNT = 64;
+    const static VkDeviceSize       BASE_BLOCK_SIZE      = 256;
+    const static uint32_t           BASE_BLOCK_SIZE_LOG2 = 8;
+    const static VkDeviceSize       MAX_BLOCK_SIZE       = 4096;
+    const static uint32_t           SIZE_CLASS_COUNT     = 5;
+    const static VkDeviceSize       CHUNK_SIZE           = 64 * 1024;
+    const static uint32_t           MAX_BLOCK_COUNT      = 64;
+    const static uint32_t           MAX_EMPTY_CHUNKS     = 2;
 
-    VkDevice                        mVkDevice;
-    std::map<uint64_t, ChunkList *> mChunkLists;
+    ChunkAllocator                  mDeviceChunkAllocator;
+    ChunkAllocator *                mChunkAllocator;
+    Pool                            mPools[VK_MAX_MEMORY_TYPES * SIZE_CLASS_COUNT];
+    uint32_t                        mChunkCount;
 
-    void                            FillBlock(MemoryBlock &block, Chunk &chunk);
-
-    Chunk *                         CreateChunk(VkDeviceSize size, uint32_t memoryTypeIndex);
+    static void                     LinkChunk(MemoryChunk **list, MemoryChunk *chunk);
+    static void                     UnlinkChunk(MemoryChunk **list, MemoryChunk *chunk);
 
+    MemoryChunk *                   CreateChunk(uint32_t poolIndex, uint32_t memoryTypeIndex);
+    void                            DestroyChunk(MemoryChunk *chunk);
     void                            CleanUp(void);
 
 public:
 // Constructor
-    MemoryAllocator(VkDevice vkDevice);
+    MemoryAllocator(DeviceAllocator *deviceAllocator, ChunkAllocator *chunkAllocator = nullptr);
 
 // Destructor
     ~MemoryAllocator();
 
-    inline bool                     CanAllocate(VkDeviceSize size)  { FUN_ENTRY(GL_LOG_TRACE); return size < MAX_BLOCK_SIZE; }
+    inline bool                     CanAllocate(VkDeviceSize size)  { FUN_ENTRY(GL_LOG_TRACE); return size <= MAX_BLOCK_SIZE; }
 
     void                            Allocate(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeIndex, MemoryBlock &block);
 
     bool                            Deallocate(MemoryBlock &block);
 
+// Trim Functions
+    uint32_t                        Trim(void);
+
+// Get Functions
+    inline uint32_t                 GetChunkCount(void)       const { FUN_ENTRY(GL_LOG_TRACE); return mChunkCount; }
 };
 
 }
@@ -35,7 +35,7 @@ namespace vulkanAPI {
 Pipeline::Pipeline(const vkContext_t *vkContext)
 : mVkContext(vkContext), mVkPipeline(VK_NULL_HANDLE), mVkPipelineLayout(VK_NULL_HANDLE),
   mVkPipelineCache(VK_NULL_HANDLE), mVkPipelineVertexInputState(VK_NULL_HANDLE),
-  mVkPipelineShaderStageCount(0), mYInverted(false), mCacheManager(nullptr)
+  mEnabledDynamicStatesMask(0), mVkPipelineShaderStageCount(0), mYInverted(false), mCacheManager(nullptr)
 {
     FUN_ENTRY(GL_LOG_TRACE);
 
@@ -289,12 +289,14 @@ Pipeline::CreateDynamicState(const std::vector<VkDynamicState>& states)
     for(size_t index = 0; index < mEnabledDynamicStatesList.size(); ++index) {
         mEnabledDynamicStatesList[index] = false;
     }
+    mEnabledDynamicStatesMask = 0;
     memset(mVkPipelineDynamicStateEnables, 0, sizeof(mVkPipelineDynamicStateEnables));
 
     for(size_t stateIndex = 0; stateIndex < states.size(); ++stateIndex) {
         VkDynamicState state = states[stateIndex];
         mVkPipelineDynamicStateEnables[stateIndex] = state;
         mEnabledDynamicStatesList[state] = true;
+        mEnabledDynamicStatesMask |= 1 << state;
     }
 
     memset(static_cast<void *>(&mVkPipelineDynamicState), 0, sizeof(mVkPipelineDynamicState));
@@ -305,18 +307,20 @@ Pipeline::CreateDynamicState(const std::vector<VkDynamicState>& states)
 }
 
 void
-Pipeline::UpdateDynamicState(const VkCommandBuffer *CmdBuffer, float lineWidth) const
+Pipeline::UpdateDynamicState(const VkCommandBuffer *CmdBuffer, BindState *bindState, float lineWidth) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
+    assert(mVkPipelineViewportState.viewportCount == 1 && mVkPipelineViewportState.scissorCount == 1);
+
     if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_VIEWPORT]) {
-        vkCmdSetViewport  (*CmdBuffer, 0, mVkPipelineViewportState.viewportCount, &mVkViewport);
+        bindState->SetViewport  (CmdBuffer, &mVkViewport);
     }
     if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_SCISSOR]) {
-        vkCmdSetScissor   (*CmdBuffer, 0, mVkPipelineViewportState.scissorCount , &mVkScissorRect);
+        bindState->SetScissor   (CmdBuffer, &mVkScissorRect);
     }
     if(mEnabledDynamicStatesList[VK_DYNAMIC_STATE_LINE_WIDTH]) {
-        vkCmdSetLineWidth (*CmdBuffer, lineWidth);
+        bindState->SetLineWidth (CmdBuffer, lineWidth);
     }
     /*
     TODO:: fill the remaining dynamic states
@@ -341,11 +345,11 @@ Pipeline::SetInfo(const VkRenderPass *renderpass)
 }
 
 void
-Pipeline::Bind(const VkCommandBuffer *CmdBuffer) const
+Pipeline::Bind(const VkCommandBuffer *CmdBuffer, BindState *bindState) const
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkCmdBindPipeline(*CmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mVkPipeline);
+    bindState->BindPipeline(CmdBuffer, mVkPipeline, mEnabledDynamicStatesMask);
 }
 
 bool
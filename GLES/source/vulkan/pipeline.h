@@ -25,6 +25,7 @@
 #define __VKPIPELINE_H__
 
 #include "context.h"
+#include "bindState.h"
 #include "utils/cacheManager.h"
 
 namespace vulkanAPI {
@@ -53,6 +54,7 @@ private:
     VkPipelineMultisampleStateCreateInfo        mVkPipelineMultisampleState;
 
     std::vector<bool>                           mEnabledDynamicStatesList;
+    uint32_t                                    mEnabledDynamicStatesMask;
     VkDynamicState                              mVkPipelineDynamicStateEnables[VK_DYNAMIC_STATE_RANGE_SIZE];
     VkPipelineDynamicStateCreateInfo            mVkPipelineDynamicState;
 
@@ -182,12 +184,12 @@ public:
           void ComputeScissor(int fboWidth, int fboHeight, int scissorX, int scissorY, int scissorW, int scissorH);
 
 // Bind Functions
-          void Bind(const VkCommandBuffer *CmdBuffer) const;
+          void Bind(const VkCommandBuffer *CmdBuffer, BindState *bindState) const;
 
 // Create Functions
           bool Create(const VkRenderPass *renderpass);
 // Update Functions
-          void UpdateDynamicState(const VkCommandBuffer *CmdBuffer, float lineWidth) const;
+          void UpdateDynamicState(const VkCommandBuffer *CmdBuffer, BindState *bindState, float lineWidth) const;
 };
 
 }
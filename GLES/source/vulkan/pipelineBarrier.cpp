@@ -0,0 +1,137 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       pipelineBarrier.cpp
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Batching of Pipeline Barriers in Vulkan
+ *
+ *  @section
+ *
+ *  Memory barriers are collected while they are requested and are recorded
+ *  with a single vkCmdPipelineBarrier right before the next command that
+ *  depends on them. Barriers within one vkCmdPipelineBarrier are not ordered
+ *  with respect to each other, so a barrier on a subresource that is already
+ *  pending is either merged with the pending one, when they cover the very
+ *  same subresources, or starts a new batch.
+ *
+ */
+
+#include "pipelineBarrier.h"
+
+namespace vulkanAPI {
+
+static bool
+SubresourceRangesOverlap(const VkImageSubresourceRange *a, const VkImageSubresourceRange *b)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return (a->aspectMask     & b->aspectMask)                     &&
+            a->baseMipLevel   < b->baseMipLevel   + b->levelCount  &&
+            b->baseMipLevel   < a->baseMipLevel   + a->levelCount  &&
+            a->baseArrayLayer < b->baseArrayLayer + b->layerCount  &&
+            b->baseArrayLayer < a->baseArrayLayer + a->layerCount;
+}
+
+static bool
+SubresourceRangesEqual(const VkImageSubresourceRange *a, const VkImageSubresourceRange *b)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    return a->aspectMask     == b->aspectMask     &&
+           a->baseMipLevel   == b->baseMipLevel   &&
+           a->levelCount     == b->levelCount     &&
+           a->baseArrayLayer == b->baseArrayLayer &&
+           a->layerCount     == b->layerCount;
+}
+
+PipelineBarrier::PipelineBarrier()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+PipelineBarrier::~PipelineBarrier()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+void
+PipelineBarrier::AddImageMemoryBarrier(VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages, const VkImageMemoryBarrier *imageMemoryBarrier)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    bool newBatch = mBatches.empty();
+
+    if(!newBatch) {
+        batch_t &batch = mBatches.back();
+        for(uint32_t i = 0; i < batch.imageMemoryBarriers.size(); ++i) {
+            VkImageMemoryBarrier &pending = batch.imageMemoryBarriers[i];
+            if(pending.image != imageMemoryBarrier->image ||
+              !SubresourceRangesOverlap(&pending.subresourceRange, &imageMemoryBarrier->subresourceRange)) {
+                continue;
+            }
+
+            if(SubresourceRangesEqual(&pending.subresourceRange, &imageMemoryBarrier->subresourceRange)) {
+                // fold both transitions into one, from the pending old layout to the new one
+                pending.newLayout      = imageMemoryBarrier->newLayout;
+                pending.dstAccessMask |= imageMemoryBarrier->dstAccessMask;
+                batch.srcStages       |= srcStages;
+                batch.dstStages       |= dstStages;
+                return;
+            }
+
+            newBatch = true;
+            break;
+        }
+    }
+
+    if(newBatch) {
+        mBatches.push_back(batch_t());
+        mBatches.back().srcStages = 0;
+        mBatches.back().dstStages = 0;
+    }
+
+    batch_t &batch = mBatches.back();
+    batch.srcStages |= srcStages;
+    batch.dstStages |= dstStages;
+    batch.imageMemoryBarriers.push_back(*imageMemoryBarrier);
+}
+
+void
+PipelineBarrier::Flush(VkCommandBuffer *activeCmdBuffer)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(uint32_t i = 0; i < mBatches.size(); ++i) {
+        const batch_t &batch = mBatches[i];
+        vkCmdPipelineBarrier(*activeCmdBuffer, batch.srcStages, batch.dstStages, 0,
+                             0, nullptr,
+                             0, nullptr,
+                             static_cast<uint32_t>(batch.imageMemoryBarriers.size()), batch.imageMemoryBarriers.data());
+    }
+
+    Reset();
+}
+
+void
+PipelineBarrier::Reset(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    mBatches.clear();
+}
+
+}
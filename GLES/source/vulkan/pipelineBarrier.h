@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       pipelineBarrier.h
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Batching of Pipeline Barriers in Vulkan
+ *
+ */
+
+#ifndef __VKPIPELINEBARRIER_H__
+#define __VKPIPELINEBARRIER_H__
+
+#include <vector>
+#include "context.h"
+
+namespace vulkanAPI {
+
+class PipelineBarrier {
+
+private:
+
+    typedef struct batch_t {
+        VkPipelineStageFlags              srcStages;
+        VkPipelineStageFlags              dstStages;
+        std::vector<VkImageMemoryBarrier> imageMemoryBarriers;
+    } batch_t;
+
+    std::vector<batch_t>              mBatches;
+
+public:
+// Constructor
+    PipelineBarrier();
+
+// Destructor
+    ~PipelineBarrier();
+
+// Add Functions
+    void                              AddImageMemoryBarrier(VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages, const VkImageMemoryBarrier *imageMemoryBarrier);
+
+// Flush Functions
+    void                              Flush(VkCommandBuffer *activeCmdBuffer);
+
+// Reset Functions
+    void                              Reset(void);
+
+// Is Functions
+    inline bool                       IsEmpty(void)                       const { FUN_ENTRY(GL_LOG_TRACE); return mBatches.empty(); }
+};
+
+}
+
+#endif // __VKPIPELINEBARRIER_H__
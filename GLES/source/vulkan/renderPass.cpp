@@ -134,6 +134,18 @@ RenderPass::Create(VkFormat colorFormat, VkFormat depthstencilFormat)
     subpass.preserveAttachmentCount = 0;
     subpass.pPreserveAttachments    = nullptr;
 
+    /// Render passes of a frame are recorded back to back in the same command buffer,
+    /// so order this one after the attachment writes of the previous ones
+    VkSubpassDependency dependency;
+    dependency.srcSubpass      = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass      = 0;
+    dependency.srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependency.srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dependencyFlags = 0;
+
     VkRenderPassCreateInfo info;
     info.sType            = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     info.pNext            = nullptr;
@@ -142,8 +154,8 @@ RenderPass::Create(VkFormat colorFormat, VkFormat depthstencilFormat)
     info.pAttachments     = attachments.data();
     info.subpassCount     = 1;
     info.pSubpasses       = &subpass;
-    info.dependencyCount  = 0;
-    info.pDependencies    = nullptr;
+    info.dependencyCount  = 1;
+    info.pDependencies    = &dependency;
 
     VkResult err = VK_SUCCESS;
 
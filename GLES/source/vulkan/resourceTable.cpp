@@ -0,0 +1,195 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       resourceTable.cpp
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Reference counted table of Vulkan objects shared between command buffers
+ *
+ *  @section
+ *
+ *  Vulkan objects shared by several GL objects (shader modules, pipeline and
+ *  descriptor set layouts, descriptor pools) are reference counted here, so
+ *  that they are retired only when their last user releases them. The table
+ *  is an open addressing hash table keyed by the Vulkan handle, using linear
+ *  probing and backward shift deletion, so that lookups, insertions and
+ *  removals take constant time regardless of the number of live objects.
+ *
+ */
+
+#include "resourceTable.h"
+
+#define GLOVE_RESOURCE_TABLE_INITIAL_SIZE       64
+
+namespace vulkanAPI {
+
+ResourceTable::ResourceTable()
+: mCount(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    mResources.resize(GLOVE_RESOURCE_TABLE_INITIAL_SIZE);
+    for(auto &resource : mResources) {
+        resource.handle = 0;
+    }
+}
+
+ResourceTable::~ResourceTable()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(!mCount);
+}
+
+uint32_t
+ResourceTable::Hash(uint64_t handle) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    // handles are usually aligned pointers, so mix all of their bits
+    handle ^= handle >> 33;
+    handle *= 0xff51afd7ed558ccdULL;
+    handle ^= handle >> 33;
+
+    return static_cast<uint32_t>(handle) & static_cast<uint32_t>(mResources.size() - 1);
+}
+
+uint32_t
+ResourceTable::Locate(uint64_t handle) const
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const uint32_t mask = static_cast<uint32_t>(mResources.size() - 1);
+
+    uint32_t index = Hash(handle);
+    while(mResources[index].handle && mResources[index].handle != handle) {
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+void
+ResourceTable::Remove(uint32_t index)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    const uint32_t mask = static_cast<uint32_t>(mResources.size() - 1);
+
+    // shift back the entries of the probe sequence, so that no tombstones are needed
+    uint32_t next = index;
+    while(true) {
+        next = (next + 1) & mask;
+        if(!mResources[next].handle) {
+            break;
+        }
+
+        const uint32_t home = Hash(mResources[next].handle);
+        const bool inPlace  = (index <= next) ? (index < home && home <= next) :
+                                                (index < home || home <= next);
+        if(!inPlace) {
+            mResources[index] = mResources[next];
+            index = next;
+        }
+    }
+
+    mResources[index].handle = 0;
+    --mCount;
+}
+
+void
+ResourceTable::Grow(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    std::vector<resource_t> resources(mResources.size() * 2);
+    for(auto &resource : resources) {
+        resource.handle = 0;
+    }
+    mResources.swap(resources);
+
+    for(const auto &resource : resources) {
+        if(resource.handle) {
+            mResources[Locate(resource.handle)] = resource;
+        }
+    }
+}
+
+void
+ResourceTable::Ref(uint64_t handle, resourceType_t type)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(handle);
+
+    uint32_t index = Locate(handle);
+    if(mResources[index].handle) {
+        assert(mResources[index].type == type);
+        ++mResources[index].refCount;
+        return;
+    }
+
+    // keep the load factor at most 1/2, so that probe sequences stay short
+    if(2 * (mCount + 1) > mResources.size()) {
+        Grow();
+        index = Locate(handle);
+    }
+
+    mResources[index].handle   = handle;
+    mResources[index].refCount = 1;
+    mResources[index].type     = type;
+    ++mCount;
+}
+
+bool
+ResourceTable::Unref(uint64_t handle, resource_t *retired)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    assert(handle);
+
+    const uint32_t index = Locate(handle);
+    if(!mResources[index].handle) {
+        return false;
+    }
+
+    assert(mResources[index].refCount);
+    if(--mResources[index].refCount) {
+        return false;
+    }
+
+    *retired = mResources[index];
+    Remove(index);
+
+    return true;
+}
+
+void
+ResourceTable::Release(std::vector<resource_t> *released)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    for(auto &resource : mResources) {
+        if(resource.handle) {
+            released->push_back(resource);
+            resource.handle = 0;
+        }
+    }
+
+    mCount = 0;
+}
+
+}
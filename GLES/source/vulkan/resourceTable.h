@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       resourceTable.h
+ *  @author     Think Silicon
+ *  @date       19/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Reference counted table of Vulkan objects shared between command buffers
+ *
+ */
+
+#ifndef __VKRESOURCETABLE_H__
+#define __VKRESOURCETABLE_H__
+
+#include <vector>
+#include "context.h"
+
+namespace vulkanAPI {
+
+typedef enum {
+    RESOURCE_TYPE_SHADER = 0,
+    RESOURCE_TYPE_PIPELINE_LAYOUT,
+    RESOURCE_TYPE_DESC_POOL,
+    RESOURCE_TYPE_DESC_SET_LAYOUT,
+    RESOURCE_TYPE_DESC_SET,
+    RESOURCE_TYPE_LAST
+} resourceType_t;
+
+typedef struct resource_t {
+    uint64_t                          handle;
+    uint32_t                          refCount;
+    resourceType_t                    type;
+} resource_t;
+
+class ResourceTable {
+
+private:
+
+    std::vector<resource_t>           mResources;
+    uint32_t                          mCount;
+
+    uint32_t                          Hash(uint64_t handle)               const;
+    uint32_t                          Locate(uint64_t handle)             const;
+    void                              Remove(uint32_t index);
+    void                              Grow(void);
+
+public:
+// Constructor
+    ResourceTable();
+
+// Destructor
+    ~ResourceTable();
+
+// Reference Functions
+    void                              Ref(uint64_t handle, resourceType_t type);
+    bool                              Unref(uint64_t handle, resource_t *retired);
+
+// Release Functions
+    void                              Release(std::vector<resource_t> *released);
+
+// Get Functions
+    inline uint32_t                   GetCount(void)                      const { FUN_ENTRY(GL_LOG_TRACE); return mCount; }
+};
+
+}
+
+#endif // __VKRESOURCETABLE_H__
@@ -0,0 +1,186 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       stagingRing.cpp
+ *  @author     Think Silicon
+ *  @date       12/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Host visible ring buffer for staging uploads in Vulkan
+ *
+ *  @section
+ *
+ *  Upload data is written into a single host visible transfer source buffer
+ *  that is used as a ring. Every allocation is tagged with the submission
+ *  serial that consumes it and its space is handed back once that serial
+ *  has completed on the GPU. Allocations are always released in order, so
+ *  only the head and the tail of the ring have to be tracked. The same ring
+ *  is also used with vertex and index buffer usage, to stream client arrays,
+ *  and with uniform buffer usage, to hold the uniform block data of draws.
+ *
+ */
+
+#include "stagingRing.h"
+
+namespace vulkanAPI {
+
+StagingRingAllocator StagingRing::mDefaultAllocator;
+
+bool
+StagingRingAllocator::Allocate(const vkContext_t *vkContext, VkBufferUsageFlags usage, VkDeviceSize size, Buffer **buffer, Memory **memory)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    *buffer = new Buffer(vkContext, usage, VK_SHARING_MODE_EXCLUSIVE);
+    *memory = new Memory(vkContext, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    (*memory)->SetCategory((usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) ? DEVICE_MEMORY_CATEGORY_UNIFORM : DEVICE_MEMORY_CATEGORY_STAGING);
+
+    (*buffer)->SetSize(size);
+    if(!(*buffer)->Create()                                             ||
+       !(*memory)->GetBufferMemoryRequirements((*buffer)->GetVkBuffer()) ||
+       !(*memory)->Create()                                             ||
+       !(*memory)->BindBufferMemory((*buffer)->GetVkBuffer())) {
+        return false;
+    }
+
+    return true;
+}
+
+void
+StagingRingAllocator::Free(Buffer *buffer, Memory *memory)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    delete buffer;
+    delete memory;
+}
+
+StagingRing::StagingRing(const vkContext_t *vkContext, VkBufferUsageFlags usage, StagingRingAllocator *allocator)
+: mVkContext(vkContext), mVkUsage(usage), mAllocator(allocator ? allocator : &mDefaultAllocator),
+  mBuffer(nullptr), mMemory(nullptr), mSize(0), mHead(0), mTail(0)
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+}
+
+StagingRing::~StagingRing()
+{
+    FUN_ENTRY(GL_LOG_TRACE);
+
+    Release();
+}
+
+bool
+StagingRing::Create(VkDeviceSize size)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    Release();
+
+    if(!mAllocator->Allocate(mVkContext, mVkUsage, size, &mBuffer, &mMemory)) {
+        Release();
+        return false;
+    }
+    mSize = size;
+
+    return true;
+}
+
+void
+StagingRing::Release(void)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    if(mBuffer || mMemory) {
+        mAllocator->Free(mBuffer, mMemory);
+        mBuffer = nullptr;
+        mMemory = nullptr;
+    }
+
+    mSize = 0;
+    mHead = 0;
+    mTail = 0;
+    while(!mAllocations.empty()) {
+        mAllocations.pop();
+    }
+}
+
+bool
+StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment, uint64_t serial, VkDeviceSize *offset)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    const VkDeviceSize ringSize = mSize;
+    if(size == 0 || size > ringSize) {
+        return false;
+    }
+
+    VkDeviceSize start = ((mHead + alignment - 1) / alignment) * alignment;
+
+    if(mAllocations.empty()) {
+        mHead = 0;
+        mTail = 0;
+        start = 0;
+    } else if(mHead >= mTail) {
+        // used space is [tail, head), try the end of the ring first and then wrap around.
+        // An allocation may never end at the tail, as a full ring would then look empty.
+        if(start + size > ringSize) {
+            if(size >= mTail) {
+                return false;
+            }
+            start = 0;
+        }
+    } else {
+        // used space is [tail, end) and [0, head)
+        if(start + size >= mTail) {
+            return false;
+        }
+    }
+
+    mHead = start + size;
+
+    allocation_t allocation;
+    allocation.end    = mHead;
+    allocation.serial = serial;
+    mAllocations.push(allocation);
+
+    *offset = start;
+
+    return true;
+}
+
+void
+StagingRing::Reclaim(uint64_t completedSerial)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    while(!mAllocations.empty() && mAllocations.front().serial <= completedSerial) {
+        mTail = mAllocations.front().end;
+        mAllocations.pop();
+    }
+
+    // a tail at the end of the ring means that the used space starts over at 0
+    if(mTail == mSize) {
+        mTail = 0;
+    }
+}
+
+bool
+StagingRing::SetData(VkDeviceSize size, VkDeviceSize offset, const void *data)
+{
+    FUN_ENTRY(GL_LOG_DEBUG);
+
+    return mMemory->SetData(size, offset, data);
+}
+
+}
@@ -0,0 +1,104 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+/**
+ *  @file       stagingRing.h
+ *  @author     Think Silicon
+ *  @date       12/11/2018
+ *  @version    1.0
+ *
+ *  @brief      Host visible ring buffer for staging uploads in Vulkan
+ *
+ */
+
+#ifndef __VKSTAGINGRING_H__
+#define __VKSTAGINGRING_H__
+
+#include <queue>
+#include "buffer.h"
+#include "memory.h"
+
+namespace vulkanAPI {
+
+/// Creates the host visible buffer and memory that back a StagingRing
+class StagingRingAllocator {
+public:
+// Destructor
+    virtual ~StagingRingAllocator()                                            { FUN_ENTRY(GL_LOG_TRACE); }
+
+// Allocate Functions
+    virtual bool                      Allocate(const vkContext_t *vkContext, VkBufferUsageFlags usage, VkDeviceSize size, Buffer **buffer, Memory **memory);
+
+// Free Functions
+    virtual void                      Free(Buffer *buffer, Memory *memory);
+};
+
+class StagingRing {
+
+private:
+
+    typedef struct allocation_t {
+        VkDeviceSize                  end;
+        uint64_t                      serial;
+    } allocation_t;
+
+    const
+    vkContext_t *                     mVkContext;
+    VkBufferUsageFlags                mVkUsage;
+
+    StagingRingAllocator *            mAllocator;
+    Buffer *                          mBuffer;
+    Memory *                          mMemory;
+
+    VkDeviceSize                      mSize;
+    VkDeviceSize                      mHead;
+    VkDeviceSize                      mTail;
+    std::queue<allocation_t>          mAllocations;
+
+    static StagingRingAllocator       mDefaultAllocator;
+
+public:
+// Constructor
+    StagingRing(const vkContext_t *vkContext = nullptr, VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT, StagingRingAllocator *allocator = nullptr);
+
+// Destructor
+    ~StagingRing();
+
+// Create Functions
+    bool                              Create(VkDeviceSize size);
+
+// Release Functions
+    void                              Release(void);
+
+// Allocate Functions
+    bool                              Allocate(VkDeviceSize size, VkDeviceSize alignment, uint64_t serial, VkDeviceSize *offset);
+
+// Reclaim Functions
+    void                              Reclaim(uint64_t completedSerial);
+
+// Set Functions
+    bool                              SetData(VkDeviceSize size, VkDeviceSize offset, const void *data);
+    inline void                       SetContext(const vkContext_t *vkContext)  { FUN_ENTRY(GL_LOG_TRACE); mVkContext = vkContext; }
+
+// Get Functions
+    inline VkBuffer                   GetVkBuffer(void)                   const { FUN_ENTRY(GL_LOG_TRACE); return mBuffer ? mBuffer->GetVkBuffer() : VK_NULL_HANDLE; }
+    inline VkDeviceSize               GetSize(void)                       const { FUN_ENTRY(GL_LOG_TRACE); return mSize; }
+    inline size_t                     GetAllocationCount(void)            const { FUN_ENTRY(GL_LOG_TRACE); return mAllocations.size(); }
+
+// Is Functions
+    inline bool                       IsCreated(void)                     const { FUN_ENTRY(GL_LOG_TRACE); return mSize != 0; }
+};
+
+}
+
+#endif // __VKSTAGINGRING_H__
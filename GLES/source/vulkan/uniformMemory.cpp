@@ -43,6 +43,7 @@ UniformMemory::Release(void)
 
     if (mMemoryBlock.vkMemory != VK_NULL_HANDLE) {
         mVkContext->memoryAllocator->Deallocate(mMemoryBlock);
+        mMemoryBlock = MemoryBlock();
     }
 }
 
@@ -110,10 +111,8 @@ UniformMemory::Lock(void **pData)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    VkResult err = vkMapMemory(mVkContext->vkDevice, mMemoryBlock.vkMemory, mMemoryBlock.offset, mVkRequirements.size, mVkMemoryFlags, pData);
-    assert(!err);
-
-    return (err != VK_ERROR_OUT_OF_HOST_MEMORY && err != VK_ERROR_OUT_OF_DEVICE_MEMORY);
+    // blocks share the persistently mapped memory of their chunk
+    return mVkContext->deviceAllocator->GetMappedData(mMemoryBlock.allocation, mMemoryBlock.offset - mMemoryBlock.allocation->offset, pData);
 }
 
 bool
@@ -121,7 +120,7 @@ UniformMemory::Unlock(void)
 {
     FUN_ENTRY(GL_LOG_DEBUG);
 
-    vkUnmapMemory(mVkContext->vkDevice, mMemoryBlock.vkMemory);
+    mVkContext->deviceAllocator->Flush(mMemoryBlock.allocation, mMemoryBlock.offset - mMemoryBlock.allocation->offset, mVkRequirements.size);
 
     return true;
 }
@@ -12,6 +12,11 @@
  */
 
 #include "arrays_tests.h"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
 
 namespace Testing {
 
@@ -67,4 +72,144 @@ TEST_F(ObjectArrayTest, DeleteShaders)
 
 }
 
+TEST_F(ObjectArrayTest, RecycleShaders)
+{
+    for(size_t i=1; i<11; i++) {
+        ASSERT_EQ(i, ShaderArray.Allocate());
+        ASSERT_NE(nullptr, ShaderArray.Object(i));
+    }
+
+    ASSERT_TRUE(ShaderArray.Deallocate(5));
+    ASSERT_FALSE(ShaderArray.Deallocate(5));
+
+    // the freed slot is reused under a new name, rejecting the old one
+    const uint32_t id = ShaderArray.Allocate();
+    ASSERT_NE(5u, id);
+    ASSERT_EQ(10u, ShaderArray.GetObjects().Size());
+    ASSERT_NE(nullptr, ShaderArray.Object(id));
+    ASSERT_EQ(id, ShaderArray.GetObjectId(ShaderArray.Object(id)));
+    ASSERT_FALSE(ShaderArray.ObjectExists(5));
+    ASSERT_EQ(nullptr, ShaderArray.Object(5));
+
+    ASSERT_EQ(nullptr, ShaderArray.Object(0));
+    ASSERT_EQ(nullptr, ShaderArray.Object(11));
+    ASSERT_FALSE(ShaderArray.Deallocate(0));
+}
+
+TEST_F(ObjectArrayTest, RecycleOldestSlotFirst)
+{
+    for(size_t i=1; i<4; i++) {
+        ASSERT_EQ(i, ShaderArray.Allocate());
+    }
+
+    ASSERT_TRUE(ShaderArray.Deallocate(2));
+    ASSERT_TRUE(ShaderArray.Deallocate(1));
+    ASSERT_TRUE(ShaderArray.Deallocate(3));
+
+    // the slot freed first is the first one reused
+    ASSERT_EQ(2u, ShaderArray.Allocate() & 0xFFFFF);
+    ASSERT_EQ(1u, ShaderArray.Allocate() & 0xFFFFF);
+    ASSERT_EQ(3u, ShaderArray.Allocate() & 0xFFFFF);
+    ASSERT_EQ(4u, ShaderArray.Allocate() & 0xFFFFF);
+}
+
+TEST_F(ObjectArrayTest, RetireExhaustedSlots)
+{
+    std::set<uint32_t> ids;
+
+    // every generation of the slot is handed out once
+    uint32_t id = ShaderArray.Allocate();
+    ids.insert(id);
+    for(size_t i=0; i<4095; i++) {
+        ASSERT_TRUE(ShaderArray.Deallocate(id));
+        id = ShaderArray.Allocate();
+        ASSERT_EQ(1u, id & 0xFFFFF);
+        ASSERT_TRUE(ids.insert(id).second);
+    }
+
+    // the slot is retired instead of wrapping around to its first name
+    ASSERT_TRUE(ShaderArray.Deallocate(id));
+    ASSERT_FALSE(ShaderArray.Deallocate(id));
+    id = ShaderArray.Allocate();
+    ASSERT_EQ(2u, id & 0xFFFFF);
+    ASSERT_EQ(2u, ShaderArray.GetObjects().Size());
+    ASSERT_FALSE(ShaderArray.ObjectExists(1));
+    ASSERT_EQ(nullptr, ShaderArray.Object(1));
+}
+
+struct BenchmarkObject {
+    BenchmarkObject() : value(1) { }
+    uint32_t value;
+};
+
+// Run with --gtest_also_run_disabled_tests
+TEST_F(ObjectArrayTest, DISABLED_BenchmarkLookup)
+{
+    const size_t liveObjects = 4096;
+    const size_t iterations  = 10000000;
+
+    ObjectArray<BenchmarkObject> objects;
+    std::map<uint32_t, BenchmarkObject *> objectMap;
+    std::vector<uint32_t> ids(liveObjects);
+    for(size_t i = 0; i < liveObjects; ++i) {
+        ids[i] = objects.Allocate();
+        objectMap[ids[i]] = objects.Object(ids[i]);
+    }
+
+    // resolve names in a scattered order, as the bind and draw paths do
+    uint32_t seed = 1;
+    uint32_t sum  = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < iterations; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        sum += objects.Object(ids[(seed >> 8) % liveObjects])->value;
+    }
+    auto end = std::chrono::steady_clock::now();
+    const double arrayNs = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+
+    seed = 1;
+    start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < iterations; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        sum += objectMap.find(ids[(seed >> 8) % liveObjects])->second->value;
+    }
+    end = std::chrono::steady_clock::now();
+    const double mapNs = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+
+    std::cout << "[ BENCHMARK] lookup: " << arrayNs << " ns (std::map: " << mapNs << " ns)" << std::endl;
+    RecordProperty("LookupNs", static_cast<int>(arrayNs));
+    RecordProperty("MapLookupNs", static_cast<int>(mapNs));
+
+    ASSERT_EQ(2 * iterations, sum);
+}
+
+TEST_F(ObjectArrayTest, DISABLED_BenchmarkCreateDelete)
+{
+    const size_t objectsPerFrame = 256;
+    const size_t frames          = 10000;
+
+    ObjectArray<BenchmarkObject> objects;
+    std::vector<uint32_t> ids(objectsPerFrame);
+
+    // objects created and deleted every frame keep recycling the same slots,
+    // until they run out of generations and new ones take their place
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t frame = 0; frame < frames; ++frame) {
+        for(size_t i = 0; i < objectsPerFrame; ++i) {
+            ids[i] = objects.Allocate();
+            objects.Object(ids[i]);
+        }
+        for(size_t i = 0; i < objectsPerFrame; ++i) {
+            objects.Deallocate(ids[i]);
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / (frames * objectsPerFrame);
+    std::cout << "[ BENCHMARK] create + delete: " << ns << " ns" << std::endl;
+    RecordProperty("CreateDeleteNs", static_cast<int>(ns));
+
+    ASSERT_EQ(objectsPerFrame * (1 + (frames - 1) / 4096), objects.GetObjects().Size());
+}
+
 } //end of namespace
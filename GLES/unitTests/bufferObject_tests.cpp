@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+#include "bufferObject_tests.h"
+
+namespace Testing {
+
+// Code here will be called immediately after the constructor (right
+// before each test).
+void BufferUpdateTrackerTest::SetUp(void) {
+    return;
+}
+
+// Code here will be called immediately after each test (right
+// before the destructor).
+void BufferUpdateTrackerTest::TearDown() {
+    return;
+}
+
+TEST_F(BufferUpdateTrackerTest, FirstDataOnALateSerialIsNotAnIdleGap)
+{
+    // a buffer created long after the context, e.g. on frame 1000
+    Tracker.TrackUpdate(100000);
+    ASSERT_EQ(1u, Tracker.GetUpdateCount());
+
+    ASSERT_FALSE(Tracker.PreferDeviceLocal(GL_DYNAMIC_DRAW));
+    ASSERT_FALSE(Tracker.PreferDeviceLocal(GL_STREAM_DRAW));
+    ASSERT_TRUE(Tracker.PreferDeviceLocal(GL_STATIC_DRAW));
+}
+
+TEST_F(BufferUpdateTrackerTest, DynamicBuffersStayHostVisible)
+{
+    uint64_t serial = 100000;
+    for(int i = 0; i < 16; ++i) {
+        Tracker.TrackUpdate(serial);
+        ASSERT_FALSE(Tracker.PreferDeviceLocal(GL_DYNAMIC_DRAW));
+        ASSERT_FALSE(Tracker.PreferDeviceLocal(GL_STREAM_DRAW));
+        // updates both frequent and rare
+        serial += (i & 1) ? 1 : 1000;
+    }
+}
+
+TEST_F(BufferUpdateTrackerTest, StaticBuffersFollowTheirUpdateFrequency)
+{
+    uint64_t serial = 100000;
+
+    // frequent updates make a static buffer hot
+    for(int i = 0; i < 8; ++i) {
+        Tracker.TrackUpdate(serial++);
+    }
+    ASSERT_FALSE(Tracker.PreferDeviceLocal(GL_STATIC_DRAW));
+
+    // it stays hot while the updates keep coming
+    serial += 10;
+    Tracker.TrackUpdate(serial);
+    ASSERT_FALSE(Tracker.PreferDeviceLocal(GL_STATIC_DRAW));
+
+    // and cools down after a long idle period
+    serial += 1000;
+    Tracker.TrackUpdate(serial);
+    ASSERT_EQ(1u, Tracker.GetUpdateCount());
+    ASSERT_TRUE(Tracker.PreferDeviceLocal(GL_STATIC_DRAW));
+}
+
+} //end of namespace
@@ -0,0 +1,104 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+#include "dispatchQueue_tests.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace Testing {
+
+// Code here will be called immediately after the constructor (right
+// before each test).
+void DispatchQueueTest::SetUp(void) {
+    Queue = new DispatchQueue(nullptr);
+}
+
+// Code here will be called immediately after each test (right
+// before the destructor).
+void DispatchQueueTest::TearDown() {
+    delete Queue;
+}
+
+TEST_F(DispatchQueueTest, ReplayInOrder)
+{
+    std::vector<int> calls;
+
+    for(int i = 0; i < 1000; ++i) {
+        Queue->Enqueue([&calls, i](Context *) { calls.push_back(i); });
+    }
+    Queue->Synchronize();
+
+    ASSERT_EQ(1000u, calls.size());
+    for(int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(i, calls[i]);
+    }
+}
+
+TEST_F(DispatchQueueTest, SynchronizeFromAnotherThread)
+{
+    std::atomic<uint32_t> replayed(0);
+    std::atomic<bool>     done(false);
+
+    // EGL may wait for the queue of a context from any thread, while the
+    // application thread keeps enqueueing
+    std::thread waiter([this, &done] {
+        while(!done.load()) {
+            Queue->Synchronize();
+        }
+    });
+
+    for(uint32_t i = 0; i < 100000; ++i) {
+        Queue->Enqueue([&replayed](Context *) { replayed.fetch_add(1); });
+    }
+    Queue->Synchronize();
+    ASSERT_EQ(100000u, replayed.load());
+
+    done.store(true);
+    waiter.join();
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST_F(DispatchQueueTest, DISABLED_BenchmarkEnqueue)
+{
+    const uint32_t calls = 1000000;
+    volatile uint32_t replayed = 0;
+
+    // the cost the application thread pays per queued call, against
+    // running the same call directly
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < calls; ++i) {
+        replayed = replayed + 1;
+    }
+    auto end = std::chrono::steady_clock::now();
+    const double direct = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+
+    start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < calls; ++i) {
+        Queue->Enqueue([&replayed](Context *) { replayed = replayed + 1; });
+    }
+    end = std::chrono::steady_clock::now();
+    const double enqueue = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+
+    Queue->Synchronize();
+    end = std::chrono::steady_clock::now();
+    const double drained = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+
+    std::cout << "[ BENCHMARK] DIRECT: "  << direct  << " ns/call" << std::endl;
+    std::cout << "[ BENCHMARK] ENQUEUE: " << enqueue << " ns/call" << std::endl;
+    std::cout << "[ BENCHMARK] DRAINED: " << drained << " ns/call" << std::endl;
+    RecordProperty("ENQUEUE", static_cast<int>(enqueue * 1000));
+    RecordProperty("DRAINED", static_cast<int>(drained * 1000));
+}
+
+} //end of namespace
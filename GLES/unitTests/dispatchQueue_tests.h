@@ -0,0 +1,32 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+#ifndef __DISPATCHQUEUE_TESTS_H__
+#define __DISPATCHQUEUE_TESTS_H__
+
+#include "gtest/gtest.h"
+#include "api/dispatchQueue.h"
+
+namespace Testing {
+
+class DispatchQueueTest : public ::testing::Test {
+protected:
+    void SetUp(void);
+    void TearDown(void);
+
+    DispatchQueue *Queue;
+};
+
+} //end of namespace
+
+#endif // __DISPATCHQUEUE_TESTS_H__
@@ -0,0 +1,275 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+#include "memoryAllocator_tests.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace Testing {
+
+using vulkanAPI::DeviceAllocation;
+using vulkanAPI::MemoryBlock;
+
+FakeChunkAllocator::FakeChunkAllocator()
+: LiveChunks(0), FailedAllocations(0), NextOffset(0)
+{
+}
+
+// chunks are carved out of an address space that is never accessed
+DeviceAllocation *
+FakeChunkAllocator::Allocate(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeIndex)
+{
+    if(FailedAllocations) {
+        --FailedAllocations;
+        return nullptr;
+    }
+
+    DeviceAllocation *allocation = new DeviceAllocation;
+    allocation->vkMemory = VK_NULL_HANDLE;
+    allocation->offset   = (NextOffset + alignment - 1) & ~(alignment - 1);
+    allocation->size     = size;
+    NextOffset = allocation->offset + size;
+    ++LiveChunks;
+
+    return allocation;
+}
+
+void
+FakeChunkAllocator::Free(DeviceAllocation *allocation)
+{
+    delete allocation;
+    --LiveChunks;
+}
+
+// Code here will be called immediately after the constructor (right
+// before each test).
+void MemoryAllocatorTest::SetUp(void) {
+    Allocator = new vulkanAPI::MemoryAllocator(nullptr, &Chunks);
+}
+
+// Code here will be called immediately after each test (right
+// before the destructor).
+void MemoryAllocatorTest::TearDown() {
+    delete Allocator;
+    ASSERT_EQ(0u, Chunks.LiveChunks);
+}
+
+TEST_F(MemoryAllocatorTest, BlocksAreAlignedToTheirSizeClass)
+{
+    const VkDeviceSize sizes[]      = {  1, 100, 256, 257, 1000, 2048, 3000, 4096 };
+    const VkDeviceSize alignments[] = { 16,  64, 256,   4,  256,    1,   16,  256 };
+    const VkDeviceSize classes[]    = {256, 256, 256, 512, 1024, 2048, 4096, 4096 };
+
+    MemoryBlock blocks[8];
+    for(int i = 0; i < 8; ++i) {
+        Allocator->Allocate(sizes[i], alignments[i], 0, blocks[i]);
+        ASSERT_NE(nullptr, blocks[i].chunk);
+        ASSERT_EQ(0u, blocks[i].offset % classes[i]);
+    }
+
+    for(int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(Allocator->Deallocate(blocks[i]));
+    }
+}
+
+TEST_F(MemoryAllocatorTest, LargeAlignmentSelectsLargerClass)
+{
+    MemoryBlock block;
+    Allocator->Allocate(16, 1024, 0, block);
+    ASSERT_NE(nullptr, block.chunk);
+    ASSERT_EQ(0u, block.offset % 1024);
+    ASSERT_TRUE(Allocator->Deallocate(block));
+}
+
+TEST_F(MemoryAllocatorTest, OversizedRequestsFail)
+{
+    MemoryBlock block;
+    ASSERT_FALSE(Allocator->CanAllocate(4097));
+    Allocator->Allocate(4097, 256, 0, block);
+    ASSERT_EQ(nullptr, block.chunk);
+    ASSERT_EQ(0u, Allocator->GetChunkCount());
+}
+
+TEST_F(MemoryAllocatorTest, BlocksOfAChunkAreDistinct)
+{
+    std::vector<MemoryBlock> blocks(65);
+    for(auto &block : blocks) {
+        Allocator->Allocate(256, 256, 0, block);
+        ASSERT_NE(nullptr, block.chunk);
+    }
+
+    // 64 blocks of the smallest class fill a chunk
+    ASSERT_EQ(2u, Allocator->GetChunkCount());
+    ASSERT_EQ(blocks[0].chunk, blocks[63].chunk);
+    ASSERT_NE(blocks[0].chunk, blocks[64].chunk);
+
+    for(size_t i = 0; i < 64; ++i) {
+        for(size_t j = i + 1; j < 64; ++j) {
+            ASSERT_NE(blocks[i].offset, blocks[j].offset);
+        }
+    }
+
+    for(auto &block : blocks) {
+        ASSERT_TRUE(Allocator->Deallocate(block));
+    }
+}
+
+TEST_F(MemoryAllocatorTest, MemoryTypesDoNotShareChunks)
+{
+    MemoryBlock block0, block1;
+    Allocator->Allocate(256, 256, 0, block0);
+    Allocator->Allocate(256, 256, 1, block1);
+    ASSERT_NE(block0.chunk, block1.chunk);
+    ASSERT_EQ(2u, Allocator->GetChunkCount());
+
+    ASSERT_TRUE(Allocator->Deallocate(block0));
+    ASSERT_TRUE(Allocator->Deallocate(block1));
+}
+
+TEST_F(MemoryAllocatorTest, FreedBlocksAreReused)
+{
+    MemoryBlock block0, block1, block2;
+    Allocator->Allocate(512, 256, 0, block0);
+    Allocator->Allocate(512, 256, 0, block1);
+    const VkDeviceSize offset = block0.offset;
+
+    ASSERT_TRUE(Allocator->Deallocate(block0));
+    ASSERT_EQ(nullptr, block0.chunk);
+
+    Allocator->Allocate(512, 256, 0, block2);
+    ASSERT_EQ(offset, block2.offset);
+    ASSERT_EQ(1u, Allocator->GetChunkCount());
+
+    ASSERT_TRUE(Allocator->Deallocate(block1));
+    ASSERT_TRUE(Allocator->Deallocate(block2));
+}
+
+TEST_F(MemoryAllocatorTest, DoubleDeallocationFails)
+{
+    MemoryBlock block;
+    Allocator->Allocate(256, 256, 0, block);
+
+    MemoryBlock copy = block;
+    ASSERT_TRUE(Allocator->Deallocate(block));
+    ASSERT_FALSE(Allocator->Deallocate(block));
+    ASSERT_FALSE(Allocator->Deallocate(copy));
+}
+
+TEST_F(MemoryAllocatorTest, EmptyChunksAreBoundedAndTrimmed)
+{
+    // 4 chunks of 16 blocks of the largest class
+    std::vector<MemoryBlock> blocks(64);
+    for(auto &block : blocks) {
+        Allocator->Allocate(4096, 256, 0, block);
+    }
+    ASSERT_EQ(4u, Allocator->GetChunkCount());
+
+    for(auto &block : blocks) {
+        ASSERT_TRUE(Allocator->Deallocate(block));
+    }
+
+    // only a couple of empty chunks are kept for reuse
+    const uint32_t emptyChunks = Allocator->GetChunkCount();
+    ASSERT_GT(4u, emptyChunks);
+    ASSERT_LT(0u, emptyChunks);
+
+    ASSERT_EQ(emptyChunks, Allocator->Trim());
+    ASSERT_EQ(0u, Allocator->GetChunkCount());
+    ASSERT_EQ(0u, Chunks.LiveChunks);
+}
+
+TEST_F(MemoryAllocatorTest, EmptyChunksAreTrimmedUnderPressure)
+{
+    MemoryBlock block;
+    Allocator->Allocate(256, 256, 0, block);
+    ASSERT_TRUE(Allocator->Deallocate(block));
+    ASSERT_EQ(1u, Allocator->GetChunkCount());
+
+    // the next chunk only fits once the empty one has been given back
+    Chunks.FailedAllocations = 1;
+    Allocator->Allocate(1024, 256, 0, block);
+    ASSERT_NE(nullptr, block.chunk);
+    ASSERT_EQ(1u, Allocator->GetChunkCount());
+    ASSERT_EQ(1u, Chunks.LiveChunks);
+
+    ASSERT_TRUE(Allocator->Deallocate(block));
+}
+
+TEST_F(MemoryAllocatorTest, DestructorReleasesFullChunks)
+{
+    // a full chunk of the largest class and a partial one
+    std::vector<MemoryBlock> blocks(17);
+    for(auto &block : blocks) {
+        Allocator->Allocate(4096, 256, 0, block);
+        ASSERT_NE(nullptr, block.chunk);
+    }
+    ASSERT_EQ(2u, Allocator->GetChunkCount());
+
+    delete Allocator;
+    Allocator = nullptr;
+    ASSERT_EQ(0u, Chunks.LiveChunks);
+}
+
+TEST_F(MemoryAllocatorTest, FullChunksTakeBlocksBackOnDeallocation)
+{
+    std::vector<MemoryBlock> blocks(16);
+    for(auto &block : blocks) {
+        Allocator->Allocate(4096, 256, 0, block);
+    }
+    ASSERT_EQ(1u, Allocator->GetChunkCount());
+
+    // the freed block of the full chunk is served before a new chunk is created
+    const VkDeviceSize offset = blocks[5].offset;
+    ASSERT_TRUE(Allocator->Deallocate(blocks[5]));
+    Allocator->Allocate(4096, 256, 0, blocks[5]);
+    ASSERT_EQ(offset, blocks[5].offset);
+    ASSERT_EQ(1u, Allocator->GetChunkCount());
+
+    for(auto &block : blocks) {
+        ASSERT_TRUE(Allocator->Deallocate(block));
+    }
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST_F(MemoryAllocatorTest, DISABLED_BenchmarkAllocateDeallocate)
+{
+    const size_t liveBlocks = 4096;
+    const size_t iterations = 1000000;
+
+    std::vector<MemoryBlock> blocks(liveBlocks);
+    for(size_t i = 0; i < liveBlocks; ++i) {
+        Allocator->Allocate(256 << (i % 5), 256, 0, blocks[i]);
+    }
+
+    // free and reallocate blocks in a scattered order, keeping the working set live
+    uint32_t seed = 1;
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < iterations; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const size_t index = (seed >> 8) % liveBlocks;
+        Allocator->Deallocate(blocks[index]);
+        Allocator->Allocate(256 << (index % 5), 256, 0, blocks[index]);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::cout << "[ BENCHMARK] allocate + deallocate: " << ns << " ns" << std::endl;
+    RecordProperty("AllocateDeallocateNs", static_cast<int>(ns));
+
+    for(auto &block : blocks) {
+        ASSERT_TRUE(Allocator->Deallocate(block));
+    }
+}
+
+} //end of namespace
@@ -0,0 +1,45 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+#ifndef __MEMORYALLOCATOR_TESTS_H__
+#define __MEMORYALLOCATOR_TESTS_H__
+
+#include "gtest/gtest.h"
+#include "vulkan/memoryAllocator.h"
+
+namespace Testing {
+
+class FakeChunkAllocator : public vulkanAPI::ChunkAllocator {
+public:
+    FakeChunkAllocator();
+
+    vulkanAPI::DeviceAllocation *Allocate(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeIndex) override;
+    void Free(vulkanAPI::DeviceAllocation *allocation) override;
+
+    uint32_t LiveChunks;
+    uint32_t FailedAllocations;
+    VkDeviceSize NextOffset;
+};
+
+class MemoryAllocatorTest : public ::testing::Test {
+protected:
+    void SetUp(void);
+    void TearDown(void);
+
+    FakeChunkAllocator Chunks;
+    vulkanAPI::MemoryAllocator *Allocator;
+};
+
+} //end of namespace
+
+#endif // __MEMORYALLOCATOR_TESTS_H__
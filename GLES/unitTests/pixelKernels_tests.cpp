@@ -0,0 +1,178 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+#include "pixelKernels_tests.h"
+#include <chrono>
+#include <iostream>
+
+namespace Testing {
+
+// the Color pair each kernel stands for, indexed by pixelKernel_t
+static const struct {
+    Color (*From)(const uint8_t *);
+    void  (*To)(Color &, uint8_t *);
+} referenceConversions[PIXEL_KERNEL_COUNT] = {
+    { &Color::FromBGRA,           &Color::ConvertToRGBA           },
+    { &Color::FromBGRA,           &Color::ConvertToRGB            },
+    { &Color::FromBGRA,           &Color::ConvertToLuminanceAlpha },
+    { &Color::FromBGRA,           &Color::ConvertToLuminance      },
+    { &Color::FromBGRA,           &Color::ConvertToAlpha          },
+    { &Color::FromRGBA,           &Color::ConvertToRGB            },
+    { &Color::FromRGBA,           &Color::ConvertToAlpha          },
+    { &Color::FromRGB,            &Color::ConvertToRGBA           },
+    { &Color::FromLuminanceAlpha, &Color::ConvertToLuminance      },
+    { &Color::FromLuminanceAlpha, &Color::ConvertToRGBA           },
+    { &Color::FromLuminance,      &Color::ConvertToLuminanceAlpha },
+    { &Color::FromLuminance,      &Color::ConvertToRGBA           },
+    { &Color::FromAlpha,          &Color::ConvertToRGBA           },
+    { &Color::From4444,           &Color::ConvertToRGBA           },
+    { &Color::From5551,           &Color::ConvertToRGBA           },
+    { &Color::From565,            &Color::ConvertToRGBA           },
+    { &Color::From565,            &Color::ConvertToLuminance      }
+};
+
+// wide enough for the largest vector loop plus a scalar tail
+static const uint32_t MAX_PIXELS = 131;
+
+// Code here will be called immediately after the constructor (right
+// before each test).
+void PixelKernelsTest::SetUp(void) {
+    Source.resize(MAX_PIXELS * 4);
+    uint32_t seed = 1;
+    for(auto &byte : Source) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+}
+
+// Code here will be called immediately after each test (right
+// before the destructor).
+void PixelKernelsTest::TearDown() {
+}
+
+void
+PixelKernelsTest::Reference(pixelKernel_t kernel, const uint8_t *src, uint8_t *dst, uint32_t pixels)
+{
+    const uint32_t srcBytes = PixelKernelSrcBytes(kernel);
+    const uint32_t dstBytes = PixelKernelDstBytes(kernel);
+
+    for(uint32_t i = 0; i < pixels; ++i) {
+        Color color = referenceConversions[kernel].From(&src[i * srcBytes]);
+        referenceConversions[kernel].To(color, &dst[i * dstBytes]);
+    }
+}
+
+TEST_F(PixelKernelsTest, DispatchPicksASupportedKernel)
+{
+    ASSERT_TRUE(PixelKernelIsaSupported(PIXEL_KERNEL_ISA_SCALAR));
+    ASSERT_TRUE(PixelKernelIsaSupported(GetPixelKernelIsa()));
+
+    for(uint32_t k = 0; k < PIXEL_KERNEL_COUNT; ++k) {
+        const pixelKernel_t kernel = static_cast<pixelKernel_t>(k);
+        ASSERT_NE(nullptr, GetPixelKernel(kernel));
+        ASSERT_NE(nullptr, GetPixelKernel(kernel, PIXEL_KERNEL_ISA_SCALAR));
+    }
+}
+
+TEST_F(PixelKernelsTest, MatchColorConversions)
+{
+    // a guard band after the row catches writes past the last pixel
+    const uint32_t guard = 64;
+    std::vector<uint8_t> expected(MAX_PIXELS * 4 + guard);
+    std::vector<uint8_t> result(MAX_PIXELS * 4 + guard);
+
+    for(uint32_t i = 0; i < PIXEL_KERNEL_ISA_COUNT; ++i) {
+        const pixelKernelIsa_t isa = static_cast<pixelKernelIsa_t>(i);
+        if(!PixelKernelIsaSupported(isa)) {
+            continue;
+        }
+
+        for(uint32_t k = 0; k < PIXEL_KERNEL_COUNT; ++k) {
+            const pixelKernel_t kernel = static_cast<pixelKernel_t>(k);
+            const pixelRowKernel_t rowKernel = GetPixelKernel(kernel, isa);
+            if(!rowKernel) {
+                continue;
+            }
+
+            for(uint32_t pixels = 0; pixels <= MAX_PIXELS; ++pixels) {
+                // the source is copied to the end of its own buffer to catch reads past the last pixel
+                const uint32_t srcSize = pixels * PixelKernelSrcBytes(kernel);
+                std::vector<uint8_t> src(Source.begin(), Source.begin() + srcSize);
+
+                std::fill(expected.begin(), expected.end(), 0xCD);
+                std::fill(result.begin(), result.end(), 0xCD);
+                Reference(kernel, src.data(), expected.data(), pixels);
+                rowKernel(src.data(), result.data(), pixels);
+
+                ASSERT_EQ(expected, result) << PixelKernelToString(kernel) << " "
+                                            << PixelKernelIsaToString(isa) << " "
+                                            << pixels << " pixels";
+            }
+        }
+    }
+}
+
+// Run with --gtest_also_run_disabled_tests
+TEST_F(PixelKernelsTest, DISABLED_BenchmarkConversions)
+{
+    // a 256x256 texture, converted row by row
+    const uint32_t width      = 256;
+    const uint32_t height     = 256;
+    const uint32_t iterations = 50;
+
+    std::vector<uint8_t> src(width * height * 4);
+    std::vector<uint8_t> dst(width * height * 4);
+    for(size_t i = 0; i < src.size(); ++i) {
+        src[i] = Source[i % Source.size()];
+    }
+
+    for(uint32_t k = 0; k < PIXEL_KERNEL_COUNT; ++k) {
+        const pixelKernel_t kernel   = static_cast<pixelKernel_t>(k);
+        const uint32_t      srcBytes = PixelKernelSrcBytes(kernel);
+        const uint32_t      dstBytes = PixelKernelDstBytes(kernel);
+
+        // the per pixel Color conversion is the baseline
+        auto start = std::chrono::steady_clock::now();
+        for(uint32_t i = 0; i < iterations; ++i) {
+            for(uint32_t row = 0; row < height; ++row) {
+                Reference(kernel, &src[row * width * srcBytes], &dst[row * width * dstBytes], width);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        const double baseline = std::chrono::duration<double, std::nano>(end - start).count() / (iterations * width * height);
+        std::cout << "[ BENCHMARK] " << PixelKernelToString(kernel) << " COLOR: " << baseline << " ns/pixel" << std::endl;
+
+        for(uint32_t i = 0; i < PIXEL_KERNEL_ISA_COUNT; ++i) {
+            const pixelKernelIsa_t isa = static_cast<pixelKernelIsa_t>(i);
+            const pixelRowKernel_t rowKernel = GetPixelKernel(kernel, isa);
+            if(!rowKernel) {
+                continue;
+            }
+
+            start = std::chrono::steady_clock::now();
+            for(uint32_t j = 0; j < iterations; ++j) {
+                for(uint32_t row = 0; row < height; ++row) {
+                    rowKernel(&src[row * width * srcBytes], &dst[row * width * dstBytes], width);
+                }
+            }
+            end = std::chrono::steady_clock::now();
+
+            const double ns = std::chrono::duration<double, std::nano>(end - start).count() / (iterations * width * height);
+            std::cout << "[ BENCHMARK] " << PixelKernelToString(kernel) << " " << PixelKernelIsaToString(isa) << ": "
+                      << ns << " ns/pixel (" << baseline / ns << "x)" << std::endl;
+            RecordProperty(std::string(PixelKernelToString(kernel)) + " " + PixelKernelIsaToString(isa), static_cast<int>(ns * 1000));
+        }
+    }
+}
+
+} //end of namespace
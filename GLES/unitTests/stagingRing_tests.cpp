@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2015-2018 Think Silicon S.A. (https://think-silicon.com/)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public v3
+ * License as published by the Free Software Foundation;
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ */
+
+#include "stagingRing_tests.h"
+
+namespace Testing {
+
+static const VkDeviceSize RING_SIZE = 1024;
+
+bool
+NullStagingRingAllocator::Allocate(const vulkanAPI::vkContext_t *vkContext, VkBufferUsageFlags usage, VkDeviceSize size,
+                                   vulkanAPI::Buffer **buffer, vulkanAPI::Memory **memory)
+{
+    *buffer = nullptr;
+    *memory = nullptr;
+    return true;
+}
+
+void
+NullStagingRingAllocator::Free(vulkanAPI::Buffer *buffer, vulkanAPI::Memory *memory)
+{
+}
+
+// Code here will be called immediately after the constructor (right
+// before each test).
+void StagingRingTest::SetUp(void) {
+    Ring = new vulkanAPI::StagingRing(nullptr, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, &Allocator);
+    ASSERT_TRUE(Ring->Create(RING_SIZE));
+}
+
+// Code here will be called immediately after each test (right
+// before the destructor).
+void StagingRingTest::TearDown() {
+    delete Ring;
+}
+
+TEST_F(StagingRingTest, AllocationsAreAligned)
+{
+    VkDeviceSize offset;
+    ASSERT_TRUE(Ring->Allocate(3, 4, 1, &offset));
+    ASSERT_EQ(0u, offset);
+    ASSERT_TRUE(Ring->Allocate(8, 256, 1, &offset));
+    ASSERT_EQ(256u, offset);
+    ASSERT_TRUE(Ring->Allocate(1, 4, 1, &offset));
+    ASSERT_EQ(264u, offset);
+}
+
+TEST_F(StagingRingTest, FillToCapacity)
+{
+    VkDeviceSize offset;
+
+    // the first allocation may take the whole ring, as it cannot overlap another one
+    ASSERT_TRUE(Ring->Allocate(RING_SIZE, 4, 1, &offset));
+    ASSERT_EQ(0u, offset);
+    ASSERT_FALSE(Ring->Allocate(4, 4, 2, &offset));
+    Ring->Reclaim(1);
+    ASSERT_EQ(0u, Ring->GetAllocationCount());
+
+    // fill the ring in pieces up to its end
+    for(VkDeviceSize i = 0; i < 4; ++i) {
+        ASSERT_TRUE(Ring->Allocate(RING_SIZE / 4, 4, 10 + i, &offset));
+        ASSERT_EQ(i * RING_SIZE / 4, offset);
+    }
+    ASSERT_FALSE(Ring->Allocate(4, 4, 20, &offset));
+
+    // free the first quarter; reusing all of it would end at the tail
+    // and make the full ring look empty, so only less fits
+    Ring->Reclaim(10);
+    ASSERT_FALSE(Ring->Allocate(RING_SIZE / 4, 4, 20, &offset));
+    ASSERT_TRUE(Ring->Allocate(RING_SIZE / 4 - 4, 4, 20, &offset));
+    ASSERT_EQ(0u, offset);
+    ASSERT_FALSE(Ring->Allocate(4, 4, 20, &offset));
+
+    // the live allocations must still be tracked, not treated as free space
+    ASSERT_EQ(4u, Ring->GetAllocationCount());
+    Ring->Reclaim(12);
+    ASSERT_EQ(2u, Ring->GetAllocationCount());
+    // the free space is [head, tail) and again may not be used up to the tail
+    const VkDeviceSize head = RING_SIZE / 4 - 4;
+    const VkDeviceSize tail = 3 * RING_SIZE / 4;
+    ASSERT_FALSE(Ring->Allocate(tail - head, 4, 21, &offset));
+    ASSERT_TRUE(Ring->Allocate(tail - head - 4, 4, 21, &offset));
+    ASSERT_EQ(head, offset);
+    ASSERT_FALSE(Ring->Allocate(4, 4, 21, &offset));
+
+    Ring->Reclaim(21);
+    ASSERT_EQ(0u, Ring->GetAllocationCount());
+}
+
+TEST_F(StagingRingTest, TailAtTheEndOfTheRing)
+{
+    VkDeviceSize offset;
+    ASSERT_TRUE(Ring->Allocate(RING_SIZE / 2, 4, 1, &offset));
+    ASSERT_TRUE(Ring->Allocate(RING_SIZE / 2, 4, 2, &offset));
+    ASSERT_FALSE(Ring->Allocate(RING_SIZE / 4, 4, 3, &offset));
+
+    // reclaiming up to the end of the ring leaves [0, head) as the used space
+    Ring->Reclaim(1);
+    ASSERT_TRUE(Ring->Allocate(RING_SIZE / 4, 4, 3, &offset));
+    ASSERT_EQ(0u, offset);
+    Ring->Reclaim(2);
+    ASSERT_TRUE(Ring->Allocate(RING_SIZE - RING_SIZE / 4, 4, 4, &offset));
+    ASSERT_EQ(RING_SIZE / 4, offset);
+    ASSERT_FALSE(Ring->Allocate(4, 4, 5, &offset));
+}
+
+} //end of namespace
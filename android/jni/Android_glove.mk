@@ -36,6 +36,7 @@ include $(CLEAR_VARS)
 LOCAL_MODULE := libGLESv2_GLOVE
 LOCAL_SRC_FILES :=  $(SRC_PATH)/GLES/source/api/gl.cpp \
                     $(SRC_PATH)/GLES/source/api/eglInterface.cpp \
+                    $(SRC_PATH)/GLES/source/api/dispatchQueue.cpp \
                     $(SRC_PATH)/GLES/source/context/context.cpp \
                     $(SRC_PATH)/GLES/source/context/contextBufferObject.cpp \
                     $(SRC_PATH)/GLES/source/context/contextFrameBuffer.cpp \
@@ -86,18 +87,24 @@ LOCAL_SRC_FILES :=  $(SRC_PATH)/GLES/source/api/gl.cpp \
                     $(SRC_PATH)/GLES/source/utils/VkToGlConverter.cpp \
                     $(SRC_PATH)/GLES/source/utils/glLogger.cpp \
                     $(SRC_PATH)/GLES/source/utils/glUtils.cpp \
+                    $(SRC_PATH)/GLES/source/utils/pixelKernels.cpp \
                     $(SRC_PATH)/GLES/source/utils/cacheManager.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/cbManager.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/clearPass.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/commandBufferPool.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/resourceTable.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/renderPass.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/buffer.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/memory.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/deviceAllocator.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/stagingRing.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/sampler.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/image.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/imageView.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/pipeline.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/pipelineCache.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/pipelineBarrier.cpp \
+                    $(SRC_PATH)/GLES/source/vulkan/bindState.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/framebuffer.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/context.cpp \
                     $(SRC_PATH)/GLES/source/vulkan/utils.cpp \
@@ -144,6 +151,7 @@ LOCAL_SRC_FILES := $(SRC_PATH)/EGL/source/api/eglContext.cpp \
                    $(SRC_PATH)/EGL/source/api/eglConfig.cpp \
                    $(SRC_PATH)/EGL/source/api/egl.cpp \
                    $(SRC_PATH)/EGL/source/api/eglSurface.cpp \
+                   $(SRC_PATH)/EGL/source/api/eglSync.cpp \
                    $(SRC_PATH)/EGL/source/api/eglDisplay.cpp \
                    $(SRC_PATH)/EGL/source/display/displayDriver.cpp \
                    $(SRC_PATH)/EGL/source/display/displayDriversContainer.cpp \